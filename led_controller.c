@@ -2,16 +2,20 @@
 #include "tal_log.h"
 #include "tal_sw_timer.h"
 #include "tal_mutex.h"
+#include "tal_semaphore.h"
+#include "tal_system.h"
+#include "tal_thread.h"
 #include "tal_gpio.h"
+#include "tdd_pixel_basic.h"
+#include "tdd_pixel_trace.h"
+#if (LED_PIXEL_BACKEND == LED_PIXEL_BACKEND_APA102)
+#include "tdd_pixel_apa102.h"
+#else
 #include "tdd_pixel_ws2812.h"
+#endif
 #include "tdl_pixel_driver.h"
 #include <string.h>
 
-// TDD WS2812驱动函数声明
-OPERATE_RET tdd_2812_driver_open(OUT DRIVER_HANDLE_T *handle, IN unsigned short pixel_num);
-OPERATE_RET tdd_ws2812_driver_close(IN DRIVER_HANDLE_T *handle);
-OPERATE_RET tdd_ws2812_driver_send_data(IN DRIVER_HANDLE_T handle, IN unsigned short *data_buf, IN unsigned int buf_len);
-
 // 颜色分量结构（RGB格式）
 typedef struct {
     uint8_t r;  // 红色分量
@@ -19,6 +23,13 @@ typedef struct {
     uint8_t b;  // 蓝色分量
 } RGBColor;
 
+// 高精度颜色（8.8定点），最大为255 << LED_INTENSITY_SHIFT
+typedef struct {
+    uint16_t r;
+    uint16_t g;
+    uint16_t b;
+} RGBColor16;
+
 // 预定义颜色（RGB格式）
 static const RGBColor COLOR_BLACK   = {0, 0, 0};     // 黑色（LED关闭）
 static const RGBColor COLOR_RED     = {255, 0, 0};   // 红色
@@ -26,7 +37,35 @@ static const RGBColor COLOR_GREEN   = {0, 255, 0};   // 绿色
 static const RGBColor COLOR_BLUE    = {0, 0, 255};   // 蓝色
 static const RGBColor COLOR_YELLOW  = {255, 255, 0}; // 黄色
 
-// 呼吸灯亮度表（非线性变化，符合人眼感知）
+#if (LED_DITHER_ENABLE == 1)
+// 呼吸灯亮度表（非线性变化，符合人眼感知），8.8定点：高8位为输出亮度，低8位为时间抖动的小数部分
+// 按 255 * ((i + 4.3) / 104.2) ^ 3.5 拟合原8位表，下降沿与上升沿对称，小于0.25的亮度取0避免稀疏闪点
+static const uint16_t BREATH_BRIGHTNESS_TABLE[BREATH_TABLE_SIZE] = {
+    0,     0,     0,     0,     0,     0,     0,     0,     0,     0,     0,     79,
+    99,    122,   148,   179,   213,   252,   296,   345,   400,   460,   527,   601,
+    682,   770,   866,   970,   1083,  1204,  1336,  1477,  1629,  1792,  1965,  2151,
+    2349,  2559,  2782,  3020,  3271,  3537,  3817,  4114,  4426,  4756,  5102,  5466,
+    5848,  6249,  6669,  7109,  7569,  8050,  8552,  9077,  9624,  10194, 10788, 11407,
+    12050, 12719, 13413, 14135, 14884, 15661, 16466, 17300, 18165, 19059, 19985, 20942,
+    21932, 22955, 24011, 25101, 26227, 27388, 28585, 29820, 31091, 32401, 33751, 35139,
+    36568, 38038, 39550, 41105, 42702, 44343, 46029, 47760, 49538, 51362, 53233, 55153,
+    57121, 59139, 61208, 63328, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280,
+    65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280,
+    65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280,
+    65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280,
+    65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280, 65280,
+    63328, 61208, 59139, 57121, 55153, 53233, 51362, 49538, 47760, 46029, 44343, 42702,
+    41105, 39550, 38038, 36568, 35139, 33751, 32401, 31091, 29820, 28585, 27388, 26227,
+    25101, 24011, 22955, 21932, 20942, 19985, 19059, 18165, 17300, 16466, 15661, 14884,
+    14135, 13413, 12719, 12050, 11407, 10788, 10194, 9624,  9077,  8552,  8050,  7569,
+    7109,  6669,  6249,  5848,  5466,  5102,  4756,  4426,  4114,  3817,  3537,  3271,
+    3020,  2782,  2559,  2349,  2151,  1965,  1792,  1629,  1477,  1336,  1204,  1083,
+    970,   866,   770,   682,   601,   527,   460,   400,   345,   296,   252,   213,
+    179,   148,   122,   99,    79,    0,     0,     0,     0,     0,     0,     0,
+    0,     0,     0,     0
+};
+#else
+// 呼吸灯亮度表（非线性变化，符合人眼感知），不开启时间抖动时使用原8位表，量化后亮度与整数表一致
 static const uint8_t BREATH_BRIGHTNESS_TABLE[BREATH_TABLE_SIZE] = {
     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,
     1,   1,   2,   2,   2,   2,   2,   3,   3,   3,   4,   4,   5,   5,   6,   6,
@@ -45,13 +84,47 @@ static const uint8_t BREATH_BRIGHTNESS_TABLE[BREATH_TABLE_SIZE] = {
     6,   6,   5,   5,   4,   4,   3,   3,   3,   2,   2,   2,   2,   2,   1,   1,
     1,   1,   1,   1,   1,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0
 };
+#endif
 
-// LED控制状态机结构
+// 图层：高层按不透明度叠加在低层之上
+typedef enum {
+    LED_LAYER_BACKGROUND,   // 背景：自检、空闲、配网中、呼吸灯
+    LED_LAYER_INDICATOR,    // 指示：网络异常、对话中
+    LED_LAYER_OVERLAY,      // 浮层：配网成功、音量
+    LED_LAYER_NUM
+} LedLayerId;
+
+// 各状态所在图层，按LedState顺序
+static const uint8_t LED_STATE_LAYER[] = {
+    LED_LAYER_BACKGROUND,   // LED_INIT
+    LED_LAYER_BACKGROUND,   // LED_IDLE
+    LED_LAYER_BACKGROUND,   // LED_CONFIGURING
+    LED_LAYER_OVERLAY,      // LED_CONFIG_SUCCESS
+    LED_LAYER_INDICATOR,    // LED_NET_ERROR
+    LED_LAYER_INDICATOR,    // LED_DIALOG
+    LED_LAYER_OVERLAY,      // LED_VOLUME
+    LED_LAYER_BACKGROUND,   // LED_BREATHING
+    LED_LAYER_OVERLAY,      // LED_CLIP
+};
+
+// 图层结构
 typedef struct {
-    LedState current_state;      // 当前状态
-    LedState pending_state;      // 等待状态（在自检过程中接收的新状态）
-    uint8_t pending_value;       // 等待状态参数
-    BOOL_T has_pending_state;    // 是否有等待状态
+    LedState state;              // 图层当前状态
+    BOOL_T active;               // 图层是否参与合成（含淡出过程）
+    
+    // 图层内容：前level个LED为color，其余透明（背景层为黑色）
+    RGBColor16 color;
+    uint8_t level;
+    
+    // 不透明度与淡入淡出
+    uint16_t alpha;              // 当前不透明度 (0-LED_ALPHA_MAX)
+    uint16_t fade_from;          // 淡入淡出起始不透明度
+    int8_t fade_dir;             // 1-淡入，-1-淡出，0-稳定
+    SYS_TIME_T fade_start;       // 淡入淡出开始时间
+    
+    // 状态事件（绝对时间）
+    SYS_TIME_T event_deadline;   // 下一个状态事件的截止时间
+    BOOL_T event_armed;          // 是否有待处理的状态事件
     
     // 状态专用数据
     union {
@@ -66,32 +139,167 @@ typedef struct {
             uint16_t blink_count; // 已闪烁次数
         } blink;
     } state_data;
+} LedLayer;
+
+// 状态命令
+typedef struct {
+    LedState state;              // 目标状态
+    uint8_t value;               // 状态参数
+    SYS_TIME_T enqueue_ms;       // 入队时间，用于统计到首帧显示的延迟
+} LedStateCmd;
+
+// 命令队列槽位：seq == 位置表示可写，seq == 位置 + 1表示已写入可读
+typedef struct {
+    uint32_t seq;
+    LedStateCmd cmd;
+} LedCmdSlot;
+
+// LED控制状态机结构
+typedef struct {
+    // 状态命令队列：多生产者（任意线程/中断）无锁入队，渲染线程单消费者出队
+    LedCmdSlot cmd_ring[LED_CMD_QUEUE_SIZE];
+    uint32_t cmd_enq_pos;        // 生产者位置，原子操作
+    uint32_t cmd_deq_pos;        // 消费者位置，只由渲染线程访问
+    uint32_t cmd_dropped;        // 队列满时丢弃的命令数，原子操作
+    BOOL_T cmd_visible_pending;  // 有已执行但尚未刷新输出的命令
+    SYS_TIME_T cmd_visible_since; // 其中最早一条命令的入队时间
+    uint32_t frames_submitted;   // 提交驱动成功的帧数，只由渲染线程访问
+    uint32_t frames_done;        // 驱动回调通知发送结束的帧数，原子操作
+    uint32_t cmd_shown_frame;    // 携带待显示命令的帧序号（frames_submitted计数），0为无，原子操作
+    SYS_TIME_T cmd_shown_since;  // 其入队时间，cmd_shown_frame发布前写入
+    uint32_t cmd_latency_last_ms; // 命令到首帧发送完成的延迟，由驱动回调更新，原子操作
+    uint32_t cmd_latency_max_ms;
+    LedStateCmd cmd_merge[LED_LAYER_NUM]; // 各图层合并后待执行的命令
+    uint32_t cmd_merge_order[LED_LAYER_NUM]; // 待执行命令的提交顺序（队列位置）
+    BOOL_T cmd_merge_valid[LED_LAYER_NUM];
+    
+    LedState pending_state;      // 等待状态（在自检过程中接收的新状态）
+    uint8_t pending_value;       // 等待状态参数
+    BOOL_T has_pending_state;    // 是否有等待状态
     
-    // 定时器
-    TIMER_ID main_timer;   // 主定时器：处理所有状态转换和动作
+    LedLayer layers[LED_LAYER_NUM]; // 图层，按优先级从低到高
+    BOOL_T frame_dirty;          // 图层内容已更新，待下一帧合成刷新
+    
+    // 时间抖动
+    uint8_t dither_residual[WS2812_LED_COUNT][3]; // 背景层各LED各通道量化余数（R/G/B），逐帧累积
+    BOOL_T dither_active;        // 背景层颜色有小数部分，每帧都需要刷新
+    
+    // 动画片段
+    PIXEL_CLIP_HANDLE_T clip;    // 正在播放的片段，只由渲染线程访问
+    PIXEL_CLIP_HANDLE_T clip_next; // 待播放的片段，原子交换
+    PIXEL_FRAME_T clip_frame;    // 片段当前帧
+    
+    // 渲染线程
+    THREAD_HANDLE render_thread;  // 渲染线程：按固定帧率驱动所有状态事件与刷新
+    SEM_HANDLE wake_sem;          // 状态变化时唤醒渲染线程立即出帧
+    SEM_HANDLE exit_sem;          // 渲染线程退出通知
+    volatile BOOL_T render_exit;  // 渲染线程退出标志
+    LedRenderStats stats;         // 渲染统计
+    LedPerfStats perf;            // 性能统计（驱动部分在读取时获取）
     
     // 互斥锁
-    MUTEX_HANDLE mutex;     // 状态保护互斥锁
+    MUTEX_HANDLE mutex;     // 状态保护互斥锁（渲染线程与统计读取之间）
 } LedController;
 
 static LedController led_ctrl;
 
+
 // TDD WS2812驱动相关变量
 static DRIVER_HANDLE_T tdd_pixel_handle = NULL;
-static unsigned short pixel_buffer[WS2812_LED_COUNT * 3]; // RGB数据缓冲区
+static unsigned char pixel_buffer[WS2812_LED_COUNT * 3]; // RGB888数据缓冲区，按R、G、B存放
+#if (LED_PIXEL_CHANNELS == 4)
+static unsigned char pixel_buffer_rgbw[WS2812_LED_COUNT * 4]; // 发送前由pixel_buffer提取白色分量
+static const PIXEL_FRAME_T pixel_frame = {
+    .fmt = PIXEL_FRAME_FMT_RGBW8888,
+    .pixel_num = WS2812_LED_COUNT,
+    .data = pixel_buffer_rgbw
+};
+#else
+static const PIXEL_FRAME_T pixel_frame = {
+    .fmt = PIXEL_FRAME_FMT_RGB888,
+    .pixel_num = WS2812_LED_COUNT,
+    .data = pixel_buffer
+};
+#endif
 static BOOL_T tdd_driver_initialized = FALSE;
 
 // TDD驱动接口函数定义
-static PIXEL_DRIVER_INTFS_T tdd_ws2812_intfs = {
+#if (LED_PIXEL_BACKEND == LED_PIXEL_BACKEND_APA102)
+#if (LED_PIXEL_CHANNELS != 3)
+#error "APA102 backend supports RGB pixels only"
+#endif
+static PIXEL_DRIVER_INTFS_T tdd_pixel_intfs = {
+    .open = tdd_apa102_driver_open,
+    .close = tdd_apa102_driver_close,
+    .output = tdd_apa102_driver_send_data,
+    .config = tdd_apa102_driver_config,
+    .output_frame = tdd_apa102_driver_send_frame
+};
+#define tdd_pixel_driver_register tdd_apa102_driver_register
+#else
+static PIXEL_DRIVER_INTFS_T tdd_pixel_intfs = {
     .open = tdd_2812_driver_open,
     .close = tdd_ws2812_driver_close,
     .output = tdd_ws2812_driver_send_data,
-    .config = NULL
+    .config = tdd_ws2812_driver_config,
+    .output_frame = tdd_ws2812_driver_send_frame
 };
+#define tdd_pixel_driver_register tdd_ws2812_driver_register
+#endif
+
+// 记录命令延迟的最大值，驱动回调中调用，不持有状态锁
+static void led_latency_max_update(uint32_t *max_ms, uint32_t latency) {
+    uint32_t max = __atomic_load_n(max_ms, __ATOMIC_RELAXED);
+    
+    while (latency > max &&
+           !__atomic_compare_exchange_n(max_ms, &max, latency, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// 帧发送结束回调：异步模式在驱动发送线程中、同步模式在渲染线程（已持有状态锁）中调用，
+// 每次output_frame成功后按提交顺序回调一次，返回错误时不回调（与frames_submitted一一对应）；
+// 码流末尾的复位零字节已发出，此时灯珠已锁存新的颜色
+static void led_frame_done_cb(DRIVER_HANDLE_T handle, int result, void *arg) {
+    uint32_t done = __atomic_add_fetch(&led_ctrl.frames_done, 1, __ATOMIC_ACQ_REL);
+    uint32_t latency = 0;
+    
+    (void)handle;
+    (void)arg;
+    
+    if (__atomic_load_n(&led_ctrl.cmd_shown_frame, __ATOMIC_ACQUIRE) != done) {
+        return;
+    }
+    if (OPRT_OK == result) {
+        latency = (uint32_t)(tal_system_get_millisecond() - led_ctrl.cmd_shown_since);
+        __atomic_store_n(&led_ctrl.cmd_latency_last_ms, latency, __ATOMIC_RELAXED);
+        led_latency_max_update(&led_ctrl.cmd_latency_max_ms, latency);
+    }
+    __atomic_store_n(&led_ctrl.cmd_shown_frame, 0, __ATOMIC_RELEASE);
+}
 
 // TDD驱动初始化函数
 static OPERATE_RET tdd_pixel_init(void) {
     OPERATE_RET ret;
+    PIXEL_FRAME_DONE_CFG_T done_cfg = {
+        .cb = led_frame_done_cb,
+        .arg = NULL
+    };
+    PIXEL_COLOR_CORRECTION_T color_cfg = {
+        .gamma_x10 = LED_GAMMA_X10,
+        .brightness = LED_BRIGHTNESS,
+        .r_gain = LED_GAIN_R,
+        .g_gain = LED_GAIN_G,
+        .b_gain = LED_GAIN_B
+    };
+#if (LED_PIXEL_BACKEND == LED_PIXEL_BACKEND_WS2812) && (LED_SPI_STREAM_CHUNK == 0) && (LED_SPI_ASYNC_ENABLE == 1)
+    BOOL_T async = TRUE;
+#endif
+#if (LED_PIXEL_BACKEND == LED_PIXEL_BACKEND_WS2812) && (LED_SPI_STREAM_CHUNK == 0) && (LED_FRAME_CACHE_SIZE > 0)
+    unsigned int cache_size = LED_FRAME_CACHE_SIZE;
+#endif
+#if (LED_PIXEL_BACKEND == LED_PIXEL_BACKEND_WS2812) && (LED_SPI_STREAM_CHUNK == 0) && (LED_UNIFORM_REPEAT_BLOCK > 0)
+    unsigned short repeat_block = LED_UNIFORM_REPEAT_BLOCK;
+#endif
     
     if (tdd_driver_initialized) {
         return OPRT_OK;
@@ -100,22 +308,62 @@ static OPERATE_RET tdd_pixel_init(void) {
     // 注册WS2812驱动
     PIXEL_DRIVER_CONFIG_T driver_config = {
         .port = TUYA_SPI_NUM_0,
-        .line_seq = GRB_ORDER  // WS2812使用GRB顺序
+        .line_seq = LED_PIXEL_LINE_SEQ,
+        .code_mode = LED_SPI_CODE_MODE,
+        .chip = LED_PIXEL_CHIP,
+        .chan_num = LED_PIXEL_CHANNELS,
+        .stream_px = LED_SPI_STREAM_CHUNK
     };
     
-    ret = tdd_ws2812_driver_register(&driver_config);
+    ret = tdd_pixel_driver_register(&driver_config);
     if (ret != OPRT_OK) {
         TAL_PR_ERR("Failed to register TDD WS2812 driver: %d", ret);
         return ret;
     }
     
     // 打开设备
-    ret = tdd_ws2812_intfs.open(&tdd_pixel_handle, WS2812_LED_COUNT);
+    ret = tdd_pixel_intfs.open(&tdd_pixel_handle, WS2812_LED_COUNT);
     if (ret != OPRT_OK) {
         TAL_PR_ERR("Failed to open TDD WS2812 device: %d", ret);
         return ret;
     }
     
+#if (LED_PIXEL_BACKEND == LED_PIXEL_BACKEND_WS2812) && (LED_SPI_STREAM_CHUNK == 0) && (LED_SPI_ASYNC_ENABLE == 1)
+    // 开启异步发送，定时器回调中不再等待SPI传输
+    ret = tdd_pixel_intfs.config(tdd_pixel_handle, DRV_CMD_SET_ASYNC_MODE, &async);
+    if (ret != OPRT_OK) {
+        TAL_PR_WARN("TDD WS2812 async mode unavailable, fallback to sync: %d", ret);
+    }
+#endif
+
+    // 发送完成回调，统计命令到灯珠实际显示的延迟
+    ret = tdd_pixel_intfs.config(tdd_pixel_handle, DRV_CMD_SET_FRAME_DONE_CB, &done_cfg);
+    if (ret != OPRT_OK) {
+        TAL_PR_WARN("TDD WS2812 frame done callback unavailable: %d", ret);
+    }
+
+    // 颜色校正（伽马、全局亮度、白平衡）
+    ret = tdd_pixel_intfs.config(tdd_pixel_handle, DRV_CMD_SET_COLOR_CORRECTION, &color_cfg);
+    if (ret != OPRT_OK) {
+        TAL_PR_WARN("TDD WS2812 color correction unavailable: %d", ret);
+    }
+
+#if (LED_PIXEL_BACKEND == LED_PIXEL_BACKEND_WS2812) && (LED_SPI_STREAM_CHUNK == 0) && (LED_FRAME_CACHE_SIZE > 0)
+    // 编码帧缓存
+    ret = tdd_pixel_intfs.config(tdd_pixel_handle, DRV_CMD_SET_FRAME_CACHE, &cache_size);
+    if (ret != OPRT_OK) {
+        TAL_PR_WARN("TDD WS2812 frame cache unavailable: %d", ret);
+    }
+#endif
+
+#if (LED_PIXEL_BACKEND == LED_PIXEL_BACKEND_WS2812) && (LED_SPI_STREAM_CHUNK == 0) && (LED_UNIFORM_REPEAT_BLOCK > 0)
+    // 纯色帧重复块
+    ret = tdd_pixel_intfs.config(tdd_pixel_handle, DRV_CMD_SET_UNIFORM_REPEAT, &repeat_block);
+    if (ret != OPRT_OK) {
+        TAL_PR_WARN("TDD WS2812 uniform repeat unavailable: %d", ret);
+    }
+#endif
+
     // 清空缓冲区
     memset(pixel_buffer, 0, sizeof(pixel_buffer));
     
@@ -131,10 +379,10 @@ static OPERATE_RET tdd_pixel_set_pixel(uint16_t index, uint8_t red, uint8_t gree
         return OPRT_INVALID_PARM;
     }
     
-    // TDD驱动使用GRB顺序
-    pixel_buffer[index * 3 + 0] = green;  // G
-    pixel_buffer[index * 3 + 1] = red;    // R
-    pixel_buffer[index * 3 + 2] = blue;   // B
+    // 缓冲区按R、G、B存放，驱动按注册的线序（LED_PIXEL_LINE_SEQ）输出
+    pixel_buffer[index * 3 + 0] = red;
+    pixel_buffer[index * 3 + 1] = green;
+    pixel_buffer[index * 3 + 2] = blue;
     
     return OPRT_OK;
 }
@@ -154,11 +402,38 @@ static OPERATE_RET tdd_pixel_set_all(uint8_t red, uint8_t green, uint8_t blue) {
 
 // 刷新LED显示
 static OPERATE_RET tdd_pixel_refresh(void) {
+#if (LED_PIXEL_CHANNELS == 4)
+    const unsigned char *src = NULL;
+    unsigned char *dst = NULL;
+    unsigned char w = 0;
+    int i = 0;
+#endif
+    
     if (!tdd_driver_initialized || tdd_pixel_handle == NULL) {
         return OPRT_RESOURCE_NOT_READY;
     }
     
-    return tdd_ws2812_intfs.output(tdd_pixel_handle, pixel_buffer, WS2812_LED_COUNT * 3);
+#if (LED_PIXEL_CHANNELS == 4)
+    // R、G、B的公共部分改由W通道发出：W = min(R, G, B)
+    for (i = 0; i < WS2812_LED_COUNT; i++) {
+        src = &pixel_buffer[i * 3];
+        dst = &pixel_buffer_rgbw[i * 4];
+        w = src[0];
+        
+        if (src[1] < w) {
+            w = src[1];
+        }
+        if (src[2] < w) {
+            w = src[2];
+        }
+        dst[0] = src[0] - w;
+        dst[1] = src[1] - w;
+        dst[2] = src[2] - w;
+        dst[3] = w;
+    }
+#endif
+    
+    return tdd_pixel_intfs.output_frame(tdd_pixel_handle, &pixel_frame);
 }
 
 // TDD驱动去初始化函数
@@ -168,7 +443,7 @@ static OPERATE_RET tdd_pixel_deinit(void) {
     }
     
     if (tdd_pixel_handle != NULL) {
-        tdd_ws2812_intfs.close(&tdd_pixel_handle);
+        tdd_pixel_intfs.close(&tdd_pixel_handle);
         tdd_pixel_handle = NULL;
     }
     
@@ -178,98 +453,263 @@ static OPERATE_RET tdd_pixel_deinit(void) {
     return OPRT_OK;
 }
 
-// 设置所有LED为同一颜色
-static void set_all_leds(const RGBColor *color) {
-    tdd_pixel_set_all(color->r, color->g, color->b);
-    tdd_pixel_refresh();
+// 混合单个LED：out = bg + (fg - bg) * alpha / LED_ALPHA_MAX
+static void tdd_pixel_blend_pixel(uint16_t index, const RGBColor *color, uint16_t alpha) {
+    unsigned char *px = &pixel_buffer[index * 3];
+    
+    px[0] = (unsigned char)(px[0] + ((((int)color->r - (int)px[0]) * alpha) >> LED_ALPHA_SHIFT));
+    px[1] = (unsigned char)(px[1] + ((((int)color->g - (int)px[1]) * alpha) >> LED_ALPHA_SHIFT));
+    px[2] = (unsigned char)(px[2] + ((((int)color->b - (int)px[2]) * alpha) >> LED_ALPHA_SHIFT));
 }
 
-// 设置等级显示（用于信号强度和音量）
-static void set_level_leds(const RGBColor *color, uint8_t level) {
+// 设置图层内容：前level个LED为指定的高精度颜色（在下一帧合成）
+static void layer_fill16(LedLayer *layer, const RGBColor16 *color, uint8_t level) {
     // 确保不超过LED数量
     if (level > WS2812_LED_COUNT) {
         level = WS2812_LED_COUNT;
     }
     
-    for (int i = 0; i < WS2812_LED_COUNT; i++) {
-        if (i < level) {
-            tdd_pixel_set_pixel(i, color->r, color->g, color->b);
-        } else {
-            tdd_pixel_set_pixel(i, COLOR_BLACK.r, COLOR_BLACK.g, COLOR_BLACK.b);
+    layer->color.r = (color->r > LED_INTENSITY_MAX) ? LED_INTENSITY_MAX : color->r;
+    layer->color.g = (color->g > LED_INTENSITY_MAX) ? LED_INTENSITY_MAX : color->g;
+    layer->color.b = (color->b > LED_INTENSITY_MAX) ? LED_INTENSITY_MAX : color->b;
+    layer->level = level;
+    led_ctrl.frame_dirty = TRUE;
+}
+
+// 设置图层内容：前level个LED为指定颜色（在下一帧合成）
+static void layer_fill(LedLayer *layer, const RGBColor *color, uint8_t level) {
+    RGBColor16 color16 = {
+        (uint16_t)(color->r << LED_INTENSITY_SHIFT),
+        (uint16_t)(color->g << LED_INTENSITY_SHIFT),
+        (uint16_t)(color->b << LED_INTENSITY_SHIFT)
+    };
+    
+    layer_fill16(layer, &color16, level);
+}
+
+// 高精度颜色量化为8位：residual非空时小数部分累积到该LED的余数逐帧进位，多帧平均亮度等于高精度值；
+// 为空时四舍五入
+static void quantize_color(const RGBColor16 *in, RGBColor *out, uint8_t *residual) {
+    uint16_t acc[3] = {in->r, in->g, in->b};
+    uint8_t val[3];
+    uint8_t c = 0;
+    
+    for (c = 0; c < 3; c++) {
+        if (residual) {
+            acc[c] += residual[c];
+            residual[c] = (uint8_t)(acc[c] & LED_INTENSITY_FRAC_MASK);
+            val[c] = (uint8_t)(acc[c] >> LED_INTENSITY_SHIFT);
+            continue;
+        }
+        acc[c] += (acc[c] & LED_INTENSITY_FRAC_MASK) ? (1 << (LED_INTENSITY_SHIFT - 1)) : 0;
+        val[c] = (uint8_t)(acc[c] >> LED_INTENSITY_SHIFT);
+    }
+    
+    out->r = val[0];
+    out->g = val[1];
+    out->b = val[2];
+}
+
+// 各LED的抖动余数从错开的相位开始，同一帧中进位的LED分散在灯带上
+static void dither_init(void) {
+    uint8_t i = 0, c = 0;
+    
+    for (i = 0; i < WS2812_LED_COUNT; i++) {
+        for (c = 0; c < 3; c++) {
+            led_ctrl.dither_residual[i][c] = (uint8_t)((i * LED_DITHER_PHASE_STEP) & LED_INTENSITY_FRAC_MASK);
         }
     }
-    tdd_pixel_refresh();
 }
 
-// 主定时器回调：处理所有状态事件
-static void main_timer_cb(TIMER_ID timer_id, VOID_T *arg) {
-    tal_mutex_lock(led_ctrl.mutex);
+// 开始淡入/淡出，从当前不透明度开始，中途反向不会跳变
+static void layer_fade(LedLayer *layer, int8_t dir, SYS_TIME_T now) {
+    layer->fade_from = layer->alpha;
+    layer->fade_dir = dir;
+    layer->fade_start = now;
+    led_ctrl.frame_dirty = TRUE;
+}
+
+// 更新淡入淡出进度，淡出结束后图层失效
+static void layer_update_fade(LedLayer *layer, SYS_TIME_T now) {
+    uint32_t step = (uint32_t)(now - layer->fade_start) * LED_ALPHA_MAX / LED_LAYER_FADE_MS;
+    
+    if (layer->fade_dir > 0) {
+        layer->alpha = (layer->fade_from + step >= LED_ALPHA_MAX) ? LED_ALPHA_MAX : (uint16_t)(layer->fade_from + step);
+        if (LED_ALPHA_MAX == layer->alpha) {
+            layer->fade_dir = 0;
+        }
+    } else if (layer->fade_dir < 0) {
+        layer->alpha = (step >= layer->fade_from) ? 0 : (uint16_t)(layer->fade_from - step);
+        if (0 == layer->alpha) {
+            layer->fade_dir = 0;
+            layer->active = FALSE;
+        }
+    }
+    led_ctrl.frame_dirty = TRUE;
+}
+
+// 移除图层：背景层以外的图层淡出
+static void layer_remove(LedLayer *layer, SYS_TIME_T now) {
+    layer->event_armed = FALSE;
+    if (layer->active && layer->fade_dir >= 0) {
+        layer_fade(layer, -1, now);
+    }
+}
+
+// 合成一帧：背景层直接填充，其余图层只在覆盖的LED上做一次混合
+static void compose_frame(void) {
+    LedLayer *layer = &led_ctrl.layers[LED_LAYER_BACKGROUND];
+    RGBColor color;
+    uint8_t i = 0, j = 0;
     
-    switch (led_ctrl.current_state) {
+    quantize_color(&layer->color, &color, NULL);
+#if (LED_DITHER_ENABLE == 1)
+    // 背景层（呼吸等均匀效果）经时间抖动量化，低亮度渐变不再按整级跳变；
+    // 各LED余数相位不同，同一帧中只有部分LED进位
+    led_ctrl.dither_active = ((layer->color.r | layer->color.g | layer->color.b) & LED_INTENSITY_FRAC_MASK) ?
+                             TRUE : FALSE;
+    if (led_ctrl.dither_active) {
+        for (i = 0; i < WS2812_LED_COUNT; i++) {
+            if (i < layer->level) {
+                quantize_color(&layer->color, &color, led_ctrl.dither_residual[i]);
+                tdd_pixel_set_pixel(i, color.r, color.g, color.b);
+            } else {
+                tdd_pixel_set_pixel(i, COLOR_BLACK.r, COLOR_BLACK.g, COLOR_BLACK.b);
+            }
+        }
+    } else
+#endif
+    if (layer->level >= WS2812_LED_COUNT) {
+        tdd_pixel_set_all(color.r, color.g, color.b);
+    } else {
+        for (i = 0; i < WS2812_LED_COUNT; i++) {
+            if (i < layer->level) {
+                tdd_pixel_set_pixel(i, color.r, color.g, color.b);
+            } else {
+                tdd_pixel_set_pixel(i, COLOR_BLACK.r, COLOR_BLACK.g, COLOR_BLACK.b);
+            }
+        }
+    }
+    
+    for (j = LED_LAYER_BACKGROUND + 1; j < LED_LAYER_NUM; j++) {
+        layer = &led_ctrl.layers[j];
+        if (!layer->active || 0 == layer->alpha) {
+            continue;
+        }
+        if (LED_CLIP == layer->state) {
+            // 片段逐像素混合（片段未能解码出帧时不显示）
+            if (NULL == led_ctrl.clip_frame.data) {
+                continue;
+            }
+            for (i = 0; i < layer->level; i++) {
+                memcpy(&color, &led_ctrl.clip_frame.data[i * 3], sizeof(color));
+                tdd_pixel_blend_pixel(i, &color, layer->alpha);
+            }
+            continue;
+        }
+        quantize_color(&layer->color, &color, NULL);
+        for (i = 0; i < layer->level; i++) {
+            if (LED_ALPHA_MAX == layer->alpha) {
+                tdd_pixel_set_pixel(i, color.r, color.g, color.b);
+            } else {
+                tdd_pixel_blend_pixel(i, &color, layer->alpha);
+            }
+        }
+    }
+}
+
+// 安排图层的下一个状态事件：事件处理中以触发它的截止时间为基准，周期动作不随处理耗时漂移
+static void arm_state_event(LedLayer *layer, SYS_TIME_T base, uint32_t delay_ms) {
+    layer->event_deadline = base + delay_ms;
+    layer->event_armed = TRUE;
+}
+
+static void enter_led_state(LedState new_state, uint8_t value, SYS_TIME_T now);
+
+// 解码片段的下一帧并按帧时长安排下一个事件，片段结束或出错时浮层淡出
+static void clip_step(LedLayer *layer, SYS_TIME_T base) {
+    uint32_t duration = 0;
+    OPERATE_RET ret;
+    
+    ret = tdl_pixel_clip_next(led_ctrl.clip, &led_ctrl.clip_frame, &duration);
+    if (ret != OPRT_OK) {
+        if (ret != OPRT_NOT_FOUND) {
+            TAL_PR_ERR("LED clip decode failed: %d", ret);
+        }
+        if (NULL == led_ctrl.clip_frame.data) {
+            // 一帧都没有解码出来：直接移除，不显示
+            layer->active = FALSE;
+            layer->alpha = 0;
+            layer->fade_dir = 0;
+            return;
+        }
+        layer_remove(layer, base);
+        return;
+    }
+    
+    layer->level = (led_ctrl.clip_frame.pixel_num > WS2812_LED_COUNT) ? WS2812_LED_COUNT :
+                   (uint8_t)led_ctrl.clip_frame.pixel_num;
+    led_ctrl.frame_dirty = TRUE;
+    // 时长为0的帧至少显示一个渲染周期
+    arm_state_event(layer, base, duration ? duration : LED_RENDER_PERIOD_MS);
+}
+
+// 状态事件处理（渲染线程中调用，已持有锁），deadline为本事件的截止时间
+static void handle_state_event(LedLayer *layer, SYS_TIME_T deadline) {
+    switch (layer->state) {
         case LED_INIT:
             // 自检状态转换：红->绿->蓝
-            led_ctrl.state_data.init.step++;
+            layer->state_data.init.step++;
             
-            if (led_ctrl.state_data.init.step == 1) {
+            if (layer->state_data.init.step == 1) {
                 // 切换到绿色
-                set_all_leds(&COLOR_GREEN);
-                tal_sw_timer_start(led_ctrl.main_timer, INIT_GREEN_TIME, TAL_TIMER_ONCE);
-            } else if (led_ctrl.state_data.init.step == 2) {
+                layer_fill(layer, &COLOR_GREEN, WS2812_LED_COUNT);
+                arm_state_event(layer, deadline, INIT_GREEN_TIME);
+            } else if (layer->state_data.init.step == 2) {
                 // 切换到蓝色
-                set_all_leds(&COLOR_BLUE);
-                tal_sw_timer_start(led_ctrl.main_timer, INIT_BLUE_TIME, TAL_TIMER_ONCE);
+                layer_fill(layer, &COLOR_BLUE, WS2812_LED_COUNT);
+                arm_state_event(layer, deadline, INIT_BLUE_TIME);
             } else {
                 // 自检完成
                 TAL_PR_DEBUG("Init complete");
                 
                 // 进入空闲状态
-                led_ctrl.current_state = LED_IDLE;
+                layer->state = LED_IDLE;
+                layer_fill(layer, &COLOR_BLACK, WS2812_LED_COUNT);
                 
-                // 执行等待状态或进入空闲
+                // 执行等待状态
                 if (led_ctrl.has_pending_state) {
-                    // 保存等待状态值
-                    LedState next_state = led_ctrl.pending_state;
-                    uint8_t next_value = led_ctrl.pending_value;
-                    
-                    // 重置等待状态
+                    // 重置等待状态后在锁内直接执行，期间不会插入其他状态
                     led_ctrl.has_pending_state = FALSE;
-                    
-                    // 解锁后执行新状态
-                    tal_mutex_unlock(led_ctrl.mutex);
-                    set_led_state(next_state, next_value);
-                    return; // 直接返回，避免重复解锁
-                } else {
-                    set_all_leds(&COLOR_BLACK);
+                    enter_led_state(led_ctrl.pending_state, led_ctrl.pending_value, deadline);
                 }
             }
             break;
             
         case LED_CONFIG_SUCCESS:
         case LED_VOLUME:
-            // 显示状态超时，进入空闲
-            led_ctrl.current_state = LED_IDLE;
-            set_all_leds(&COLOR_BLACK);
+            // 显示状态超时，浮层淡出，露出下层效果
+            layer_remove(layer, deadline);
             break;
             
         case LED_DIALOG:
             // 对话状态：切换亮灭状态
-            if (led_ctrl.state_data.blink.is_light_on) {
+            if (layer->state_data.blink.is_light_on) {
                 // 当前亮 -> 切换为灭
-                set_all_leds(&COLOR_BLACK);
-                led_ctrl.state_data.blink.is_light_on = FALSE;
-                tal_sw_timer_start(led_ctrl.main_timer, DIALOG_LIGHT_OFF_TIME, TAL_TIMER_ONCE);
+                layer_fill(layer, &COLOR_BLACK, WS2812_LED_COUNT);
+                layer->state_data.blink.is_light_on = FALSE;
+                arm_state_event(layer, deadline, DIALOG_LIGHT_OFF_TIME);
             } else {
                 // 当前灭 -> 切换为亮
-                set_all_leds(&COLOR_BLUE);
-                led_ctrl.state_data.blink.is_light_on = TRUE;
-                led_ctrl.state_data.blink.blink_count++;
+                layer_fill(layer, &COLOR_BLUE, WS2812_LED_COUNT);
+                layer->state_data.blink.is_light_on = TRUE;
+                layer->state_data.blink.blink_count++;
                 
                 // 检查是否达到总闪烁次数
-                if (led_ctrl.state_data.blink.blink_count >= DIALOG_BLINK_COUNT) {
-                    led_ctrl.current_state = LED_IDLE;
-                    set_all_leds(&COLOR_BLACK);
+                if (layer->state_data.blink.blink_count >= DIALOG_BLINK_COUNT) {
+                    layer_remove(layer, deadline);
                 } else {
-                    tal_sw_timer_start(led_ctrl.main_timer, DIALOG_LIGHT_ON_TIME, TAL_TIMER_ONCE);
+                    arm_state_event(layer, deadline, DIALOG_LIGHT_ON_TIME);
                 }
             }
             break;
@@ -278,46 +718,424 @@ static void main_timer_cb(TIMER_ID timer_id, VOID_T *arg) {
         case LED_BREATHING:   // 呼吸灯效果（蓝灯呼吸）
         {
             // 更新呼吸灯索引
-            led_ctrl.state_data.breath.index++;
+            layer->state_data.breath.index++;
             
             // 处理索引循环
-            if (led_ctrl.state_data.breath.index >= BREATH_TABLE_SIZE) {
-                led_ctrl.state_data.breath.index = 0;
+            if (layer->state_data.breath.index >= BREATH_TABLE_SIZE) {
+                layer->state_data.breath.index = 0;
             }
             
             // 获取当前亮度值
-            uint8_t brightness = BREATH_BRIGHTNESS_TABLE[led_ctrl.state_data.breath.index];
+#if (LED_DITHER_ENABLE == 1)
+            uint16_t brightness = BREATH_BRIGHTNESS_TABLE[layer->state_data.breath.index];
+#else
+            uint16_t brightness = (uint16_t)(BREATH_BRIGHTNESS_TABLE[layer->state_data.breath.index] << LED_INTENSITY_SHIFT);
+#endif
             
             // 设置LED颜色
-            if (led_ctrl.current_state == LED_CONFIGURING) {
+            if (layer->state == LED_CONFIGURING) {
                 // 配网中：绿灯呼吸
-                tdd_pixel_set_all(0, brightness, 0);
+                RGBColor16 color = {0, brightness, 0};
+                layer_fill16(layer, &color, WS2812_LED_COUNT);
             } else {
                 // 呼吸灯：蓝灯呼吸
-                tdd_pixel_set_all(0, 0, brightness);
+                RGBColor16 color = {0, 0, brightness};
+                layer_fill16(layer, &color, WS2812_LED_COUNT);
             }
-            tdd_pixel_refresh();
             
-            // 设置下一次呼吸定时
-            tal_sw_timer_start(led_ctrl.main_timer, BREATH_TIMER_INTERVAL, TAL_TIMER_ONCE);
+            // 设置下一次呼吸
+            arm_state_event(layer, deadline, BREATH_TIMER_INTERVAL);
             break;
         }
+        
+        case LED_CLIP:
+            clip_step(layer, deadline);
+            break;
             
         default:
             // 其他状态无需处理
             break;
     }
+}
+
+// 初始化命令队列，各槽位seq为其位置
+static void led_cmd_queue_init(void) {
+    uint32_t i = 0;
     
-    tal_mutex_unlock(led_ctrl.mutex);
+    for (i = 0; i < LED_CMD_QUEUE_SIZE; i++) {
+        led_ctrl.cmd_ring[i].seq = i;
+    }
+    led_ctrl.cmd_enq_pos = 0;
+    led_ctrl.cmd_deq_pos = 0;
+}
+
+// 命令入队（无锁，可在中断中调用），队列满返回FALSE，ticket输出命令序号（队列位置）
+static BOOL_T led_cmd_enqueue(const LedStateCmd *cmd, uint32_t *ticket) {
+    LedCmdSlot *slot = NULL;
+    uint32_t pos = __atomic_load_n(&led_ctrl.cmd_enq_pos, __ATOMIC_RELAXED);
+    uint32_t seq = 0;
+    int32_t diff = 0;
+    
+    for (;;) {
+        slot = &led_ctrl.cmd_ring[pos & (LED_CMD_QUEUE_SIZE - 1)];
+        seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        diff = (int32_t)(seq - pos);
+        if (0 == diff) {
+            // 槽位可写，抢占该位置；失败时pos更新为最新位置后重试
+            if (__atomic_compare_exchange_n(&led_ctrl.cmd_enq_pos, &pos, pos + 1, TRUE,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // 槽位尚未被消费者释放：队列满
+            return FALSE;
+        } else {
+            pos = __atomic_load_n(&led_ctrl.cmd_enq_pos, __ATOMIC_RELAXED);
+        }
+    }
+    
+    slot->cmd = *cmd;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+    *ticket = pos;
+    
+    return TRUE;
 }
 
-// 清理当前状态资源
-static void cleanup_current_state(void) {
-    // 停止主定时器
-    tal_sw_timer_stop(led_ctrl.main_timer);
+// 命令出队（只在渲染线程调用），无可读命令返回FALSE
+// 生产者抢占位置后尚未写完时同样返回FALSE，该命令在下一帧取出，保持先后顺序
+static BOOL_T led_cmd_dequeue(LedStateCmd *cmd) {
+    uint32_t pos = led_ctrl.cmd_deq_pos;
+    LedCmdSlot *slot = &led_ctrl.cmd_ring[pos & (LED_CMD_QUEUE_SIZE - 1)];
+    
+    if ((int32_t)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - (pos + 1)) < 0) {
+        return FALSE;
+    }
+    
+    *cmd = slot->cmd;
+    __atomic_store_n(&slot->seq, pos + LED_CMD_QUEUE_SIZE, __ATOMIC_RELEASE);
+    led_ctrl.cmd_deq_pos = pos + 1;
+    
+    return TRUE;
+}
+
+// 提交状态命令，wake为TRUE时唤醒渲染线程立即出帧
+static void submit_led_state(LedState new_state, uint8_t value, BOOL_T wake) {
+    LedStateCmd cmd;
+    uint32_t ticket = 0;
+    
+    if ((uint32_t)new_state >= sizeof(LED_STATE_LAYER)) {
+        return;
+    }
+    
+    cmd.state = new_state;
+    cmd.value = value;
+    cmd.enqueue_ms = tal_system_get_millisecond();
+    if (!led_cmd_enqueue(&cmd, &ticket)) {
+        __atomic_fetch_add(&led_ctrl.cmd_dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    PIXEL_TRACE(PIXEL_TRACE_STATE_REQ, new_state, value, ticket);
+    
+    if (wake && led_ctrl.wake_sem) {
+        tal_semaphore_post(led_ctrl.wake_sem);
+    }
+}
+
+// 执行一条状态命令（已持有锁）
+static void apply_led_state(const LedStateCmd *cmd, SYS_TIME_T now) {
+    TAL_PR_DEBUG("Setting LED state: %d, value: %d", cmd->state, cmd->value);
+    
+    // 上电自检独占处理：自检过程中接收的新状态将被缓存
+    if (led_ctrl.layers[LED_LAYER_BACKGROUND].state == LED_INIT && cmd->state != LED_INIT) {
+        led_ctrl.pending_state = cmd->state;
+        led_ctrl.pending_value = cmd->value;
+        led_ctrl.has_pending_state = TRUE;
+        TAL_PR_DEBUG("Init in progress, pending state: %d", cmd->state);
+    } else {
+        enter_led_state(cmd->state, cmd->value, now);
+    }
+    
+    // 记录最早一条尚未显示的命令，在其后的首次刷新时统计延迟
+    if (!led_ctrl.cmd_visible_pending || cmd->enqueue_ms < led_ctrl.cmd_visible_since) {
+        led_ctrl.cmd_visible_since = cmd->enqueue_ms;
+    }
+    led_ctrl.cmd_visible_pending = TRUE;
+    led_ctrl.stats.cmd_applied++;
+}
+
+// 从队列取出已提交的状态命令，合并到各图层待执行命令（同一图层只保留最后一条）
+static void collect_state_cmds(void) {
+    LedStateCmd cmd;
+    SYS_TIME_T first_ms = 0;
+    uint32_t cnt = 0;
+    uint8_t id = 0;
+    
+    // 每次最多取出一个队列长度的命令，避免生产者持续提交时饿死渲染
+    while (cnt < LED_CMD_QUEUE_SIZE && led_cmd_dequeue(&cmd)) {
+        id = LED_STATE_LAYER[cmd.state];
+        if (led_ctrl.cmd_merge_valid[id]) {
+            // 被合并的命令也计入显示延迟：保留该图层最早的入队时间
+            first_ms = led_ctrl.cmd_merge[id].enqueue_ms;
+            led_ctrl.cmd_merge[id] = cmd;
+            led_ctrl.cmd_merge[id].enqueue_ms = first_ms;
+            led_ctrl.stats.cmd_merged++;
+        } else {
+            led_ctrl.cmd_merge[id] = cmd;
+            led_ctrl.cmd_merge_valid[id] = TRUE;
+        }
+        led_ctrl.cmd_merge_order[id] = led_ctrl.cmd_deq_pos;
+        cnt++;
+    }
+}
+
+// 取出并执行合并后的状态命令，返回执行的命令数
+// 各图层按其最后一条命令的提交顺序执行：图层之间的唯一影响是背景状态移除上层，
+// 按该顺序执行与逐条执行的最终结果相同
+static uint32_t process_state_cmds(SYS_TIME_T now) {
+    uint32_t cmds = 0;
+    uint8_t next = 0, i = 0;
+    
+    collect_state_cmds();
+    
+    for (;;) {
+        next = LED_LAYER_NUM;
+        for (i = 0; i < LED_LAYER_NUM; i++) {
+            if (led_ctrl.cmd_merge_valid[i] &&
+                (LED_LAYER_NUM == next ||
+                 (int32_t)(led_ctrl.cmd_merge_order[i] - led_ctrl.cmd_merge_order[next]) < 0)) {
+                next = i;
+            }
+        }
+        if (LED_LAYER_NUM == next) {
+            break;
+        }
+        
+        led_ctrl.cmd_merge_valid[next] = FALSE;
+        // 出队后cmd_deq_pos已指向下一位置，命令序号为其减1
+        PIXEL_TRACE(PIXEL_TRACE_STATE_APPLY, led_ctrl.cmd_merge[next].state, 0, led_ctrl.cmd_merge_order[next] - 1);
+        apply_led_state(&led_ctrl.cmd_merge[next], now);
+        cmds++;
+    }
+    
+    return cmds;
+}
+
+// 处理所有到期的状态事件，返回处理的事件数
+static uint32_t process_state_events(SYS_TIME_T now) {
+    LedLayer *next = NULL;
+    SYS_TIME_T deadline = 0;
+    uint32_t events = 0;
+    uint8_t i = 0;
+    
+    // 按截止时间先后依次处理（事件可能链式安排下一个事件）
+    while (events < LED_RENDER_EVENT_MAX) {
+        next = NULL;
+        for (i = 0; i < LED_LAYER_NUM; i++) {
+            LedLayer *layer = &led_ctrl.layers[i];
+            if (layer->event_armed && layer->event_deadline <= now &&
+                (NULL == next || layer->event_deadline < next->event_deadline)) {
+                next = layer;
+            }
+        }
+        if (NULL == next) {
+            break;
+        }
+        
+        deadline = next->event_deadline;
+        next->event_armed = FALSE;
+        handle_state_event(next, deadline);
+        events++;
+    }
+    
+    return events;
+}
+
+// 渲染线程：按绝对截止时间以LED_RENDER_FPS出帧，处理到期的状态事件后合成刷新
+static void led_render_task(void *args) {
+    SYS_TIME_T next_tick = tal_system_get_millisecond();
+    SYS_TIME_T last_frame = 0;
+    SYS_TIME_T now = 0;
+    uint32_t late = 0;
+    uint32_t latency = 0;
+    uint32_t missed = 0;
+    uint32_t frame_seq = 0;
+    unsigned long long start_us = 0;
+    OPERATE_RET ret = OPRT_OK;
+    BOOL_T early = FALSE;
+    BOOL_T refreshed = FALSE;
+    uint8_t i = 0;
+    
+    (void)args;
+    
+    for (;;) {
+        now = tal_system_get_millisecond();
+        if (next_tick > now) {
+            // 状态变化时提前唤醒，立即出帧但不改变节拍相位
+            tal_semaphore_wait(led_ctrl.wake_sem, (uint32_t)(next_tick - now));
+        }
+        if (led_ctrl.render_exit) {
+            break;
+        }
+        
+        now = tal_system_get_millisecond();
+        early = (now < next_tick) ? TRUE : FALSE;
+        if (!early) {
+            PIXEL_TRACE(PIXEL_TRACE_TICK, 0, (uint16_t)((now - next_tick > 0xFFFF) ? 0xFFFF : (now - next_tick)),
+                        (uint32_t)next_tick);
+        }
+        
+        // 一个帧周期内只提前出一帧，其后提交的命令取出合并，到下一个节拍一起显示
+        if (early && led_ctrl.stats.frames && (now - last_frame) < LED_RENDER_PERIOD_MS) {
+            tal_mutex_lock(led_ctrl.mutex);
+            collect_state_cmds();
+            tal_mutex_unlock(led_ctrl.mutex);
+            continue;
+        }
+        
+        start_us = PIXEL_PERF_NOW_US();
+        tal_mutex_lock(led_ctrl.mutex);
+        tdd_pixel_perf_record_us(&led_ctrl.perf.lock_wait_us, (uint32_t)(PIXEL_PERF_NOW_US() - start_us));
+        
+        process_state_cmds(now);
+        process_state_events(now);
+        
+        for (i = 0; i < LED_LAYER_NUM; i++) {
+            if (led_ctrl.layers[i].active && led_ctrl.layers[i].fade_dir != 0) {
+                layer_update_fade(&led_ctrl.layers[i], now);
+            }
+        }
+        
+        // 时间抖动每帧输出不同的量化值
+        refreshed = (led_ctrl.frame_dirty || led_ctrl.dither_active) ? TRUE : FALSE;
+        if (refreshed) {
+            led_ctrl.frame_dirty = FALSE;
+            compose_frame();
+            
+            // 同步模式下发送完成回调在刷新返回前执行，先发布携带命令的帧序号；
+            // 发送完成延迟按命令抽样，上一条命令的帧仍在发送时本条命令不统计
+            frame_seq = led_ctrl.frames_submitted + 1;
+            if (0 == frame_seq) {
+                frame_seq = 1;
+            }
+            if (led_ctrl.cmd_visible_pending && 0 == __atomic_load_n(&led_ctrl.cmd_shown_frame, __ATOMIC_ACQUIRE)) {
+                led_ctrl.cmd_shown_since = led_ctrl.cmd_visible_since;
+                __atomic_store_n(&led_ctrl.cmd_shown_frame, frame_seq, __ATOMIC_RELEASE);
+            }
+            
+            start_us = PIXEL_PERF_NOW_US();
+            PIXEL_TRACE(PIXEL_TRACE_REFRESH, 0, 0, led_ctrl.stats.frames);
+            ret = tdd_pixel_refresh();
+            PIXEL_TRACE(PIXEL_TRACE_REFRESH_END, 0, (uint16_t)ret, 0);
+            tdd_pixel_perf_record_us(&led_ctrl.perf.refresh_us, (uint32_t)(PIXEL_PERF_NOW_US() - start_us));
+            led_ctrl.stats.frames++;
+            led_ctrl.perf.frames_rendered++;
+            last_frame = now;
+            
+            if (OPRT_OK == ret) {
+                led_ctrl.frames_submitted = frame_seq;
+            } else {
+                // 刷新失败不会回调，撤销发布，命令在下一次刷新时统计
+                __atomic_compare_exchange_n(&led_ctrl.cmd_shown_frame, &frame_seq, 0, FALSE,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+            }
+            if (OPRT_OK == ret && led_ctrl.cmd_visible_pending) {
+                led_ctrl.cmd_visible_pending = FALSE;
+                latency = (uint32_t)(tal_system_get_millisecond() - led_ctrl.cmd_visible_since);
+                led_ctrl.stats.cmd_queued_last_ms = latency;
+                if (latency > led_ctrl.stats.cmd_queued_max_ms) {
+                    led_ctrl.stats.cmd_queued_max_ms = latency;
+                }
+            }
+        }
+        
+        if (!early) {
+            led_ctrl.stats.ticks++;
+            late = (uint32_t)(now - next_tick);
+            if (late > led_ctrl.stats.max_lateness_ms) {
+                led_ctrl.stats.max_lateness_ms = late;
+            }
+            tdd_pixel_perf_record(&led_ctrl.perf.tick_late_ms, late);
+            if (!refreshed) {
+                led_ctrl.perf.frames_idle++;
+            }
+            // 延迟超过一个周期的节拍直接跳过，保持节拍相位
+            missed = late / LED_RENDER_PERIOD_MS;
+            led_ctrl.stats.missed_deadlines += missed;
+        }
+        
+        tal_mutex_unlock(led_ctrl.mutex);
+        
+        if (!early) {
+            next_tick += (SYS_TIME_T)(missed + 1) * LED_RENDER_PERIOD_MS;
+        }
+    }
+    
+    tal_semaphore_post(led_ctrl.exit_sem);
+}
+
+// 停止渲染线程并释放资源
+static void led_render_stop(void) {
+    if (led_ctrl.render_thread) {
+        led_ctrl.render_exit = TRUE;
+        tal_semaphore_post(led_ctrl.wake_sem);
+        tal_semaphore_wait(led_ctrl.exit_sem, SEM_WAIT_FOREVER);
+        tal_thread_delete(led_ctrl.render_thread);
+        led_ctrl.render_thread = NULL;
+    }
+    if (led_ctrl.wake_sem) {
+        tal_semaphore_release(led_ctrl.wake_sem);
+        led_ctrl.wake_sem = NULL;
+    }
+    if (led_ctrl.exit_sem) {
+        tal_semaphore_release(led_ctrl.exit_sem);
+        led_ctrl.exit_sem = NULL;
+    }
+}
+
+// 创建渲染线程
+static OPERATE_RET led_render_start(void) {
+    OPERATE_RET ret;
+    THREAD_CFG_T thrd_cfg = {
+        .stackDepth = LED_RENDER_THREAD_STACK,
+        .priority = LED_RENDER_THREAD_PRIO,
+        .thrdname = "led_render",
+    };
+    
+    ret = tal_semaphore_create_init(&led_ctrl.wake_sem, 0, 1);
+    if (ret != OPRT_OK) {
+        return ret;
+    }
+    ret = tal_semaphore_create_init(&led_ctrl.exit_sem, 0, 1);
+    if (ret != OPRT_OK) {
+        led_render_stop();
+        return ret;
+    }
+    
+    led_ctrl.render_exit = FALSE;
+    ret = tal_thread_create_and_start(&led_ctrl.render_thread, NULL, NULL, led_render_task, NULL, &thrd_cfg);
+    if (ret != OPRT_OK) {
+        led_ctrl.render_thread = NULL;
+        led_render_stop();
+        return ret;
+    }
+    
+    return OPRT_OK;
+}
+
+// 清理图层状态资源
+static void cleanup_layer(LedLayer *layer) {
+    // 取消待处理的状态事件
+    layer->event_armed = FALSE;
+    
+    // 关闭片段
+    if (LED_CLIP == layer->state && led_ctrl.clip) {
+        tdl_pixel_clip_close(led_ctrl.clip);
+        led_ctrl.clip = NULL;
+        memset(&led_ctrl.clip_frame, 0, sizeof(led_ctrl.clip_frame));
+    }
     
     // 重置状态数据
-    memset(&led_ctrl.state_data, 0, sizeof(led_ctrl.state_data));
+    memset(&layer->state_data, 0, sizeof(layer->state_data));
 }
 
 // 初始化LED控制器
@@ -326,6 +1144,11 @@ void led_controller_init(void) {
     
     // 清零控制结构体
     memset(&led_ctrl, 0, sizeof(LedController));
+    led_cmd_queue_init();
+    dither_init();
+    
+    // 性能计时的硬件定时器在任务上下文中启动，之后中断中的跟踪事件也可以计时
+    tdd_pixel_perf_init();
     
     // 创建互斥锁
     if (NULL == led_ctrl.mutex) {
@@ -342,97 +1165,204 @@ void led_controller_init(void) {
     }
     TAL_PR_DEBUG("TDD WS2812 driver initialized");
     
-    // 创建主定时器
-    tal_sw_timer_create(main_timer_cb, NULL, &led_ctrl.main_timer);
+    // 初始状态：上电自检（渲染线程启动后首帧执行）
+    set_led_state(LED_INIT, 0);
     
-    TAL_PR_DEBUG("LED controller initialized");
+    // 创建渲染线程
+    if (OPRT_OK != led_render_start()) {
+        TAL_PR_ERR("Failed to start LED render thread");
+        return;
+    }
     
-    // 初始状态：上电自检
-    set_led_state(LED_INIT, 0);
+    TAL_PR_DEBUG("LED controller initialized");
 }
 
-// 设置LED状态
+// 设置LED状态：命令入队后唤醒渲染线程，由渲染线程执行
 void set_led_state(LedState new_state, uint8_t value) {
-    TAL_PR_DEBUG("Setting LED state: %d, value: %d", new_state, value);
-    
-    tal_mutex_lock(led_ctrl.mutex);
+    submit_led_state(new_state, value, TRUE);
+}
+
+// 在中断中设置LED状态：只入队不唤醒，渲染线程在下一个节拍执行
+void set_led_state_isr(LedState new_state, uint8_t value) {
+    submit_led_state(new_state, value, FALSE);
+}
+
+// 进入新状态（已持有锁），now为状态事件的计时起点
+static void enter_led_state(LedState new_state, uint8_t value, SYS_TIME_T now) {
+    uint8_t id = LED_STATE_LAYER[new_state];
+    LedLayer *layer = &led_ctrl.layers[id];
+    uint8_t i = 0;
     
-    // 上电自检独占处理：自检过程中接收的新状态将被缓存
-    if (led_ctrl.current_state == LED_INIT && new_state != LED_INIT) {
-        led_ctrl.pending_state = new_state;
-        led_ctrl.pending_value = value;
-        led_ctrl.has_pending_state = TRUE;
-        TAL_PR_DEBUG("Init in progress, pending state: %d", new_state);
-        tal_mutex_unlock(led_ctrl.mutex);
-        return;
+    if (LED_LAYER_BACKGROUND == id) {
+        // 背景状态切换视为模式切换，上层指示与浮层淡出
+        for (i = LED_LAYER_BACKGROUND + 1; i < LED_LAYER_NUM; i++) {
+            layer_remove(&led_ctrl.layers[i], now);
+        }
+    } else if (!layer->active || layer->fade_dir < 0) {
+        // 上层图层淡入
+        layer_fade(layer, 1, now);
     }
     
-    // 清理前一个状态
-    cleanup_current_state();
+    // 清理该图层的前一个状态
+    cleanup_layer(layer);
+    layer->state = new_state;
+    layer->active = TRUE;
     
     // 执行新状态
     switch (new_state) {
         case LED_INIT: // 上电自检（红->绿->蓝）
-            set_all_leds(&COLOR_RED);
-            led_ctrl.state_data.init.step = 0;
-            tal_sw_timer_start(led_ctrl.main_timer, INIT_RED_TIME, TAL_TIMER_ONCE);
+            layer_fill(layer, &COLOR_RED, WS2812_LED_COUNT);
+            layer->state_data.init.step = 0;
+            arm_state_event(layer, now, INIT_RED_TIME);
             break;
             
         case LED_IDLE: // 空闲状态（所有LED熄灭）
-            set_all_leds(&COLOR_BLACK);
+            layer_fill(layer, &COLOR_BLACK, WS2812_LED_COUNT);
             break;
             
         case LED_CONFIGURING: // 配网中（绿灯呼吸效果）
-            led_ctrl.state_data.breath.index = 0;
-            tal_sw_timer_start(led_ctrl.main_timer, BREATH_TIMER_INTERVAL, TAL_TIMER_ONCE);
+            layer->state_data.breath.index = 0;
+            arm_state_event(layer, now, BREATH_TIMER_INTERVAL);
             break;
             
         case LED_CONFIG_SUCCESS: // 配网成功（显示WIFI信号强度）
-            set_level_leds(&COLOR_GREEN, value);
-            tal_sw_timer_start(led_ctrl.main_timer, CONFIG_SUCCESS_TIMEOUT, TAL_TIMER_ONCE);
+            layer_fill(layer, &COLOR_GREEN, value);
+            arm_state_event(layer, now, CONFIG_SUCCESS_TIMEOUT);
             break;
             
         case LED_NET_ERROR: // 网络异常（红灯常亮）
-            set_all_leds(&COLOR_RED);
+            layer_fill(layer, &COLOR_RED, WS2812_LED_COUNT);
             break;
             
         case LED_DIALOG: // 对话中（蓝灯闪烁）
-            set_all_leds(&COLOR_BLUE);
-            led_ctrl.state_data.blink.is_light_on = TRUE;
-            led_ctrl.state_data.blink.blink_count = 0;
-            tal_sw_timer_start(led_ctrl.main_timer, DIALOG_LIGHT_ON_TIME, TAL_TIMER_ONCE);
+            layer_fill(layer, &COLOR_BLUE, WS2812_LED_COUNT);
+            layer->state_data.blink.is_light_on = TRUE;
+            layer->state_data.blink.blink_count = 0;
+            arm_state_event(layer, now, DIALOG_LIGHT_ON_TIME);
             break;
             
         case LED_VOLUME: // 音量调节（黄灯等级显示）
-            set_level_leds(&COLOR_YELLOW, value);
-            tal_sw_timer_start(led_ctrl.main_timer, VOLUME_DISPLAY_TIMEOUT, TAL_TIMER_ONCE);
+            layer_fill(layer, &COLOR_YELLOW, value);
+            arm_state_event(layer, now, VOLUME_DISPLAY_TIMEOUT);
             break;
             
         case LED_BREATHING: // 呼吸灯效果（蓝灯呼吸）
-            led_ctrl.state_data.breath.index = 0;
-            tal_sw_timer_start(led_ctrl.main_timer, BREATH_TIMER_INTERVAL, TAL_TIMER_ONCE);
+            layer->state_data.breath.index = 0;
+            arm_state_event(layer, now, BREATH_TIMER_INTERVAL);
             break;
+            
+        case LED_CLIP: // 动画片段（逐帧解码播放）
+            led_ctrl.clip = __atomic_exchange_n(&led_ctrl.clip_next, NULL, __ATOMIC_ACQUIRE);
+            if (NULL == led_ctrl.clip) {
+                // 没有待播放的片段（已被后续播放请求取走）
+                layer_remove(layer, now);
+                break;
+            }
+            clip_step(layer, now);
+            break;
+    }
+}
+
+// 播放动画片段
+OPERATE_RET led_controller_play_clip(PIXEL_CLIP_READ_CB read, void *ctx) {
+    PIXEL_CLIP_HANDLE_T clip = NULL;
+    OPERATE_RET ret;
+    
+    ret = tdl_pixel_clip_open(&clip, read, ctx);
+    if (ret != OPRT_OK) {
+        return ret;
+    }
+    
+    // 替换尚未开始播放的片段
+    clip = __atomic_exchange_n(&led_ctrl.clip_next, clip, __ATOMIC_ACQ_REL);
+    if (clip) {
+        tdl_pixel_clip_close(clip);
+    }
+    
+    set_led_state(LED_CLIP, 0);
+    
+    return OPRT_OK;
+}
+
+
+// 获取渲染统计
+void led_controller_get_render_stats(LedRenderStats *stats) {
+    if (NULL == stats || NULL == led_ctrl.mutex) {
+        return;
+    }
+    
+    tal_mutex_lock(led_ctrl.mutex);
+    memcpy(stats, &led_ctrl.stats, sizeof(LedRenderStats));
+    tal_mutex_unlock(led_ctrl.mutex);
+    stats->cmd_dropped = __atomic_load_n(&led_ctrl.cmd_dropped, __ATOMIC_RELAXED);
+    // 发送完成延迟由驱动回调更新
+    stats->cmd_latency_last_ms = __atomic_load_n(&led_ctrl.cmd_latency_last_ms, __ATOMIC_RELAXED);
+    stats->cmd_latency_max_ms = __atomic_load_n(&led_ctrl.cmd_latency_max_ms, __ATOMIC_RELAXED);
+}
+
+// 获取性能统计
+void led_controller_get_stats(LedPerfStats *stats) {
+    PIXEL_DRV_TX_STATS_T tx_stats;
+    PIXEL_DRV_PERF_STATS_T drv_perf;
+    
+    if (NULL == stats || NULL == led_ctrl.mutex) {
+        return;
     }
     
-    // 更新当前状态
-    led_ctrl.current_state = new_state;
+    // 持有锁读取驱动统计：渲染线程只在持有锁时调用驱动，编码统计不会被同时更新；
+    // 异步发送线程更新的发送帧数与SPI耗时由驱动内部的统计锁保护
+    tal_mutex_lock(led_ctrl.mutex);
+    memcpy(stats, &led_ctrl.perf, sizeof(LedPerfStats));
+    if (tdd_pixel_handle != NULL) {
+        if (OPRT_OK == tdd_pixel_intfs.config(tdd_pixel_handle, DRV_CMD_GET_TX_STATS, &tx_stats)) {
+            stats->frames_sent = tx_stats.frames_sent;
+            stats->frames_skipped = tx_stats.frames_skipped;
+        }
+        if (OPRT_OK == tdd_pixel_intfs.config(tdd_pixel_handle, DRV_CMD_GET_PERF_STATS, &drv_perf)) {
+            stats->encode_us = drv_perf.encode_us;
+            stats->spi_us = drv_perf.spi_us;
+            stats->buf_wait_us = drv_perf.wait_us;
+        }
+    }
     tal_mutex_unlock(led_ctrl.mutex);
 }
 
+// 清零渲染统计、性能统计与驱动统计
+void led_controller_reset_stats(void) {
+    if (NULL == led_ctrl.mutex) {
+        return;
+    }
+    
+    tal_mutex_lock(led_ctrl.mutex);
+    memset(&led_ctrl.stats, 0, sizeof(LedRenderStats));
+    memset(&led_ctrl.perf, 0, sizeof(LedPerfStats));
+    if (tdd_pixel_handle != NULL) {
+        tdd_pixel_intfs.config(tdd_pixel_handle, DRV_CMD_RESET_TX_STATS, NULL);
+    }
+    tal_mutex_unlock(led_ctrl.mutex);
+    __atomic_store_n(&led_ctrl.cmd_dropped, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&led_ctrl.cmd_latency_last_ms, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&led_ctrl.cmd_latency_max_ms, 0, __ATOMIC_RELAXED);
+}
+
 // 去初始化LED控制器
 void led_controller_deinit(void) {
     TAL_PR_DEBUG("Deinitializing LED controller");
     
-    // 停止所有定时器
-    if (led_ctrl.main_timer) {
-        tal_sw_timer_stop(led_ctrl.main_timer);
-        tal_sw_timer_delete(led_ctrl.main_timer);
-        led_ctrl.main_timer = NULL;
-    }
+    // 停止渲染线程
+    led_render_stop();
     
     // 关闭TDD驱动
     tdd_pixel_deinit();
     
+    // 关闭片段
+    if (led_ctrl.clip) {
+        tdl_pixel_clip_close(led_ctrl.clip);
+    }
+    if (led_ctrl.clip_next) {
+        tdl_pixel_clip_close(led_ctrl.clip_next);
+    }
+    
     // 销毁互斥锁
     if (led_ctrl.mutex) {
         tal_mutex_unlock(led_ctrl.mutex);  // 确保未锁定状态
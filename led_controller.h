@@ -7,6 +7,7 @@
 #include "tal_mutex.h"
 #include "tal_gpio.h"
 #include "tdd_pixel_ws2812.h"
+#include "tdl_pixel_clip.h"
 
 // LED数量定义 (从原ws2812_spi.h移植)
 #define WS2812_LED_COUNT 12
@@ -15,14 +16,22 @@
 #define TIMER_ID_ACTION TUYA_TIMER_NUM_2 // 动作定时器ID
 /**
  * @file led_controller.h
- * @brief LED状态机控制器 - 双定时器版本
+ * @brief LED状态机控制器 - 渲染线程版本
  * 
  * 设计说明：
- * 1. 使用双定时器架构：状态定时器处理状态超时和转换，动作定时器处理LED动态效果
- * 2. 呼吸灯使用预计算的亮度表实现非线性亮度变化，符合人眼感知
- * 3. 所有时间参数通过宏定义配置，便于调整
- * 4. 状态机支持状态缓存机制，确保自检过程中不丢失指令
- * 5. 使用互斥锁保护状态机数据，确保多线程安全
+ * 1. 独立渲染线程按固定帧率、以绝对截止时间出帧，状态超时、闪烁、呼吸等事件都在该节拍中处理，
+ *    事件按截止时间链式安排，周期不随渲染和SPI发送耗时漂移，也不占用系统软件定时器线程
+ * 2. 状态按优先级分为三层合成输出：背景（自检/空闲/配网中/呼吸灯）、指示（网络异常/对话中）、
+ *    浮层（配网成功/音量）。上层按定点不透明度混合在下层之上并淡入淡出，每层每帧最多一次混合，
+ *    浮层超时后淡出露出下层效果；设置背景状态时上层淡出
+ * 3. 呼吸灯使用预计算的8.8定点亮度表实现非线性亮度变化，符合人眼感知；
+ *    开启LED_DITHER_ENABLE时背景层按8.8定点亮度经时间抖动输出（默认关闭，见时间抖动参数），
+ *    关闭时输出原8位亮度表
+ * 4. 所有时间参数通过宏定义配置，便于调整；新的灯效可以做成tdl_pixel_clip格式的动画片段，
+ *    按数据播放，逐帧从flash/文件读取解码，不需要修改状态机
+ * 5. 状态机支持状态缓存机制，确保自检过程中不丢失指令
+ * 6. 状态设置经多生产者单消费者无锁命令队列提交，调用者（含中断）不加锁、不等待渲染与SPI发送，
+ *    状态机数据只由渲染线程修改
  */
 
 // ========================== 时间参数配置 ==========================
@@ -41,6 +50,70 @@
 #define DIALOG_LIGHT_OFF_TIME   150   // 对话状态灭灯时间 (ms)
 #define DIALOG_BLINK_COUNT      (DIALOG_TOTAL_TIME / (DIALOG_LIGHT_ON_TIME + DIALOG_LIGHT_OFF_TIME)) // 闪烁次数
 
+// 驱动后端：WS2812为单线灯带（SPI模拟时序，每个数据位扩展为3~8个SPI位）
+// APA102为时钟+数据两线灯带（APA102/SK9822，每像素4字节，无位扩展，适合长灯带与高刷新率）
+#define LED_PIXEL_BACKEND_WS2812 0
+#define LED_PIXEL_BACKEND_APA102 1
+#define LED_PIXEL_BACKEND       LED_PIXEL_BACKEND_WS2812
+
+// SPI码型（PIXEL_SPI_CODE_8BIT/4BIT/3BIT），码型越短发送缓存与总线时间越少，仅WS2812后端使用
+#define LED_SPI_CODE_MODE       PIXEL_SPI_CODE_8BIT
+#if (LED_PIXEL_BACKEND == LED_PIXEL_BACKEND_APA102)
+// 芯片型号（PIXEL_CHIP_APA102/SK9822）
+#define LED_PIXEL_CHIP          PIXEL_CHIP_APA102
+#define LED_PIXEL_LINE_SEQ      BGR_ORDER
+#else
+// 芯片型号（PIXEL_CHIP_WS2812B/WS2812/SK6812），决定码流末尾复位零字节数，复位时间越短连续帧间隔越小
+#define LED_PIXEL_CHIP          PIXEL_CHIP_WS2812B
+#define LED_PIXEL_LINE_SEQ      RGB_ORDER  // 与原先缓冲区G、R、B经GRB变换后的线上顺序一致
+#endif
+// 颜色通道数：3为RGB灯珠，4为RGBW灯珠（如SK6812 RGBW，仅WS2812后端），四通道时RGB中的白色分量由W通道发出
+#define LED_PIXEL_CHANNELS      3
+// 异步双缓存发送：刷新只做编码，SPI发送在驱动发送线程中完成（WS2812后端）
+#define LED_SPI_ASYNC_ENABLE    1
+// 流式发送每块像素数，0为关闭（WS2812后端）：两块码流交替编码与发送，码流内存与灯带长度无关，
+// 开启时不使用异步双缓存、编码帧缓存与纯色重复块；块间隔超过芯片复位时间会提前锁存，见驱动欠载统计
+#define LED_SPI_STREAM_CHUNK    0
+
+// 颜色校正参数，在驱动中折叠进SPI编码查找表，不增加逐像素计算
+#define LED_GAMMA_X10           10    // 伽马值 x10，10为线性（呼吸灯亮度表已按人眼感知预校正）
+#define LED_BRIGHTNESS          255   // 全局亮度 (0-255)
+#define LED_GAIN_R              255   // 红色通道校正 (0-255)
+#define LED_GAIN_G              255   // 绿色通道校正 (0-255)
+#define LED_GAIN_B              255   // 蓝色通道校正 (0-255)
+
+// 编码帧缓存：重复出现的帧命中时跳过编码直接发送，0为关闭（WS2812后端）
+// 每个条目约 LED数 x 3 x 码型字节数 + 复位零字节 + 40 字节（12颗、8位码型、WS2812B约486字节）；
+// 循环效果只有全部亮度级都放得下时才会命中，放不下时缓存只占内存，故默认关闭
+#define LED_FRAME_CACHE_SIZE    0
+
+// 纯色帧重复块的像素数，0为关闭（WS2812后端）：纯色帧只编码一个像素并铺成一块。
+// SPI端口支持无间隔重复发送（tdd_pixel_spi_repeat_supported，链式DMA）时整帧由该块循环发出，编码与内存与灯带长度无关；
+// 否则退化为倍增拷贝铺满发送缓存后一次发送，省去逐像素查表，但拷贝仍与灯带长度成正比，也不节省内存
+#define LED_UNIFORM_REPEAT_BLOCK 0
+
+// 渲染线程参数
+#define LED_RENDER_FPS          100   // 渲染帧率
+#define LED_RENDER_PERIOD_MS    (1000 / LED_RENDER_FPS) // 帧周期 (ms)
+#define LED_RENDER_EVENT_MAX    64    // 单帧内最多处理的到期事件数（线程长时间被阻塞后追赶）
+#define LED_RENDER_THREAD_STACK 2048  // 渲染线程栈大小
+#define LED_RENDER_THREAD_PRIO  THREAD_PRIO_2 // 渲染线程优先级
+#define LED_CMD_QUEUE_SIZE      16    // 状态命令队列长度，必须为2的幂
+
+// 图层合成参数
+#define LED_LAYER_FADE_MS       200   // 指示层/浮层淡入淡出时间 (ms)
+#define LED_ALPHA_SHIFT         8     // 不透明度定点小数位数
+#define LED_ALPHA_MAX           (1 << LED_ALPHA_SHIFT) // 完全不透明
+
+// 时间抖动参数：背景层颜色为8.8定点，量化为8位时小数部分逐帧累积，以帧率换取低亮度的细分等级
+// 每个LED的余数从错开的相位开始，灯带整体亮度不随进位同步闪烁；但单个LED的进位周期仍为
+// 渲染帧率的分频（如33Hz），低亮度下肉眼可见，在有更高刷新率的抖动输出路径前默认关闭
+#define LED_DITHER_ENABLE       0     // 是否开启时间抖动（关闭时呼吸灯使用原8位亮度表）
+#define LED_DITHER_PHASE_STEP   157   // 相邻LED的初始余数间隔，接近256的黄金分割使相位均匀错开
+#define LED_INTENSITY_SHIFT     8     // 高精度颜色的小数位数
+#define LED_INTENSITY_MAX       (255 << LED_INTENSITY_SHIFT) // 高精度颜色最大值
+#define LED_INTENSITY_FRAC_MASK ((1 << LED_INTENSITY_SHIFT) - 1)
+
 // 呼吸灯参数
 #define BREATH_TIMER_INTERVAL   10    // 呼吸灯定时器周期 (ms)
 #define BREATH_TABLE_SIZE       256   // 呼吸灯亮度表大小
@@ -54,9 +127,39 @@ typedef enum {
     LED_NET_ERROR,    ///< 网络异常（红灯常亮）
     LED_DIALOG,       ///< 对话中（蓝灯闪烁）
     LED_VOLUME,       ///< 调节音量（黄灯等级显示）
-    LED_BREATHING     ///< 呼吸灯效果（蓝灯呼吸）
+    LED_BREATHING,    ///< 呼吸灯效果（蓝灯呼吸）
+    LED_CLIP          ///< 动画片段（由led_controller_play_clip设置的片段）
 } LedState;
 
+// 渲染统计
+typedef struct {
+    uint32_t ticks;             // 按节拍执行的帧数
+    uint32_t frames;            // 实际刷新的帧数（像素有变化）
+    uint32_t missed_deadlines;  // 错过的节拍数（延迟超过一个帧周期）
+    uint32_t max_lateness_ms;   // 节拍最大延迟 (ms)
+    uint32_t cmd_applied;       // 执行的状态命令数（合并后）
+    uint32_t cmd_merged;        // 同一帧内被同图层后续命令覆盖而未单独执行的命令数
+    uint32_t cmd_dropped;       // 命令队列满时丢弃的状态命令数
+    uint32_t cmd_queued_last_ms;  // 最近一次命令从入队到首帧提交驱动的延迟 (ms)
+    uint32_t cmd_queued_max_ms;   // 命令从入队到首帧提交驱动的最大延迟 (ms)
+    uint32_t cmd_latency_last_ms; // 最近一次命令从入队到首帧发送完成（含帧尾复位，灯珠已锁存）的延迟 (ms)
+    uint32_t cmd_latency_max_ms;  // 命令从入队到首帧发送完成的最大延迟 (ms)
+} LedRenderStats;
+
+// 性能统计：常开计数，时间单位为微秒（精度见tdd_pixel_perf_tick_us），节拍延迟为毫秒
+typedef struct {
+    uint32_t frames_rendered;          // 合成并提交驱动的帧数
+    uint32_t frames_idle;              // 画面无变化、未刷新的节拍数
+    uint32_t frames_sent;              // 驱动实际发送的帧数
+    uint32_t frames_skipped;           // 驱动判定与已发送帧相同而跳过发送的帧数
+    PIXEL_PERF_METRIC_T refresh_us;    // tdd_pixel_refresh耗时（等待发送缓存 + 编码，同步模式含发送）
+    PIXEL_PERF_METRIC_T encode_us;     // 驱动整帧编码耗时
+    PIXEL_PERF_METRIC_T spi_us;        // 驱动SPI发送耗时
+    PIXEL_PERF_METRIC_T buf_wait_us;   // 驱动等待空闲发送缓存的耗时
+    PIXEL_PERF_METRIC_T lock_wait_us;  // 渲染线程等待状态锁的耗时
+    PIXEL_PERF_METRIC_T tick_late_ms;  // 渲染节拍相对截止时间的延迟
+} LedPerfStats;
+
 /**
  * @brief 初始化LED控制器
  * 
@@ -64,8 +167,8 @@ typedef enum {
  * 1. 初始化状态机数据结构
  * 2. 创建互斥锁保护状态机
  * 3. 初始化TDD WS2812驱动
- * 4. 创建状态定时器和动作定时器
- * 5. 进入上电自检状态
+ * 4. 进入上电自检状态
+ * 5. 创建渲染线程
  */
 void led_controller_init(void);
 
@@ -78,12 +181,60 @@ void led_controller_init(void);
  *   - LED_VOLUME: 音量等级(0-8)
  *   - 其他状态: 忽略此参数
  * 
+ * 命令入队后立即返回，不阻塞；由渲染线程按提交顺序执行，队列满时丢弃并计数。
+ * 同一帧周期内提交到同一图层的多条命令合并为最后一条，只渲染输出一次。
+ * 
  * 状态转换说明：
  * 1. 如果当前处于自检状态，新状态将被缓存，自检完成后自动执行
- * 2. 其他状态下立即执行新状态，并清理前一个状态的资源
+ * 2. 其他状态下立即执行新状态，替换并清理同一图层的前一个状态，其他图层不受影响
+ * 3. 设置背景状态（空闲/配网中/呼吸灯）时，指示层与浮层淡出
  */
 void set_led_state(LedState new_state, uint8_t value);
 
+/**
+ * @brief 在中断上下文中设置LED状态
+ * 
+ * 与set_led_state相同，但不释放信号量唤醒渲染线程，命令在下一个渲染节拍
+ * （最迟LED_RENDER_PERIOD_MS后）执行
+ * 
+ * @param new_state 新状态（LedState枚举值）
+ * @param value 状态附加参数，同set_led_state
+ */
+void set_led_state_isr(LedState new_state, uint8_t value);
+
+/**
+ * @brief 播放动画片段
+ * 
+ * 打开片段后提交LED_CLIP状态，片段在浮层逐帧播放（按帧时长），非循环片段播放结束后淡出。
+ * 片段由控制器持有，切换到其他浮层状态或再次播放时关闭。不可在中断中调用。
+ * 
+ * @param read 片段读回调（见tdl_pixel_clip.h）
+ * @param ctx 读回调参数，片段关闭前需保持有效
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET led_controller_play_clip(PIXEL_CLIP_READ_CB read, void *ctx);
+
+/**
+ * @brief 获取渲染统计
+ * 
+ * @param stats 输出统计数据
+ */
+void led_controller_get_render_stats(LedRenderStats *stats);
+
+/**
+ * @brief 获取性能统计
+ * 
+ * 包含渲染线程的计数与驱动的编码、发送统计，各项的平均值为sum / count（见tdd_pixel_perf_avg）
+ * 
+ * @param stats 输出统计数据
+ */
+void led_controller_get_stats(LedPerfStats *stats);
+
+/**
+ * @brief 清零渲染统计、性能统计与驱动统计
+ */
+void led_controller_reset_stats(void);
+
 /**
  * @brief 去初始化LED控制器
  * 
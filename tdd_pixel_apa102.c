@@ -0,0 +1,558 @@
+/**
+ * @file tdd_pixel_apa102.c
+ * @author www.tuya.com
+ * @brief tdd_pixel_apa102 module is used to drive clocked APA102/SK9822 strips over SPI
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+#include "string.h"
+#include "math.h"
+#include "tuya_iot_config.h"
+
+#include "tal_log.h"
+#include "tal_memory.h"
+#include "tal_system.h"
+#include "tkl_spi.h"
+
+#include "tdl_pixel_driver.h"
+#include "tdd_pixel_basic.h"
+#include "tdd_pixel_trace.h"
+#include "tdd_pixel_apa102.h"
+/*********************************************************************
+******************************macro define****************************
+*********************************************************************/
+/* SPI时钟，APA102/SK9822可工作在更高频率，长灯带的时钟逐级转发，取保守值 */
+#define APA102_SPI_SPEED       8000000
+
+#define COLOR_PRIMARY_NUM      3
+#define COLOR_RESOLUTION       255
+
+/* 每像素字节数：1字节头（0xE0 | 全局电流）+ 3字节颜色 */
+#define APA102_PIXEL_LEN       4
+#define APA102_PIXEL_HEAD      0xE0
+#define APA102_START_LEN       4
+/* SK9822在结束帧前需要的复位帧 */
+#define SK9822_RESET_LEN       4
+
+/* 伽马值x10的线性值 */
+#define APA102_GAMMA_LINEAR    10
+
+typedef struct {
+    PIXEL_DRIVER_CONFIG_T cfg;          // 打开时的配置（端口、线序、芯片）
+    PIXEL_COLOR_CORRECTION_T color_cfg; // 颜色校正参数
+    BOOL_T color_dirty;                 // 颜色校正参数变化，下一帧编码前重建映射表
+    unsigned char lut[COLOR_PRIMARY_NUM][SPI_CODE_TABLE_SIZE]; // 按R、G、B索引的颜色映射表
+    const unsigned char *chan_lut[COLOR_PRIMARY_NUM]; // 线序第i个字节使用的映射表
+    unsigned char seq_idx[COLOR_PRIMARY_NUM]; // 线序第i个字节对应的R、G、B下标
+    unsigned char global;               // 5位全局电流上限，全局亮度为255时使用
+    unsigned char head_global;          // 像素头中的5位全局电流，由全局亮度换算
+    unsigned short pixel_num;           // 像素点数
+    DRV_PIXEL_TX_CTRL_T *tx_ctrl;       // 发送缓存：起始帧 + 像素 + 结束帧
+    unsigned char *last_frame;          // 上次编码的颜色数据（R、G、B）
+    BOOL_T frame_valid;                 // last_frame与发送缓存是否一致
+    BOOL_T sent_valid;                  // 发送缓存的数据是否已成功发出
+    unsigned char *shim_buf;            // 16位颜色数据转换为打包帧的缓存，首次使用时申请
+    unsigned int tx_seq;                // 已提交的帧序号
+
+    PIXEL_FRAME_DONE_CB done_cb;        // 帧发送完成回调
+    void *done_arg;                     // 回调参数
+    PIXEL_DRV_TX_STATS_T stats;         // 发送统计
+    PIXEL_DRV_PERF_STATS_T perf;        // 性能统计
+} DRV_APA102_HANDLE_T;
+
+/*********************************************************************
+****************************variable define***************************
+*********************************************************************/
+/* tdd_apa102_driver_open使用的默认配置，打开时拷贝到句柄中 */
+static PIXEL_DRIVER_CONFIG_T driver_info = {
+    .line_seq = BGR_ORDER,
+    .chip = PIXEL_CHIP_APA102,
+};
+/*********************************************************************
+****************************function define***************************
+*********************************************************************/
+/**
+ * @brief 校验设备配置
+ */
+static BOOL_T __apa102_cfg_valid(const PIXEL_DRIVER_CONFIG_T *cfg)
+{
+    if (cfg->line_seq > BGR_ORDER || cfg->port >= TUYA_SPI_NUM_MAX ||
+        (cfg->chip != PIXEL_CHIP_APA102 && cfg->chip != PIXEL_CHIP_SK9822) ||
+        (cfg->chan_num != 0 && cfg->chan_num != COLOR_PRIMARY_NUM)) {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief 结束帧长度：数据每经过一个像素延迟半个时钟，每16个像素需要额外1字节时钟
+ */
+static unsigned int __apa102_end_len(const DRV_APA102_HANDLE_T *drv)
+{
+    unsigned int len = (drv->pixel_num + 15) / 16;
+
+    if (len < APA102_START_LEN) {
+        len = APA102_START_LEN;
+    }
+    if (PIXEL_CHIP_SK9822 == drv->cfg.chip) {
+        len += SK9822_RESET_LEN;
+    }
+
+    return len;
+}
+
+/**
+ * @brief 按线序选定各字节的映射表
+ */
+static void __apa102_line_seq_update(DRV_APA102_HANDLE_T *drv)
+{
+    unsigned char i = 0;
+
+    tdd_rgb_line_seq_index(drv->cfg.line_seq, drv->seq_idx);
+    for (i = 0; i < COLOR_PRIMARY_NUM; i++) {
+        drv->chan_lut[i] = drv->lut[drv->seq_idx[i]];
+    }
+    drv->frame_valid = FALSE;
+}
+
+/**
+ * @brief 按当前全局电流写入所有像素头
+ */
+static void __apa102_head_fill(DRV_APA102_HANDLE_T *drv)
+{
+    unsigned char *dst = drv->tx_ctrl->tx_buffer + APA102_START_LEN;
+    unsigned int j = 0;
+
+    for (j = 0; j < drv->pixel_num; j++, dst += APA102_PIXEL_LEN) {
+        dst[0] = APA102_PIXEL_HEAD | drv->head_global;
+    }
+}
+
+/**
+ * @brief 按颜色校正参数重建R、G、B的映射表，并将全局亮度换算为像素头的全局电流
+ */
+static void __apa102_color_table_update(DRV_APA102_HANDLE_T *drv)
+{
+    PIXEL_COLOR_CORRECTION_T *cc = &drv->color_cfg;
+    unsigned char gain[COLOR_PRIMARY_NUM] = {cc->r_gain, cc->g_gain, cc->b_gain};
+    float gamma = (float)cc->gamma_x10 / APA102_GAMMA_LINEAR, scale = 0, level = 0, remain = 0;
+    unsigned int i = 0, v = 0;
+    unsigned char head = 0;
+
+    /* 亮度先落在全局电流上（向上取整），颜色只缩放剩余的比例，不超过1 */
+    head = (unsigned char)((drv->global * cc->brightness + COLOR_RESOLUTION - 1) / COLOR_RESOLUTION);
+    if (head) {
+        remain = (float)cc->brightness * drv->global / ((float)head * COLOR_RESOLUTION);
+    }
+    if (head != drv->head_global) {
+        drv->head_global = head;
+        /* 打开设备时发送缓存尚未申请，申请后再写入 */
+        if (drv->tx_ctrl) {
+            __apa102_head_fill(drv);
+            drv->sent_valid = FALSE;
+        }
+    }
+
+    for (i = 0; i < COLOR_PRIMARY_NUM; i++) {
+        scale = remain * gain[i];
+        for (v = 0; v < SPI_CODE_TABLE_SIZE; v++) {
+            level = powf((float)v / COLOR_RESOLUTION, gamma) * scale + 0.5f;
+            drv->lut[i][v] = (level >= COLOR_RESOLUTION) ? COLOR_RESOLUTION : (unsigned char)level;
+        }
+    }
+
+    drv->color_dirty = FALSE;
+    drv->frame_valid = FALSE;
+}
+
+/**
+ * @brief 写入像素颜色（像素头已由__apa102_head_fill写入），返回重新编码的像素数
+ */
+static unsigned int __apa102_encode(DRV_APA102_HANDLE_T *drv, const unsigned char *src, unsigned int src_step,
+                                    unsigned int pixel_cnt)
+{
+    const unsigned char *l0 = drv->chan_lut[0];
+    const unsigned char *l1 = drv->chan_lut[1];
+    const unsigned char *l2 = drv->chan_lut[2];
+    unsigned char i0 = drv->seq_idx[0], i1 = drv->seq_idx[1], i2 = drv->seq_idx[2];
+    unsigned char *dst = drv->tx_ctrl->tx_buffer + APA102_START_LEN;
+    unsigned char *last = drv->last_frame;
+    BOOL_T valid = drv->frame_valid;
+    unsigned int j = 0, encoded = 0;
+
+    for (j = 0; j < pixel_cnt; j++, src += src_step, last += COLOR_PRIMARY_NUM, dst += APA102_PIXEL_LEN) {
+        if (valid && last[0] == src[0] && last[1] == src[1] && last[2] == src[2]) {
+            continue;
+        }
+        last[0] = src[0];
+        last[1] = src[1];
+        last[2] = src[2];
+        dst[1] = l0[src[i0]];
+        dst[2] = l1[src[i1]];
+        dst[3] = l2[src[i2]];
+        encoded++;
+    }
+
+    return encoded;
+}
+
+/**
+ * @brief 发送整帧并通知上层
+ */
+static OPERATE_RET __apa102_frame_submit(DRV_APA102_HANDLE_T *drv)
+{
+    OPERATE_RET ret = OPRT_OK;
+    unsigned long long start = 0;
+    unsigned int seq = ++drv->tx_seq;
+
+    PIXEL_TRACE(PIXEL_TRACE_FRAME_SUBMIT, drv->cfg.port, 0, seq);
+    start = PIXEL_PERF_NOW_US();
+    ret = tdd_pixel_spi_send(drv->cfg.port, drv->tx_ctrl->tx_buffer, drv->tx_ctrl->tx_buffer_len);
+    tdd_pixel_perf_record_us(&drv->perf.spi_us, (unsigned int)(PIXEL_PERF_NOW_US() - start));
+    PIXEL_TRACE(PIXEL_TRACE_SPI_DONE, drv->cfg.port, (unsigned short)ret, seq);
+
+    if (OPRT_OK == ret) {
+        drv->stats.frames_sent++;
+        drv->sent_valid = TRUE;
+    } else {
+        /* 发送失败，下一帧强制发送 */
+        drv->sent_valid = FALSE;
+    }
+
+    /* 发送失败时返回错误，不回调 */
+    if (OPRT_OK == ret && drv->done_cb) {
+        drv->done_cb((DRIVER_HANDLE_T)drv, ret, drv->done_arg);
+    }
+
+    return ret;
+}
+
+/**
+ * @function:tdd_apa102_driver_open_cfg
+ * @brief: 按指定配置打开（初始化）设备
+ * @param[in]: pixel_num -> 像素点数
+ * @param[in]: cfg -> 设备配置
+ * @param[out]: *handle  -> 设备句柄
+ * @return: success -> 0  fail -> else
+ */
+OPERATE_RET tdd_apa102_driver_open_cfg(OUT DRIVER_HANDLE_T *handle, IN unsigned short pixel_num,
+                                       IN PIXEL_DRIVER_CONFIG_T *cfg)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    TUYA_SPI_BASE_CFG_T spi_cfg = {0};
+    DRV_APA102_HANDLE_T *drv = NULL;
+    unsigned int data_len = 0;
+
+    if (NULL == handle || (0 == pixel_num) || NULL == cfg || !__apa102_cfg_valid(cfg)) {
+        return OPRT_INVALID_PARM;
+    }
+    if (tdd_pixel_spi_port_claim(cfg->port) != OPRT_OK) {
+        TAL_PR_ERR("spi port %d already opened", cfg->port);
+        return OPRT_COM_ERROR;
+    }
+
+    drv = (DRV_APA102_HANDLE_T *)tal_malloc(sizeof(DRV_APA102_HANDLE_T));
+    if (NULL == drv) {
+        tdd_pixel_spi_port_release(cfg->port);
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(drv, 0, sizeof(DRV_APA102_HANDLE_T));
+    memcpy(&drv->cfg, cfg, sizeof(PIXEL_DRIVER_CONFIG_T));
+    drv->pixel_num = pixel_num;
+    drv->global = APA102_GLOBAL_CURRENT_MAX;
+    drv->color_cfg.gamma_x10 = APA102_GAMMA_LINEAR;
+    drv->color_cfg.brightness = COLOR_RESOLUTION;
+    drv->color_cfg.r_gain = COLOR_RESOLUTION;
+    drv->color_cfg.g_gain = COLOR_RESOLUTION;
+    drv->color_cfg.b_gain = COLOR_RESOLUTION;
+    __apa102_color_table_update(drv);
+    __apa102_line_seq_update(drv);
+
+    /* 未写入的像素为熄灭 */
+    drv->last_frame = (unsigned char *)tal_malloc(COLOR_PRIMARY_NUM * pixel_num);
+    if (NULL == drv->last_frame) {
+        tal_free(drv);
+        tdd_pixel_spi_port_release(cfg->port);
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(drv->last_frame, 0, COLOR_PRIMARY_NUM * pixel_num);
+
+    /* 起始帧与结束帧为零，tdd_pixel_create_tx_ctrl申请后已清零 */
+    data_len = APA102_START_LEN + APA102_PIXEL_LEN * pixel_num + __apa102_end_len(drv);
+    op_ret = tdd_pixel_create_tx_ctrl(data_len, &drv->tx_ctrl);
+    if (op_ret != OPRT_OK) {
+        tal_free(drv->last_frame);
+        tal_free(drv);
+        tdd_pixel_spi_port_release(cfg->port);
+        return op_ret;
+    }
+    __apa102_head_fill(drv);
+
+    extern void tkl_spi_set_spic_flag(void);
+    tkl_spi_set_spic_flag();
+    spi_cfg.role = TUYA_SPI_ROLE_MASTER;
+    spi_cfg.mode = TUYA_SPI_MODE0;
+    spi_cfg.type = TUYA_SPI_SOFT_TYPE;
+    spi_cfg.databits = TUYA_SPI_DATA_BIT8;
+    spi_cfg.freq_hz = APA102_SPI_SPEED;
+    spi_cfg.spi_dma_flags = TRUE;
+    op_ret = tkl_spi_init(drv->cfg.port, &spi_cfg);
+    if (op_ret != OPRT_OK) {
+        TAL_PR_ERR("tkl_spi_init fail op_ret:%d", op_ret);
+        tdd_pixel_tx_ctrl_release(drv->tx_ctrl);
+        tal_free(drv->last_frame);
+        tal_free(drv);
+        tdd_pixel_spi_port_release(cfg->port);
+        return op_ret;
+    }
+
+    *handle = drv;
+
+    return OPRT_OK;
+}
+
+/**
+ * @function:tdd_apa102_driver_open
+ * @brief: 按tdd_apa102_driver_register注册的配置打开（初始化）设备
+ * @param[in]: pixel_num -> 像素点数
+ * @param[out]: *handle  -> 设备句柄
+ * @return: success -> 0  fail -> else
+ */
+OPERATE_RET tdd_apa102_driver_open(OUT DRIVER_HANDLE_T *handle, IN unsigned short pixel_num)
+{
+    return tdd_apa102_driver_open_cfg(handle, pixel_num, &driver_info);
+}
+
+/**
+ * @function: tdd_apa102_driver_send_frame
+ * @brief: 将打包的8位颜色帧按线序写入发送缓存并通过SPI发送，与上一帧相同时跳过发送
+ * @param[in]: handle -> 设备句柄
+ * @param[in]: *frame -> 颜色帧，像素数超过设备像素点数时截断，RGBW帧忽略白色通道
+ * @return: success -> 0  fail -> else
+ */
+OPERATE_RET tdd_apa102_driver_send_frame(IN DRIVER_HANDLE_T handle, IN const PIXEL_FRAME_T *frame)
+{
+    DRV_APA102_HANDLE_T *drv = NULL;
+    unsigned int pixel_cnt = 0, encoded = 0;
+    unsigned long long start = 0;
+
+    if (NULL == handle || NULL == frame || NULL == frame->data || 0 == frame->pixel_num ||
+        frame->fmt > PIXEL_FRAME_FMT_RGBW8888) {
+        return OPRT_INVALID_PARM;
+    }
+
+    drv = (DRV_APA102_HANDLE_T *)handle;
+    if (drv->color_dirty) {
+        __apa102_color_table_update(drv);
+    }
+
+    pixel_cnt = (frame->pixel_num > drv->pixel_num) ? drv->pixel_num : frame->pixel_num;
+
+    start = PIXEL_PERF_NOW_US();
+    encoded = __apa102_encode(drv, frame->data, PIXEL_FRAME_BYTES_PER_PIXEL(frame->fmt), pixel_cnt);
+    tdd_pixel_perf_record_us(&drv->perf.encode_us, (unsigned int)(PIXEL_PERF_NOW_US() - start));
+    drv->stats.pixels_encoded += encoded;
+
+    /* 截断的帧之后的像素保持上一帧的数据 */
+    if (drv->frame_valid && drv->sent_valid && 0 == encoded) {
+        drv->stats.frames_skipped++;
+        PIXEL_TRACE(PIXEL_TRACE_FRAME_SKIP, drv->cfg.port, 0, 0);
+        if (drv->done_cb) {
+            drv->done_cb((DRIVER_HANDLE_T)drv, OPRT_OK, drv->done_arg);
+        }
+        return OPRT_OK;
+    }
+    drv->frame_valid = TRUE;
+
+    return __apa102_frame_submit(drv);
+}
+
+/**
+ * @function: tdd_apa102_driver_send_data
+ * @brief: 16位颜色数据接口，转换为打包帧后按tdd_apa102_driver_send_frame发送，
+ *         每个颜色分量只取低8位
+ * @param[in]: handle -> 设备句柄
+ * @param[in]: *data_buf -> 颜色数据（R、G、B）
+ * @param[in]: buf_len -> 颜色数据长度
+ * @return: success -> 0  fail -> else
+ */
+OPERATE_RET tdd_apa102_driver_send_data(IN DRIVER_HANDLE_T handle, IN unsigned short *data_buf, IN unsigned int buf_len)
+{
+    DRV_APA102_HANDLE_T *drv = NULL;
+    PIXEL_FRAME_T frame = {0};
+    unsigned int i = 0, len = 0;
+
+    if (NULL == handle || NULL == data_buf || buf_len < COLOR_PRIMARY_NUM) {
+        return OPRT_INVALID_PARM;
+    }
+
+    drv = (DRV_APA102_HANDLE_T *)handle;
+    if (NULL == drv->shim_buf) {
+        drv->shim_buf = (unsigned char *)tal_malloc(COLOR_PRIMARY_NUM * drv->pixel_num);
+        if (NULL == drv->shim_buf) {
+            return OPRT_MALLOC_FAILED;
+        }
+    }
+
+    frame.fmt = PIXEL_FRAME_FMT_RGB888;
+    frame.pixel_num = (buf_len / COLOR_PRIMARY_NUM > drv->pixel_num) ? drv->pixel_num :
+                      (unsigned short)(buf_len / COLOR_PRIMARY_NUM);
+    frame.data = drv->shim_buf;
+
+    len = frame.pixel_num * COLOR_PRIMARY_NUM;
+    for (i = 0; i < len; i++) {
+        drv->shim_buf[i] = (unsigned char)data_buf[i];
+    }
+
+    return tdd_apa102_driver_send_frame(handle, &frame);
+}
+
+/**
+ * @function: tdd_apa102_driver_close
+ * @brief: 关闭设备（资源释放）
+ * @param[in]: *handle -> 设备句柄
+ * @return: success -> 0  fail -> else
+ */
+OPERATE_RET tdd_apa102_driver_close(IN DRIVER_HANDLE_T *handle)
+{
+    OPERATE_RET ret = OPRT_OK;
+    DRV_APA102_HANDLE_T *drv = NULL;
+
+    if ((NULL == handle) || (*handle == NULL)) {
+        return OPRT_INVALID_PARM;
+    }
+
+    drv = (DRV_APA102_HANDLE_T *)(*handle);
+
+    ret = tkl_spi_deinit(drv->cfg.port);
+    if (ret != OPRT_OK) {
+        TAL_PR_ERR("spi deinit err:%d", ret);
+    }
+    tdd_pixel_spi_port_release(drv->cfg.port);
+    tdd_pixel_tx_ctrl_release(drv->tx_ctrl);
+    tal_free(drv->last_frame);
+    if (drv->shim_buf) {
+        tal_free(drv->shim_buf);
+    }
+    tal_free(drv);
+    *handle = NULL;
+
+    return ret;
+}
+
+/**
+ * @function: tdd_apa102_driver_config
+ * @brief: 设备配置，发送为同步方式，DRV_CMD_SET_ASYNC_MODE及WS2812编码相关的命令不支持
+ * @param[in]: handle -> 设备句柄
+ * @param[in]: cmd -> 配置命令
+ * @param[inout]: arg -> 命令参数
+ * @return: success -> 0  fail -> else
+ */
+OPERATE_RET tdd_apa102_driver_config(IN DRIVER_HANDLE_T handle, IN unsigned char cmd, INOUT void *arg)
+{
+    DRV_APA102_HANDLE_T *drv = NULL;
+    PIXEL_FRAME_DONE_CFG_T *done_cfg = NULL;
+    PIXEL_COLOR_CORRECTION_T *cc = NULL;
+
+    if (NULL == handle) {
+        return OPRT_INVALID_PARM;
+    }
+
+    drv = (DRV_APA102_HANDLE_T *)handle;
+
+    switch (cmd) {
+        case DRV_CMD_SET_RGB_ORDER_CFG:
+            if (NULL == arg || *(RGB_ORDER_MODE_E *)arg > BGR_ORDER) {
+                return OPRT_INVALID_PARM;
+            }
+            drv->cfg.line_seq = *(RGB_ORDER_MODE_E *)arg;
+            __apa102_line_seq_update(drv);
+            break;
+
+        case DRV_CMD_SET_COLOR_CORRECTION:
+            cc = (PIXEL_COLOR_CORRECTION_T *)arg;
+            if (NULL == cc || 0 == cc->gamma_x10) {
+                return OPRT_INVALID_PARM;
+            }
+            memcpy(&drv->color_cfg, cc, sizeof(PIXEL_COLOR_CORRECTION_T));
+            drv->color_dirty = TRUE;
+            break;
+
+        case DRV_CMD_GET_COLOR_CORRECTION:
+            if (NULL == arg) {
+                return OPRT_INVALID_PARM;
+            }
+            memcpy(arg, &drv->color_cfg, sizeof(PIXEL_COLOR_CORRECTION_T));
+            break;
+
+        case DRV_CMD_SET_BRIGHTNESS:
+            if (NULL == arg) {
+                return OPRT_INVALID_PARM;
+            }
+            if (drv->color_cfg.brightness != *(unsigned char *)arg) {
+                drv->color_cfg.brightness = *(unsigned char *)arg;
+                drv->color_dirty = TRUE;
+            }
+            break;
+
+        case DRV_CMD_SET_GLOBAL_CURRENT:
+            if (NULL == arg || *(unsigned char *)arg > APA102_GLOBAL_CURRENT_MAX) {
+                return OPRT_INVALID_PARM;
+            }
+            /* 像素头与颜色映射表在下一帧编码前按新上限重新换算 */
+            if (drv->global != *(unsigned char *)arg) {
+                drv->global = *(unsigned char *)arg;
+                drv->color_dirty = TRUE;
+            }
+            break;
+
+        case DRV_CMD_GET_TX_STATS:
+            if (NULL == arg) {
+                return OPRT_INVALID_PARM;
+            }
+            memcpy(arg, &drv->stats, sizeof(PIXEL_DRV_TX_STATS_T));
+            break;
+
+        case DRV_CMD_RESET_TX_STATS:
+            memset(&drv->stats, 0, sizeof(PIXEL_DRV_TX_STATS_T));
+            memset(&drv->perf, 0, sizeof(PIXEL_DRV_PERF_STATS_T));
+            break;
+
+        case DRV_CMD_GET_PERF_STATS:
+            if (NULL == arg) {
+                return OPRT_INVALID_PARM;
+            }
+            memcpy(arg, &drv->perf, sizeof(PIXEL_DRV_PERF_STATS_T));
+            break;
+
+        case DRV_CMD_SET_FRAME_DONE_CB:
+            done_cfg = (PIXEL_FRAME_DONE_CFG_T *)arg;
+            drv->done_cb = (NULL == done_cfg) ? NULL : done_cfg->cb;
+            drv->done_arg = (NULL == done_cfg) ? NULL : done_cfg->arg;
+            break;
+
+        default:
+            return OPRT_NOT_SUPPORTED;
+    }
+
+    return OPRT_OK;
+}
+
+/**
+ * @function:tdd_apa102_driver_register
+ * @brief: 注册设备配置，供之后的tdd_apa102_driver_open使用，已打开的句柄不受影响
+ * @param[in]: init_param -> 设备配置
+ * @return: success -> OPRT_OK
+ */
+OPERATE_RET tdd_apa102_driver_register(IN PIXEL_DRIVER_CONFIG_T *init_param)
+{
+    if (NULL == init_param || !__apa102_cfg_valid(init_param)) {
+        return OPRT_INVALID_PARM;
+    }
+    memcpy(&driver_info, init_param, sizeof(PIXEL_DRIVER_CONFIG_T));
+    return OPRT_OK;
+}
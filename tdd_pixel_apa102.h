@@ -0,0 +1,86 @@
+/**
+ * @file tdd_pixel_apa102.h
+ * @author www.tuya.com
+ * @brief tdd_pixel_apa102 module is used to drive clocked APA102/SK9822 strips over SPI
+ *
+ * 时钟+数据两线制，SPI字节直接作为像素数据发送，不做位扩展：
+ *   起始帧 4 字节 0x00 | 每像素 4 字节 (0xE0 | 5位全局电流) + 3 字节颜色（按线序） | 结束帧
+ * 结束帧为 0x00，长度按像素数补足数据在灯带中逐级传递所需的时钟（每16个像素1字节），
+ * SK9822另需4字节复位帧。每像素发送缓存为4字节，约为WS2812 8位码型的1/6。
+ * 全局亮度先换算为5位全局电流（以DRV_CMD_SET_GLOBAL_CURRENT为上限，向上取整），
+ * 电流级之间的余量再按比例缩放颜色，低亮度时颜色仍保留完整的8位分辨率。
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+
+#ifndef __TDD_PIXEL_APA102_H__
+#define __TDD_PIXEL_APA102_H__
+
+#include "tdd_pixel_type.h"
+#include "tdl_pixel_driver.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************************************************************
+******************************macro define****************************
+*********************************************************************/
+/* 像素5位全局电流的最大值，打开设备时的默认上限 */
+#define APA102_GLOBAL_CURRENT_MAX 31
+
+/*********************************************************************
+****************************typedef define****************************
+*********************************************************************/
+
+/*********************************************************************
+****************************variable define***************************
+*********************************************************************/
+
+/*********************************************************************
+****************************function define***************************
+*********************************************************************/
+/**
+ * @brief  注册设备配置，供之后的tdd_apa102_driver_open使用
+ *
+ * @param[in] init_param 设备配置（端口、线序、芯片），chip为PIXEL_CHIP_APA102或PIXEL_CHIP_SK9822，
+ *                       code_mode不使用，chan_num只支持3
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_apa102_driver_register(IN PIXEL_DRIVER_CONFIG_T *init_param);
+
+/**
+ * @brief  按注册的配置打开设备
+ *
+ * @param[out] handle 设备句柄
+ * @param[in] pixel_num 像素点数
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_apa102_driver_open(OUT DRIVER_HANDLE_T *handle, IN unsigned short pixel_num);
+
+/**
+ * @brief  按指定配置打开设备，同一SPI端口只能被一个句柄打开
+ *
+ * @param[out] handle 设备句柄
+ * @param[in] pixel_num 像素点数
+ * @param[in] cfg 设备配置，拷贝到句柄中
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_apa102_driver_open_cfg(OUT DRIVER_HANDLE_T *handle, IN unsigned short pixel_num,
+                                       IN PIXEL_DRIVER_CONFIG_T *cfg);
+
+OPERATE_RET tdd_apa102_driver_close(IN DRIVER_HANDLE_T *handle);
+
+OPERATE_RET tdd_apa102_driver_send_data(IN DRIVER_HANDLE_T handle, IN unsigned short *data_buf, IN unsigned int buf_len);
+
+OPERATE_RET tdd_apa102_driver_send_frame(IN DRIVER_HANDLE_T handle, IN const PIXEL_FRAME_T *frame);
+
+OPERATE_RET tdd_apa102_driver_config(IN DRIVER_HANDLE_T handle, IN unsigned char cmd, INOUT void *arg);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /*__TDD_PIXEL_APA102_H__*/
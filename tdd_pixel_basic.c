@@ -10,7 +10,10 @@
  */
 #include <string.h>
 
+#include "tal_log.h"
 #include "tal_memory.h"
+#include "tal_system.h"
+#include "tkl_timer.h"
 
 #include "tdd_pixel_basic.h"
 
@@ -19,6 +22,15 @@
 ***********************************************************/
 #define COLOR_PRIMARY_MAX            5
 
+/* 性能计时定时器周期，两次计时的间隔不超过一个周期才能正确展开为64位时间 */
+#define PIXEL_PERF_TIMER_PERIOD_US   1000000000u
+
+/* 性能计时定时器状态 */
+#define PERF_TIMER_IDLE              0
+#define PERF_TIMER_STARTING          1
+#define PERF_TIMER_READY             2
+#define PERF_TIMER_FAILED            3
+
 /***********************************************************
 ***********************typedef define***********************
 ***********************************************************/
@@ -26,32 +38,143 @@
 /***********************************************************
 ***********************variable define**********************
 ***********************************************************/
+/* 已被像素驱动打开的SPI端口，WS2812与APA102驱动共用，临界区内访问 */
+static unsigned int spi_port_used = 0;
+
+/* tdd_rgb_transform_spi_data使用的8位码型查找表，首次调用时申请，0/1码变化时重建 */
+static DRV_PIXEL_SPI_TABLE_T *compat_table = NULL;
+static unsigned char compat_code[2] = {0, 0};
+
+#if (PIXEL_PERF_TIMER_ID != PIXEL_PERF_TIMER_NONE)
+/* 性能计时定时器：状态原子访问，展开用的上次读数与累计周期在临界区内访问 */
+static unsigned char perf_timer_state = PERF_TIMER_IDLE;
+static unsigned int perf_timer_last = 0;
+static unsigned long long perf_timer_base = 0;
+#endif
+/* 各线序下线序第i个分量对应的R、G、B下标 */
+static const unsigned char line_seq_idx_tbl[][3] = {
+    [RGB_ORDER] = {0, 1, 2},
+    [RBG_ORDER] = {0, 2, 1},
+    [GRB_ORDER] = {1, 0, 2},
+    [GBR_ORDER] = {1, 2, 0},
+    [BRG_ORDER] = {2, 0, 1},
+    [BGR_ORDER] = {2, 1, 0},
+};
 
 
 /***********************************************************
 ***********************function define**********************
 ***********************************************************/
 /**
-* @brief       rgb转成spi数据
+* @brief       按0/1码生成颜色值到SPI码型的查找表
+*
+* @param[in]   chip_ic_0           0码（低code_bits位有效）
+* @param[in]   chip_ic_1           1码（低code_bits位有效）
+* @param[in]   code_bits           每个数据位占用的SPI位数，1~8
+* @param[out]  table               生成的查找表
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdd_pixel_spi_table_init(unsigned char chip_ic_0, unsigned char chip_ic_1, unsigned char code_bits,
+                                     DRV_PIXEL_SPI_TABLE_T *table)
+{
+    unsigned int value = 0, i = 0, bit_pos = 0;
+    unsigned char code = 0;
+    signed char k = 0;
+
+    if (NULL == table || 0 == code_bits || code_bits > ONE_BYTE_LEN) {
+        return OPRT_INVALID_PARM;
+    }
+
+    memset(table, 0, sizeof(DRV_PIXEL_SPI_TABLE_T));
+    table->code_len = code_bits;
+
+    /* 8个数据位依次展开为code_bits位的码型，高位在前紧密排列 */
+    for (value = 0; value < SPI_CODE_TABLE_SIZE; value++) {
+        bit_pos = 0;
+        for (i = 0; i < ONE_BYTE_LEN; i++) {
+            code = (value & (0x80 >> i)) ? chip_ic_1 : chip_ic_0;
+            for (k = code_bits - 1; k >= 0; k--, bit_pos++) {
+                if (code & (1 << k)) {
+                    table->code[value].byte[bit_pos / ONE_BYTE_LEN] |= 0x80 >> (bit_pos % ONE_BYTE_LEN);
+                }
+            }
+        }
+    }
+
+    return OPRT_OK;
+}
+
+/**
+* @brief       将颜色映射表折叠进SPI码型查找表：out->code[v] = base->code[lut[v]]
+*
+* @param[in]   base                tdd_pixel_spi_table_init生成的查找表
+* @param[in]   lut                 256项颜色映射表
+* @param[out]  out                 生成的查找表，编码时直接以原始颜色值查表
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdd_pixel_spi_table_remap(const DRV_PIXEL_SPI_TABLE_T *base, const unsigned char *lut,
+                                      DRV_PIXEL_SPI_TABLE_T *out)
+{
+    unsigned int value = 0;
+
+    if (NULL == base || NULL == lut || NULL == out) {
+        return OPRT_INVALID_PARM;
+    }
+
+    out->code_len = base->code_len;
+    for (value = 0; value < SPI_CODE_TABLE_SIZE; value++) {
+        out->code[value] = base->code[lut[value]];
+    }
+
+    return OPRT_OK;
+}
+
+/**
+* @brief       rgb转成spi数据，每个数据位输出一个字节的0/1码（兼容接口）
+*
+* 按tdd_pixel_spi_table_init生成的8位码型查找表查表输出，查表结果与逐位展开相同；
+* 查找表在首次调用时申请，0/1码变化时重建，不可重入。申请失败时逐位展开
 *
 * @param[in]   color_data          颜色数据
 * @param[in]   chip_ic_0           0码
 * @param[in]   chip_ic_1           1码
-* @param[out]  spi_data_buf        转化后的spi数据
+* @param[out]  spi_data_buf        转化后的spi数据，8字节
 *
 * @return none
 */
-void tdd_rgb_transform_spi_data(unsigned char color_data, unsigned char chip_ic_0, \
-                                         unsigned char chip_ic_1,  unsigned char *spi_data_buf)
+void tdd_rgb_transform_spi_data(unsigned char color_data, unsigned char chip_ic_0, unsigned char chip_ic_1,
+                                unsigned char *spi_data_buf)
 {
-    unsigned char i = 0; 
-    
-    for (i = 0; i < 8; i++) {
-        spi_data_buf[i] =  (color_data & 0x80) ? chip_ic_1 : chip_ic_0;
-        color_data <<= 1;       
+    unsigned char i = 0;
+
+    if (NULL == spi_data_buf) {
+        return;
     }
 
-    return;
+    if (NULL == compat_table) {
+        compat_table = (DRV_PIXEL_SPI_TABLE_T *)tal_malloc(sizeof(DRV_PIXEL_SPI_TABLE_T));
+        if (compat_table) {
+            tdd_pixel_spi_table_init(chip_ic_0, chip_ic_1, ONE_BYTE_LEN, compat_table);
+            compat_code[0] = chip_ic_0;
+            compat_code[1] = chip_ic_1;
+        }
+    } else if (compat_code[0] != chip_ic_0 || compat_code[1] != chip_ic_1) {
+        tdd_pixel_spi_table_init(chip_ic_0, chip_ic_1, ONE_BYTE_LEN, compat_table);
+        compat_code[0] = chip_ic_0;
+        compat_code[1] = chip_ic_1;
+    }
+
+    if (compat_table) {
+        memcpy(spi_data_buf, compat_table->code[color_data].byte, ONE_BYTE_LEN);
+        return;
+    }
+
+    for (i = 0; i < ONE_BYTE_LEN; i++) {
+        spi_data_buf[i] = (color_data & 0x80) ? chip_ic_1 : chip_ic_0;
+        color_data <<= 1;
+    }
 }
 
 /**
@@ -111,6 +234,150 @@ OPERATE_RET tdd_rgb_line_seq_transform(unsigned short *data_buf, unsigned short
     return OPRT_OK;
 }
 
+/**
+* @brief        获取线序对应的颜色下标：线序第i个分量为R、G、B中的第seq_idx[i]个
+*
+* @param[in]   rgb_order            颜色线序
+* @param[out]  seq_idx              3个下标
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdd_rgb_line_seq_index(RGB_ORDER_MODE_E rgb_order, unsigned char *seq_idx)
+{
+    if (NULL == seq_idx || rgb_order > BGR_ORDER) {
+        return OPRT_INVALID_PARM;
+    }
+
+    memcpy(seq_idx, line_seq_idx_tbl[rgb_order], sizeof(line_seq_idx_tbl[0]));
+
+    return OPRT_OK;
+}
+
+/**
+* @brief      计算帧间复位（锁存）低电平对应的SPI零字节数
+*
+* @param[in]   spi_freq            SPI波特率
+* @param[in]   reset_us            复位时间
+*
+* @return 字节数，向上取整
+*/
+unsigned int tdd_pixel_reset_bytes(unsigned int spi_freq, unsigned int reset_us)
+{
+    unsigned long long bits_x1m = (unsigned long long)spi_freq * reset_us;
+
+    return (unsigned int)((bits_x1m + 8 * 1000000ULL - 1) / (8 * 1000000ULL));
+}
+
+/**
+* @brief      通过SPI发送数据，超过单次发送上限时分段连续发送
+*
+* 分段之间的间隔超过芯片复位时间时单线灯带会在帧中间锁存，见头文件说明
+*
+* @param[in]   port                SPI端口
+* @param[in]   buf                 发送数据
+* @param[in]   len                 发送长度
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdd_pixel_spi_send(TUYA_SPI_NUM_E port, unsigned char *buf, unsigned int len)
+{
+    OPERATE_RET ret = OPRT_OK;
+    unsigned int send_len = 0;
+
+    if (NULL == buf) {
+        return OPRT_INVALID_PARM;
+    }
+
+    while (len > 0) {
+        send_len = (len > PIXEL_SPI_SEND_MAX) ? PIXEL_SPI_SEND_MAX : len;
+        ret = tkl_spi_send(port, buf, (UINT16_T)send_len);
+        if (ret != OPRT_OK) {
+            return ret;
+        }
+        buf += send_len;
+        len -= send_len;
+    }
+
+    return OPRT_OK;
+}
+
+/**
+* @brief      SPI端口是否支持无间隔的重复块发送，平台支持链式DMA时重新实现
+*
+* @param[in]   port                SPI端口
+*
+* @return TRUE为支持
+*/
+__attribute__((weak)) BOOL_T tdd_pixel_spi_repeat_supported(TUYA_SPI_NUM_E port)
+{
+    (void)port;
+
+    return FALSE;
+}
+
+/**
+* @brief      以一次连续传输发送重复块与tail，平台支持链式DMA时重新实现
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+__attribute__((weak)) OPERATE_RET tdd_pixel_spi_send_repeat(TUYA_SPI_NUM_E port, const unsigned char *pattern,
+                                                            unsigned int pattern_len, unsigned int total_len,
+                                                            const unsigned char *tail, unsigned int tail_len)
+{
+    (void)port;
+    (void)pattern;
+    (void)pattern_len;
+    (void)total_len;
+    (void)tail;
+    (void)tail_len;
+
+    return OPRT_NOT_SUPPORTED;
+}
+
+/**
+* @brief      占用SPI端口，同一端口同时只能被一个像素设备（任一驱动）打开
+*
+* @param[in]   port                SPI端口
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdd_pixel_spi_port_claim(TUYA_SPI_NUM_E port)
+{
+    OPERATE_RET ret = OPRT_OK;
+
+    if (port >= TUYA_SPI_NUM_MAX) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_system_enter_critical();
+    if (spi_port_used & (1u << port)) {
+        ret = OPRT_COM_ERROR;
+    } else {
+        spi_port_used |= (1u << port);
+    }
+    tal_system_exit_critical();
+
+    return ret;
+}
+
+/**
+* @brief      释放tdd_pixel_spi_port_claim占用的SPI端口
+*
+* @param[in]   port                SPI端口
+*
+* @return none
+*/
+void tdd_pixel_spi_port_release(TUYA_SPI_NUM_E port)
+{
+    if (port >= TUYA_SPI_NUM_MAX) {
+        return;
+    }
+
+    tal_system_enter_critical();
+    spi_port_used &= ~(1u << port);
+    tal_system_exit_critical();
+}
+
 /**
 * @brief      创建存放发送控制参数的缓存
 *
@@ -161,6 +428,177 @@ OPERATE_RET tdd_pixel_tx_ctrl_release(IN DRV_PIXEL_TX_CTRL_T *tx_ctrl)
 	return OPRT_OK;
 }
 
+#if (PIXEL_PERF_TIMER_ID != PIXEL_PERF_TIMER_NONE)
+static void __perf_timer_isr(void *args)
+{
+    (void)args;
+}
+#endif
+
+/**
+* @brief      初始化性能计时：配置了PIXEL_PERF_TIMER_ID时启动硬件定时器，启动期间计时使用毫秒时钟
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdd_pixel_perf_init(void)
+{
+#if (PIXEL_PERF_TIMER_ID != PIXEL_PERF_TIMER_NONE)
+    TUYA_TIMER_BASE_CFG_T cfg = {
+        .mode = TUYA_TIMER_MODE_PERIOD,
+        .cb = __perf_timer_isr,
+        .args = NULL,
+    };
+    unsigned char state = PERF_TIMER_IDLE;
+    OPERATE_RET ret = OPRT_OK;
+
+    if (!__atomic_compare_exchange_n(&perf_timer_state, &state, PERF_TIMER_STARTING, FALSE,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+        return (PERF_TIMER_FAILED == state) ? OPRT_COM_ERROR : OPRT_OK;
+    }
+
+    /* 从当前毫秒时间接续，切换时钟时计时不回退 */
+    perf_timer_base = (unsigned long long)tal_system_get_millisecond() * 1000ULL;
+    perf_timer_last = 0;
+    state = PERF_TIMER_FAILED;
+    ret = tkl_timer_init(PIXEL_PERF_TIMER_ID, &cfg);
+    if (OPRT_OK == ret) {
+        ret = tkl_timer_start(PIXEL_PERF_TIMER_ID, PIXEL_PERF_TIMER_PERIOD_US);
+        if (OPRT_OK == ret) {
+            state = PERF_TIMER_READY;
+        } else {
+            tkl_timer_deinit(PIXEL_PERF_TIMER_ID);
+        }
+    }
+    __atomic_store_n(&perf_timer_state, state, __ATOMIC_RELEASE);
+    if (ret != OPRT_OK) {
+        TAL_PR_WARN("perf timer %d start err:%d, use ms clock", PIXEL_PERF_TIMER_ID, ret);
+    }
+
+    return ret;
+#else
+    return OPRT_OK;
+#endif
+}
+
+/**
+* @brief      性能计时时钟，硬件定时器不可用时为系统毫秒时钟
+*
+* @return 微秒
+*/
+__attribute__((weak)) unsigned long long tdd_pixel_perf_now_us(void)
+{
+#if (PIXEL_PERF_TIMER_ID != PIXEL_PERF_TIMER_NONE)
+    unsigned long long now = 0;
+    unsigned int cnt = 0;
+    OPERATE_RET ret = OPRT_OK;
+
+    if (PERF_TIMER_READY == __atomic_load_n(&perf_timer_state, __ATOMIC_ACQUIRE)) {
+        /* 读数与展开在同一临界区内，多线程计时不会把先读的较小值误判为回绕 */
+        tal_system_enter_critical();
+        ret = tkl_timer_get(PIXEL_PERF_TIMER_ID, &cnt);
+        if (OPRT_OK == ret) {
+            if (cnt < perf_timer_last) {
+                perf_timer_base += PIXEL_PERF_TIMER_PERIOD_US;
+            }
+            perf_timer_last = cnt;
+            now = perf_timer_base + cnt;
+        }
+        tal_system_exit_critical();
+        if (OPRT_OK == ret) {
+            return now;
+        }
+    }
+#endif
+
+    return (unsigned long long)tal_system_get_millisecond() * 1000ULL;
+}
+
+/**
+* @brief      获取性能计时精度
+*
+* @return 一个计时单位对应的微秒数
+*/
+__attribute__((weak)) unsigned int tdd_pixel_perf_tick_us(void)
+{
+#if (PIXEL_PERF_TIMER_ID != PIXEL_PERF_TIMER_NONE)
+    if (PERF_TIMER_READY == __atomic_load_n(&perf_timer_state, __ATOMIC_ACQUIRE)) {
+        return 1;
+    }
+#endif
+
+    return 1000;
+}
+
+/**
+* @brief      记录一次采样，直方图按bucket_value分桶
+*/
+static void __perf_record(PIXEL_PERF_METRIC_T *metric, unsigned int value, unsigned int bucket_value)
+{
+    unsigned int bucket = 0;
+
+    if (NULL == metric) {
+        return;
+    }
+
+    if (0 == metric->count || value < metric->min) {
+        metric->min = value;
+    }
+    if (value > metric->max) {
+        metric->max = value;
+    }
+    metric->count++;
+    metric->sum += value;
+
+    while (bucket_value && bucket < PIXEL_PERF_HIST_NUM - 1) {
+        bucket_value >>= 1;
+        bucket++;
+    }
+    metric->hist[bucket]++;
+}
+
+/**
+* @brief      记录一次性能采样：更新次数、最小/最大/累计值与对数直方图
+*
+* @param[in]   metric              性能计数
+* @param[in]   value               采样值
+*
+* @return none
+*/
+void tdd_pixel_perf_record(PIXEL_PERF_METRIC_T *metric, unsigned int value)
+{
+    __perf_record(metric, value, value);
+}
+
+/**
+* @brief      记录一次PIXEL_PERF_NOW_US计时的采样，直方图按计时单位分桶
+*
+* @param[in]   metric              性能计数
+* @param[in]   us                  耗时（微秒）
+*
+* @return none
+*/
+void tdd_pixel_perf_record_us(PIXEL_PERF_METRIC_T *metric, unsigned int us)
+{
+    /* 毫秒时钟下没有亚毫秒的桶 */
+    __perf_record(metric, us, us / tdd_pixel_perf_tick_us());
+}
+
+/**
+* @brief      获取性能计数的平均值
+*
+* @param[in]   metric              性能计数
+*
+* @return 平均值，无采样时为0
+*/
+unsigned int tdd_pixel_perf_avg(const PIXEL_PERF_METRIC_T *metric)
+{
+    if (NULL == metric || 0 == metric->count) {
+        return 0;
+    }
+
+    return (unsigned int)(metric->sum / metric->count);
+}
+
 /**
 * @brief      BK 平台 SPI 驱动幻彩灯带需要特殊处理，这里为了能够跨平台实现该接口
 *
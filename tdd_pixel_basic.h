@@ -22,10 +22,34 @@ extern "C" {
 ************************macro define************************
 ***********************************************************/
 #define ONE_BYTE_LEN 8
+#define SPI_CODE_TABLE_SIZE 256
+/* tkl_spi_send单次发送长度上限（UINT16_T），超过时分段发送，见tdd_pixel_spi_send */
+#define PIXEL_SPI_SEND_MAX  0xFFFF
+
+/* 性能计时，返回微秒，实际精度见tdd_pixel_perf_tick_us */
+#define PIXEL_PERF_NOW_US()  tdd_pixel_perf_now_us()
+
+/* 性能计时使用的硬件定时器，默认不占用（只使用系统毫秒时钟）；在编译选项中定义为空闲的定时器
+ * （如TUYA_TIMER_NUM_3）开启微秒计时，由tdd_pixel_perf_init以周期模式启动，tkl_timer_get读取周期内已计时的微秒数 */
+#define PIXEL_PERF_TIMER_NONE        0xFF
+#ifndef PIXEL_PERF_TIMER_ID
+#define PIXEL_PERF_TIMER_ID          PIXEL_PERF_TIMER_NONE
+#endif
 
 /***********************************************************
 ***********************typedef define***********************
 ***********************************************************/
+/* 单个颜色字节对应的SPI码型，按字节填充，按字写入 */
+typedef union {
+    unsigned char byte[ONE_BYTE_LEN];
+    unsigned int  word[ONE_BYTE_LEN / sizeof(unsigned int)];
+} DRV_PIXEL_SPI_CODE_T;
+
+/* 颜色值 -> SPI码型 查找表 */
+typedef struct {
+    unsigned char code_len;     // 每个颜色字节编码后的SPI字节数（等于每个数据位的SPI位数）
+    DRV_PIXEL_SPI_CODE_T code[SPI_CODE_TABLE_SIZE];
+} DRV_PIXEL_SPI_TABLE_T;
 
 typedef struct {
     unsigned char *tx_buffer;   // 数据 -> 数据流转换成SPI数据后的buf
@@ -36,18 +60,98 @@ typedef struct {
 ********************function declaration********************
 ***********************************************************/
 /**
- * @brief       rgb转成spi数据
+ * @brief       按0/1码生成颜色值到SPI码型的查找表
+ *
+ * @param[in]   chip_ic_0           0码（低code_bits位有效）
+ * @param[in]   chip_ic_1           1码（低code_bits位有效）
+ * @param[in]   code_bits           每个数据位占用的SPI位数，1~8
+ * @param[out]  table               生成的查找表
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_spi_table_init(unsigned char chip_ic_0, unsigned char chip_ic_1, unsigned char code_bits,
+                                     DRV_PIXEL_SPI_TABLE_T *table);
+
+/**
+ * @brief       将颜色映射表折叠进SPI码型查找表：out->code[v] = base->code[lut[v]]
+ *
+ * @param[in]   base                tdd_pixel_spi_table_init生成的查找表
+ * @param[in]   lut                 256项颜色映射表
+ * @param[out]  out                 生成的查找表，编码时直接以原始颜色值查表
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_spi_table_remap(const DRV_PIXEL_SPI_TABLE_T *base, const unsigned char *lut,
+                                      DRV_PIXEL_SPI_TABLE_T *out);
+
+/**
+ * @brief       rgb转成spi数据，每个数据位输出一个字节的0/1码
+ *
+ * 兼容接口，内部按8位码型查找表输出；新代码使用tdd_pixel_spi_table_init与tdd_rgb_transform_spi_data_lut
  *
  * @param[in]   color_data          颜色数据
  * @param[in]   chip_ic_0           0码
  * @param[in]   chip_ic_1           1码
- * @param[out]  spi_data_buf        转化后的spi数据
+ * @param[out]  spi_data_buf        转化后的spi数据，8字节
  *
  * @return none
  */
 void tdd_rgb_transform_spi_data(unsigned char color_data, unsigned char chip_ic_0, unsigned char chip_ic_1,
                                 unsigned char *spi_data_buf);
 
+/**
+ * @brief       查表将rgb转成spi数据，8位码型（无分支，按字写入）
+ *
+ * @param[in]   table               tdd_pixel_spi_table_init生成的查找表
+ * @param[in]   color_data          颜色数据
+ * @param[out]  spi_data_buf        转化后的spi数据，需4字节对齐
+ *
+ * @return none
+ */
+static inline void tdd_rgb_transform_spi_data_lut(const DRV_PIXEL_SPI_TABLE_T *table, unsigned char color_data,
+                                                  unsigned char *spi_data_buf)
+{
+    const unsigned int *src = table->code[color_data].word;
+    unsigned int *dst = (unsigned int *)spi_data_buf;
+
+    dst[0] = src[0];
+    dst[1] = src[1];
+}
+
+/**
+ * @brief       查表将rgb转成spi数据，4位码型（单字写入）
+ *
+ * @param[in]   table               tdd_pixel_spi_table_init生成的查找表
+ * @param[in]   color_data          颜色数据
+ * @param[out]  spi_data_buf        转化后的spi数据，需4字节对齐
+ *
+ * @return none
+ */
+static inline void tdd_rgb_transform_spi_data_lut4(const DRV_PIXEL_SPI_TABLE_T *table, unsigned char color_data,
+                                                   unsigned char *spi_data_buf)
+{
+    *(unsigned int *)spi_data_buf = table->code[color_data].word[0];
+}
+
+/**
+ * @brief       查表将rgb转成spi数据，3位码型（3字节写入，无对齐要求）
+ *
+ * @param[in]   table               tdd_pixel_spi_table_init生成的查找表
+ * @param[in]   color_data          颜色数据
+ * @param[out]  spi_data_buf        转化后的spi数据
+ *
+ * @return none
+ */
+static inline void tdd_rgb_transform_spi_data_lut3(const DRV_PIXEL_SPI_TABLE_T *table, unsigned char color_data,
+                                                   unsigned char *spi_data_buf)
+{
+    const unsigned char *src = table->code[color_data].byte;
+
+    spi_data_buf[0] = src[0];
+    spi_data_buf[1] = src[1];
+    spi_data_buf[2] = src[2];
+}
+
 /**
  * @brief        调整颜色线序
  *
@@ -59,6 +163,88 @@ void tdd_rgb_transform_spi_data(unsigned char color_data, unsigned char chip_ic_
  */
 OPERATE_RET tdd_rgb_line_seq_transform(unsigned short *data_buf, unsigned short *spi_buf, RGB_ORDER_MODE_E rgb_order);
 
+/**
+ * @brief        获取线序对应的颜色下标：线序第i个分量为R、G、B中的第seq_idx[i]个
+ *
+ * @param[in]   rgb_order            颜色线序
+ * @param[out]  seq_idx              3个下标
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_rgb_line_seq_index(RGB_ORDER_MODE_E rgb_order, unsigned char *seq_idx);
+
+/**
+ * @brief      计算帧间复位（锁存）低电平对应的SPI零字节数
+ *
+ * @param[in]   spi_freq            SPI波特率
+ * @param[in]   reset_us            复位时间
+ *
+ * @return 字节数，向上取整
+ */
+unsigned int tdd_pixel_reset_bytes(unsigned int spi_freq, unsigned int reset_us);
+
+/**
+ * @brief      通过SPI发送数据，超过单次发送上限时分段连续发送
+ *
+ * 分段之间线路保持低电平，间隔超过芯片复位时间（WS2812约50us）会在帧中间提前锁存，
+ * 只有tkl_spi_send连续发送（DMA链式传输）的平台上才能发送超过PIXEL_SPI_SEND_MAX的单线灯带帧；
+ * 其他平台应保持码流不超过该上限（8位码型约2730个像素），或使用流式发送
+ *
+ * @param[in]   port                SPI端口
+ * @param[in]   buf                 发送数据
+ * @param[in]   len                 发送长度
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_spi_send(TUYA_SPI_NUM_E port, unsigned char *buf, unsigned int len);
+
+/**
+ * @brief      SPI端口是否支持无间隔的重复块发送（tdd_pixel_spi_send_repeat）
+ *
+ * 默认不支持（弱符号）；平台能用链式/循环DMA把同一块数据连续发送多次、块间不出现空闲间隔时
+ * 与tdd_pixel_spi_send_repeat一起重新实现
+ *
+ * @param[in]   port                SPI端口
+ *
+ * @return TRUE为支持
+ */
+BOOL_T tdd_pixel_spi_repeat_supported(TUYA_SPI_NUM_E port);
+
+/**
+ * @brief      以一次连续传输发送重复块：pattern循环发送至total_len字节（最后一块截短），随后发送tail
+ *
+ * 整个传输中线路不能出现空闲间隔，否则单线灯带会在帧中间锁存；默认实现（弱符号）不发送并返回不支持
+ *
+ * @param[in]   port                SPI端口
+ * @param[in]   pattern             重复块
+ * @param[in]   pattern_len         重复块长度
+ * @param[in]   total_len           重复部分的总长度
+ * @param[in]   tail                重复部分之后的数据（如复位零字节），可为NULL
+ * @param[in]   tail_len            tail长度
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_spi_send_repeat(TUYA_SPI_NUM_E port, const unsigned char *pattern, unsigned int pattern_len,
+                                      unsigned int total_len, const unsigned char *tail, unsigned int tail_len);
+
+/**
+ * @brief      占用SPI端口，同一端口同时只能被一个像素设备（任一驱动）打开
+ *
+ * @param[in]   port                SPI端口
+ *
+ * @return OPRT_OK on success, OPRT_COM_ERROR 端口已被占用. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_spi_port_claim(TUYA_SPI_NUM_E port);
+
+/**
+ * @brief      释放tdd_pixel_spi_port_claim占用的SPI端口
+ *
+ * @param[in]   port                SPI端口
+ *
+ * @return none
+ */
+void tdd_pixel_spi_port_release(TUYA_SPI_NUM_E port);
+
 /**
  * @brief      创建存放发送控制参数的缓存
  *
@@ -78,6 +264,63 @@ OPERATE_RET tdd_pixel_create_tx_ctrl(unsigned int tx_buff_len, DRV_PIXEL_TX_CTRL
  */
 OPERATE_RET tdd_pixel_tx_ctrl_release(IN DRV_PIXEL_TX_CTRL_T *tx_ctrl);
 
+/**
+ * @brief      初始化性能计时：配置了PIXEL_PERF_TIMER_ID时启动硬件定时器，重复调用无影响
+ *
+ * 在任务上下文中于首次计时前调用（如led_controller_init），计时接口本身不初始化定时器，可在中断中调用；
+ * 未调用或定时器启动失败时使用系统毫秒时钟
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_perf_init(void);
+
+/**
+ * @brief      性能计时时钟
+ *
+ * 目标板默认为系统毫秒时钟，配置PIXEL_PERF_TIMER_ID并调用tdd_pixel_perf_init后由硬件定时器计时（微秒精度）；
+ * 平台有其他微秒计时源（如周期计数器）时与tdd_pixel_perf_tick_us一起重新实现（弱符号），
+ * 主机仿真由tdd_pixel_sim提供真实单调时钟
+ *
+ * @return 微秒
+ */
+unsigned long long tdd_pixel_perf_now_us(void);
+
+/**
+ * @brief      获取性能计时精度
+ *
+ * @return 一个计时单位对应的微秒数，直方图按该单位分桶，硬件定时器未启动时为1000
+ */
+unsigned int tdd_pixel_perf_tick_us(void);
+
+/**
+ * @brief      记录一次性能采样：更新次数、最小/最大/累计值与对数直方图
+ *
+ * @param[in]   metric              性能计数
+ * @param[in]   value               采样值
+ *
+ * @return none
+ */
+void tdd_pixel_perf_record(PIXEL_PERF_METRIC_T *metric, unsigned int value);
+
+/**
+ * @brief      记录一次PIXEL_PERF_NOW_US计时的采样，直方图按计时单位（tdd_pixel_perf_tick_us）分桶
+ *
+ * @param[in]   metric              性能计数
+ * @param[in]   us                  耗时（微秒）
+ *
+ * @return none
+ */
+void tdd_pixel_perf_record_us(PIXEL_PERF_METRIC_T *metric, unsigned int us);
+
+/**
+ * @brief      获取性能计数的平均值
+ *
+ * @param[in]   metric              性能计数
+ *
+ * @return 平均值，无采样时为0
+ */
+unsigned int tdd_pixel_perf_avg(const PIXEL_PERF_METRIC_T *metric);
+
 #ifdef __cplusplus
 }
 #endif
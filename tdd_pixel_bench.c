@@ -0,0 +1,319 @@
+/**
+ * @file tdd_pixel_bench.c
+ * @author www.tuya.com
+ * @brief tdd_pixel_bench module is used to measure the cost of the pixel encode/refresh pipeline
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+#include <string.h>
+
+#include "tal_log.h"
+#include "tal_memory.h"
+#include "tal_system.h"
+
+#include "tdl_pixel_driver.h"
+#include "tdd_pixel_basic.h"
+#include "tdd_pixel_ws2812.h"
+#include "tdd_pixel_sim.h"
+#include "tdd_pixel_bench.h"
+#include "ws2812_spi.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define BENCH_COLOR_NUM      3
+#define BENCH_SPI_PORT       TUYA_SPI_NUM_0
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+/* 8位码型下2731像素的码流刚超过一次tkl_spi_send的上限，10000像素需分4段发送 */
+static const unsigned int bench_pixel_tbl[] = {12, 144, 1000, 2731, 10000};
+
+static const RGB_ORDER_MODE_E bench_order_tbl[] = {
+    RGB_ORDER, RBG_ORDER, GRB_ORDER, GBR_ORDER, BRG_ORDER, BGR_ORDER,
+};
+
+static const char *bench_order_name[] = {"RGB", "RBG", "GRB", "GBR", "BRG", "BGR"};
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+/**
+ * @brief 计时，主机仿真使用真实时钟，目标板为毫秒精度（靠迭代次数摊薄）
+ */
+static unsigned long long __bench_now_us(void)
+{
+#if (PIXEL_HOST_SIM == 1)
+    return tdd_pixel_sim_get_real_us();
+#else
+    return (unsigned long long)tal_system_get_millisecond() * 1000ULL;
+#endif
+}
+
+/**
+ * @brief 当前累计内存申请次数，仅主机仿真可用
+ */
+static unsigned int __bench_alloc_cnt(void)
+{
+#if (PIXEL_HOST_SIM == 1)
+    PIXEL_SIM_MEM_STAT_T mem;
+
+    tdd_pixel_sim_get_mem_stat(&mem);
+    return mem.alloc_cnt;
+#else
+    return PIXEL_BENCH_NA;
+#endif
+}
+
+static unsigned int __bench_iterations(unsigned int pixel_num)
+{
+    unsigned int iterations = PIXEL_BENCH_WORK_PIXELS / pixel_num;
+
+    return (iterations < PIXEL_BENCH_MIN_ITERATIONS) ? PIXEL_BENCH_MIN_ITERATIONS : iterations;
+}
+
+static void __bench_fill(unsigned short *data, unsigned int pixel_num, unsigned int seed)
+{
+    unsigned int i = 0;
+
+    for (i = 0; i < pixel_num * BENCH_COLOR_NUM; i++) {
+        data[i] = (unsigned short)((i * 7 + seed * 131) & 0xFF);
+    }
+}
+
+static void __bench_finish(PIXEL_BENCH_RESULT_T *result, unsigned long long elapsed_us, unsigned int alloc_start,
+                           PIXEL_BENCH_REPORT_CB cb, void *arg)
+{
+    unsigned int alloc_end = __bench_alloc_cnt();
+    unsigned long long pixels = (unsigned long long)result->iterations * result->pixel_num;
+
+    result->ns_per_pixel = (unsigned int)((elapsed_us * 1000ULL) / pixels);
+    result->allocs = (PIXEL_BENCH_NA == alloc_end) ? PIXEL_BENCH_NA : alloc_end - alloc_start;
+
+    if (cb) {
+        cb(result, arg);
+        return;
+    }
+
+    TAL_PR_NOTICE("PIXEL_BENCH,%s,%u,%s,%u,%u,%u,%d,%d", result->name, result->pixel_num,
+                  (result->order < sizeof(bench_order_name) / sizeof(bench_order_name[0])) ?
+                  bench_order_name[result->order] : "-",
+                  result->iterations, result->ns_per_pixel, result->bytes_touched,
+                  (PIXEL_BENCH_NA == result->heap_bytes) ? -1 : (int)result->heap_bytes,
+                  (PIXEL_BENCH_NA == result->allocs) ? -1 : (int)result->allocs);
+}
+
+/**
+ * @brief tdd_ws2812_driver_send_data：变化帧与不变帧
+ */
+static OPERATE_RET __bench_send_data(unsigned int pixel_num, RGB_ORDER_MODE_E order, unsigned short *frame_a,
+                                     unsigned short *frame_b, PIXEL_BENCH_REPORT_CB cb, void *arg)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    DRIVER_HANDLE_T handle = NULL;
+    PIXEL_DRIVER_CONFIG_T cfg = {0};
+    PIXEL_BENCH_RESULT_T result;
+    unsigned long long start = 0;
+    unsigned int i = 0, alloc_start = 0, heap_before = 0;
+
+    cfg.port = BENCH_SPI_PORT;
+    cfg.line_seq = order;
+    cfg.code_mode = PIXEL_SPI_CODE_8BIT;
+    op_ret = tdd_ws2812_driver_register(&cfg);
+    if (op_ret != OPRT_OK) {
+        return op_ret;
+    }
+
+    heap_before = (unsigned int)tal_system_get_free_heap_size();
+    op_ret = tdd_2812_driver_open(&handle, (unsigned short)pixel_num);
+    if (op_ret != OPRT_OK) {
+        TAL_PR_ERR("bench open %u pixels fail:%d", pixel_num, op_ret);
+        return op_ret;
+    }
+
+    memset(&result, 0, sizeof(result));
+    result.pixel_num = pixel_num;
+    result.order = order;
+    result.heap_bytes = heap_before - (unsigned int)tal_system_get_free_heap_size();
+
+    /* 每帧所有像素都变化：读颜色数据与上次编码数据，写上次编码数据与SPI码流 */
+    result.name = "send_data";
+    result.iterations = __bench_iterations(pixel_num);
+    result.bytes_touched = pixel_num * (BENCH_COLOR_NUM * sizeof(unsigned short) + 2 * BENCH_COLOR_NUM +
+                                        BENCH_COLOR_NUM * ONE_BYTE_LEN);
+    alloc_start = __bench_alloc_cnt();
+    start = __bench_now_us();
+    for (i = 0; i < result.iterations; i++) {
+        tdd_ws2812_driver_send_data(handle, (i & 0x01) ? frame_b : frame_a, pixel_num * BENCH_COLOR_NUM);
+    }
+    __bench_finish(&result, __bench_now_us() - start, alloc_start, cb, arg);
+
+    /* 帧内容不变：只读颜色数据与上次编码数据 */
+    result.name = "send_same";
+    result.bytes_touched = pixel_num * (BENCH_COLOR_NUM * sizeof(unsigned short) + BENCH_COLOR_NUM);
+    alloc_start = __bench_alloc_cnt();
+    start = __bench_now_us();
+    for (i = 0; i < result.iterations; i++) {
+        tdd_ws2812_driver_send_data(handle, frame_a, pixel_num * BENCH_COLOR_NUM);
+    }
+    __bench_finish(&result, __bench_now_us() - start, alloc_start, cb, arg);
+
+    return tdd_ws2812_driver_close(&handle);
+}
+
+/**
+ * @brief tdd_rgb_line_seq_transform
+ */
+static void __bench_line_seq(unsigned int pixel_num, RGB_ORDER_MODE_E order, unsigned short *frame,
+                             unsigned short *out, PIXEL_BENCH_REPORT_CB cb, void *arg)
+{
+    PIXEL_BENCH_RESULT_T result;
+    unsigned long long start = 0;
+    unsigned int i = 0, j = 0, alloc_start = 0;
+
+    memset(&result, 0, sizeof(result));
+    result.name = "line_seq";
+    result.pixel_num = pixel_num;
+    result.order = order;
+    result.iterations = __bench_iterations(pixel_num);
+    result.bytes_touched = pixel_num * 2 * BENCH_COLOR_NUM * sizeof(unsigned short);
+    result.heap_bytes = 0;
+
+    alloc_start = __bench_alloc_cnt();
+    start = __bench_now_us();
+    for (i = 0; i < result.iterations; i++) {
+        for (j = 0; j < pixel_num; j++) {
+            tdd_rgb_line_seq_transform(&frame[j * BENCH_COLOR_NUM], &out[j * BENCH_COLOR_NUM], order);
+        }
+    }
+    __bench_finish(&result, __bench_now_us() - start, alloc_start, cb, arg);
+}
+
+/**
+ * @brief ws2812_spi_set_all
+ */
+static void __bench_ws2812_set_all(PIXEL_BENCH_REPORT_CB cb, void *arg)
+{
+    PIXEL_BENCH_RESULT_T result;
+    unsigned long long start = 0;
+    unsigned int i = 0, alloc_start = 0, heap_before = 0;
+
+    heap_before = (unsigned int)tal_system_get_free_heap_size();
+    if (OPRT_OK != ws2812_spi_init(BENCH_SPI_PORT)) {
+        TAL_PR_ERR("bench ws2812_spi_init fail");
+        return;
+    }
+
+    memset(&result, 0, sizeof(result));
+    result.name = "ws2812_set_all";
+    result.pixel_num = WS2812_LED_COUNT;
+    result.order = 0xFF;
+    result.iterations = __bench_iterations(WS2812_LED_COUNT);
+    result.bytes_touched = WS2812_LED_COUNT * BENCH_COLOR_NUM * ONE_BYTE_LEN;
+    result.heap_bytes = heap_before - (unsigned int)tal_system_get_free_heap_size();
+
+    alloc_start = __bench_alloc_cnt();
+    start = __bench_now_us();
+    for (i = 0; i < result.iterations; i++) {
+        ws2812_spi_set_all((UCHAR_T)i, (UCHAR_T)(i >> 1), (UCHAR_T)(i >> 2));
+    }
+    __bench_finish(&result, __bench_now_us() - start, alloc_start, cb, arg);
+
+    ws2812_spi_deinit();
+}
+
+/**
+ * @brief ws2812_spi_set_pixel + ws2812_spi_refresh：逐像素不同颜色的帧
+ */
+static void __bench_ws2812_set_pixel(PIXEL_BENCH_REPORT_CB cb, void *arg)
+{
+    PIXEL_BENCH_RESULT_T result;
+    unsigned long long start = 0;
+    unsigned int i = 0, j = 0, alloc_start = 0, heap_before = 0;
+
+    heap_before = (unsigned int)tal_system_get_free_heap_size();
+    if (OPRT_OK != ws2812_spi_init(BENCH_SPI_PORT)) {
+        TAL_PR_ERR("bench ws2812_spi_init fail");
+        return;
+    }
+
+    memset(&result, 0, sizeof(result));
+    result.name = "ws2812_set_pixel";
+    result.pixel_num = WS2812_LED_COUNT;
+    result.order = 0xFF;
+    result.iterations = __bench_iterations(WS2812_LED_COUNT);
+    result.bytes_touched = WS2812_LED_COUNT * BENCH_COLOR_NUM * ONE_BYTE_LEN;
+    result.heap_bytes = heap_before - (unsigned int)tal_system_get_free_heap_size();
+
+    alloc_start = __bench_alloc_cnt();
+    start = __bench_now_us();
+    for (i = 0; i < result.iterations; i++) {
+        for (j = 0; j < WS2812_LED_COUNT; j++) {
+            ws2812_spi_set_pixel((UINT16_T)j, (UCHAR_T)(i + j * 7), (UCHAR_T)(i + j * 13), (UCHAR_T)(i + j * 29));
+        }
+        ws2812_spi_refresh();
+    }
+    __bench_finish(&result, __bench_now_us() - start, alloc_start, cb, arg);
+
+    ws2812_spi_deinit();
+}
+
+/**
+* @brief       运行编码/刷新基准测试：12/144/1000/2731/10000像素 x 6种线序
+*
+* @param[in]   cb                  结果回调，NULL时按CSV格式输出到日志
+* @param[in]   arg                 回调参数
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdd_pixel_bench_run(PIXEL_BENCH_REPORT_CB cb, void *arg)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    unsigned short *frame_a = NULL, *frame_b = NULL;
+    unsigned int max_pixels = bench_pixel_tbl[sizeof(bench_pixel_tbl) / sizeof(bench_pixel_tbl[0]) - 1];
+    unsigned int frame_len = max_pixels * BENCH_COLOR_NUM * sizeof(unsigned short);
+    unsigned int i = 0, j = 0;
+
+    frame_a = (unsigned short *)tal_malloc(frame_len);
+    frame_b = (unsigned short *)tal_malloc(frame_len);
+    if (NULL == frame_a || NULL == frame_b) {
+        op_ret = OPRT_MALLOC_FAILED;
+        goto __EXIT;
+    }
+
+    if (NULL == cb) {
+        TAL_PR_NOTICE("PIXEL_BENCH,name,pixels,order,iterations,ns_per_pixel,bytes,heap,allocs");
+    }
+
+    for (i = 0; i < sizeof(bench_pixel_tbl) / sizeof(bench_pixel_tbl[0]); i++) {
+        __bench_fill(frame_a, bench_pixel_tbl[i], 0);
+        for (j = 0; j < sizeof(bench_order_tbl) / sizeof(bench_order_tbl[0]); j++) {
+            /* line_seq的输出写入frame_b，每轮重新填充 */
+            __bench_fill(frame_b, bench_pixel_tbl[i], 1);
+            /* 大像素数可能超出目标板内存，失败时继续后续测试项 */
+            __bench_send_data(bench_pixel_tbl[i], bench_order_tbl[j], frame_a, frame_b, cb, arg);
+            __bench_line_seq(bench_pixel_tbl[i], bench_order_tbl[j], frame_a, frame_b, cb, arg);
+        }
+    }
+
+    __bench_ws2812_set_all(cb, arg);
+    __bench_ws2812_set_pixel(cb, arg);
+
+__EXIT:
+    if (frame_a) {
+        tal_free(frame_a);
+    }
+    if (frame_b) {
+        tal_free(frame_b);
+    }
+
+    return op_ret;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file tdd_pixel_bench.h
+ * @author www.tuya.com
+ * @brief tdd_pixel_bench module is used to measure the cost of the pixel encode/refresh pipeline
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+
+#ifndef __TDD_PIXEL_BENCH_H__
+#define __TDD_PIXEL_BENCH_H__
+
+#include "tdd_pixel_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+/* 每个测试项处理的像素总数，迭代次数 = 该值 / 像素点数 */
+#define PIXEL_BENCH_WORK_PIXELS        200000
+#define PIXEL_BENCH_MIN_ITERATIONS     4
+
+/* 结果中不可用的字段 */
+#define PIXEL_BENCH_NA                 0xFFFFFFFF
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    const char      *name;          // 测试项
+    unsigned int     pixel_num;     // 像素点数
+    RGB_ORDER_MODE_E order;         // 颜色线序
+    unsigned int     iterations;    // 迭代次数
+    unsigned int     ns_per_pixel;  // 每像素耗时
+    unsigned int     bytes_touched; // 每帧读写的字节数（颜色数据 + 编码缓存）
+    unsigned int     heap_bytes;    // 设备占用的堆内存，PIXEL_BENCH_NA为不可用
+    unsigned int     allocs;        // 计时循环内的内存申请次数，PIXEL_BENCH_NA为不可用
+} PIXEL_BENCH_RESULT_T;
+
+/**
+ * @brief 测试结果回调
+ */
+typedef void (*PIXEL_BENCH_REPORT_CB)(const PIXEL_BENCH_RESULT_T *result, void *arg);
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+/**
+ * @brief       运行编码/刷新基准测试：12/144/1000/2731/10000像素 x 6种线序
+ *
+ * 2731与10000像素的码流超过PIXEL_SPI_SEND_MAX，发送经tdd_pixel_spi_send分段
+ *
+ * 测试项：
+ *   send_data        tdd_ws2812_driver_send_data 每帧全部像素变化（全量编码 + 发送）
+ *   send_same        tdd_ws2812_driver_send_data 帧内容不变（跳过路径）
+ *   line_seq         tdd_rgb_line_seq_transform
+ *   ws2812_set_all   ws2812_spi_set_all（固定WS2812_LED_COUNT像素，与线序无关）
+ *   ws2812_set_pixel ws2812_spi_set_pixel逐像素不同颜色 + ws2812_spi_refresh（固定WS2812_LED_COUNT像素）
+ *
+ * @param[in]   cb                  结果回调，NULL时按CSV格式输出到日志：
+ *                                  PIXEL_BENCH,name,pixels,order,iterations,ns_per_pixel,bytes,heap,allocs
+ * @param[in]   arg                 回调参数
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_bench_run(PIXEL_BENCH_REPORT_CB cb, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDD_PIXEL_BENCH_H__ */
@@ -0,0 +1,166 @@
+/**
+ * @file tdd_pixel_decode.c
+ * @author www.tuya.com
+ * @brief tdd_pixel_decode module is used to decode captured spi stream back to pixel data
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+#include <string.h>
+
+#include "tdd_pixel_basic.h"
+#include "tdd_pixel_decode.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define SPI_BIT_GET(buf, pos)   (((buf)[(pos) / ONE_BYTE_LEN] >> (7 - ((pos) % ONE_BYTE_LEN))) & 0x01)
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    unsigned short t0h_min_ns;      // 0码高电平窗口
+    unsigned short t0h_max_ns;
+    unsigned short t1h_min_ns;      // 1码最短高电平，无上限
+    unsigned short tl_min_ns;       // 下一个上升沿前的最短低电平
+    unsigned int   reset_ns;        // 复位（锁存）最短低电平，与驱动发送的复位零字节一致
+} PIXEL_DECODE_SPEC_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+/* 按PIXEL_CHIP_E索引 */
+static const PIXEL_DECODE_SPEC_T decode_spec_tbl[] = {
+    {200, 550, 580, 200, 280000},   // WS2812B
+    {200, 500, 550, 200, 50000},    // WS2812
+    {150, 450, 450, 200, 80000},    // SK6812
+};
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+/**
+ * @brief SPI位数换算为纳秒
+ */
+static unsigned int __spi_bits_to_ns(unsigned int bits, unsigned int spi_freq)
+{
+    return (unsigned int)(((unsigned long long)bits * 1000000000ULL) / spi_freq);
+}
+
+/**
+* @brief       将SPI码流还原为线序数据（如GRB）并统计各码型时序
+*
+* @param[in]   spi_buf             SPI码流
+* @param[in]   spi_len             SPI码流长度
+* @param[in]   code_bits           每个数据位占用的SPI位数
+* @param[in]   spi_freq            SPI波特率
+* @param[in]   chip                芯片型号（PIXEL_CHIP_WS2812B/WS2812/SK6812），决定判决门限与时序窗口
+* @param[out]  data_buf            还原后的数据，按线序每字节一个颜色分量
+* @param[in]   data_len            data_buf长度
+* @param[out]  timing              时序统计，可为NULL
+*
+* @return 还原出的字节数，小于0为错误码
+*/
+int tdd_pixel_spi_decode(const unsigned char *spi_buf, unsigned int spi_len, unsigned char code_bits,
+                         unsigned int spi_freq, PIXEL_CHIP_E chip, unsigned char *data_buf, unsigned int data_len,
+                         PIXEL_DECODE_TIMING_T *timing)
+{
+    PIXEL_DECODE_TIMING_T tm;
+    const PIXEL_DECODE_SPEC_T *spec = NULL;
+    unsigned int total_bits = 0, data_bits = 0, pos = 0, threshold_ns = 0;
+    unsigned int high = 0, k = 0, high_ns = 0, low_ns = 0, out_len = 0;
+    unsigned char value = 0, bit_idx = 0, is_one = 0;
+    BOOL_T broken = FALSE;
+
+    if (NULL == spi_buf || NULL == data_buf || 0 == code_bits || code_bits > ONE_BYTE_LEN || 0 == spi_freq ||
+        chip > PIXEL_CHIP_SK6812) {
+        return OPRT_INVALID_PARM;
+    }
+    spec = &decode_spec_tbl[chip];
+    /* 采样点取0码窗口上限与1码下限的中点 */
+    threshold_ns = (spec->t0h_max_ns + spec->t1h_min_ns) / 2;
+
+    memset(&tm, 0, sizeof(tm));
+    tm.t0h_min_ns = 0xFFFFFFFF;
+    tm.t1h_min_ns = 0xFFFFFFFF;
+    tm.tl_min_ns = 0xFFFFFFFF;
+    tm.bit_ns = __spi_bits_to_ns(code_bits, spi_freq);
+
+    /* 最后一个高电平所在码型之后均为帧尾低电平 */
+    total_bits = spi_len * ONE_BYTE_LEN;
+    for (pos = total_bits; pos > 0; pos--) {
+        if (SPI_BIT_GET(spi_buf, pos - 1)) {
+            break;
+        }
+    }
+    data_bits = ((pos + code_bits - 1) / code_bits) * code_bits;
+    if (data_bits > total_bits) {
+        data_bits = total_bits;
+    }
+    tm.reset_ns = __spi_bits_to_ns(total_bits - data_bits, spi_freq);
+    tm.reset_ok = (tm.reset_ns >= spec->reset_ns) ? TRUE : FALSE;
+
+    for (pos = 0; pos + code_bits <= data_bits; pos += code_bits) {
+        /* 高电平须从码型起始连续，之后保持低电平 */
+        high = 0;
+        broken = FALSE;
+        for (k = 0; k < code_bits; k++) {
+            if (SPI_BIT_GET(spi_buf, pos + k)) {
+                if (high != k) {
+                    broken = TRUE;
+                }
+                high++;
+            }
+        }
+        if (broken || 0 == high) {
+            tm.invalid_num++;
+        }
+
+        high_ns = __spi_bits_to_ns(high, spi_freq);
+        low_ns = __spi_bits_to_ns(code_bits - high, spi_freq);
+        tm.tl_min_ns = (low_ns < tm.tl_min_ns) ? low_ns : tm.tl_min_ns;
+        is_one = (high_ns >= threshold_ns) ? 1 : 0;
+        if (is_one) {
+            tm.t1h_min_ns = (high_ns < tm.t1h_min_ns) ? high_ns : tm.t1h_min_ns;
+            tm.t1h_max_ns = (high_ns > tm.t1h_max_ns) ? high_ns : tm.t1h_max_ns;
+            if (high_ns < spec->t1h_min_ns || low_ns < spec->tl_min_ns) {
+                tm.out_of_spec++;
+            }
+        } else {
+            tm.t0h_min_ns = (high_ns < tm.t0h_min_ns) ? high_ns : tm.t0h_min_ns;
+            tm.t0h_max_ns = (high_ns > tm.t0h_max_ns) ? high_ns : tm.t0h_max_ns;
+            if (high_ns < spec->t0h_min_ns || high_ns > spec->t0h_max_ns || low_ns < spec->tl_min_ns) {
+                tm.out_of_spec++;
+            }
+        }
+
+        value = (value << 1) | is_one;
+        tm.bit_num++;
+        if (++bit_idx == ONE_BYTE_LEN) {
+            if (out_len < data_len) {
+                data_buf[out_len] = value;
+            }
+            out_len++;
+            bit_idx = 0;
+            value = 0;
+        }
+    }
+
+    if (0xFFFFFFFF == tm.t0h_min_ns) {
+        tm.t0h_min_ns = 0;
+    }
+    if (0xFFFFFFFF == tm.t1h_min_ns) {
+        tm.t1h_min_ns = 0;
+    }
+    if (0xFFFFFFFF == tm.tl_min_ns) {
+        tm.tl_min_ns = 0;
+    }
+    if (timing) {
+        memcpy(timing, &tm, sizeof(tm));
+    }
+
+    return (out_len < data_len) ? (int)out_len : (int)data_len;
+}
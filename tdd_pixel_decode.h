@@ -0,0 +1,70 @@
+/**
+ * @file tdd_pixel_decode.h
+ * @author www.tuya.com
+ * @brief tdd_pixel_decode module is used to decode captured spi stream back to pixel data
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+
+#ifndef __TDD_PIXEL_DECODE_H__
+#define __TDD_PIXEL_DECODE_H__
+
+#include "tdd_pixel_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+/* 芯片在上升沿后固定时间采样数据线：高电平短于采样点为0码、长于采样点为1码，
+ * 1码高电平只要在下一个上升沿前留出足够的低电平，持续多长都能被正确接收。
+ * 各芯片的0码高电平窗口、1码最短高电平、最短低电平与复位时间见tdd_pixel_spi_decode中的芯片时序表 */
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    unsigned int bit_num;           // 解码出的数据位数
+    unsigned int invalid_num;       // 高电平不连续或全低的码型个数
+    unsigned int out_of_spec;       // 高/低电平时间超出芯片接收窗口的码型个数
+    unsigned int bit_ns;            // 单个数据位周期
+    unsigned int t0h_min_ns;        // 0码高电平时间
+    unsigned int t0h_max_ns;
+    unsigned int t1h_min_ns;        // 1码高电平时间
+    unsigned int t1h_max_ns;
+    unsigned int tl_min_ns;         // 码型内最短低电平时间
+    unsigned int reset_ns;          // 帧尾低电平时间
+    BOOL_T       reset_ok;          // 帧尾低电平是否满足芯片复位时间
+} PIXEL_DECODE_TIMING_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+/**
+ * @brief       将SPI码流还原为线序数据（如GRB）并统计各码型时序
+ *
+ * @param[in]   spi_buf             SPI码流
+ * @param[in]   spi_len             SPI码流长度
+ * @param[in]   code_bits           每个数据位占用的SPI位数
+ * @param[in]   spi_freq            SPI波特率
+ * @param[in]   chip                芯片型号（PIXEL_CHIP_WS2812B/WS2812/SK6812），决定判决门限与时序窗口
+ * @param[out]  data_buf            还原后的数据，按线序每字节一个颜色分量
+ * @param[in]   data_len            data_buf长度
+ * @param[out]  timing              时序统计，可为NULL
+ *
+ * @return 还原出的字节数，小于0为错误码
+ */
+int tdd_pixel_spi_decode(const unsigned char *spi_buf, unsigned int spi_len, unsigned char code_bits,
+                         unsigned int spi_freq, PIXEL_CHIP_E chip, unsigned char *data_buf, unsigned int data_len,
+                         PIXEL_DECODE_TIMING_T *timing);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDD_PIXEL_DECODE_H__ */
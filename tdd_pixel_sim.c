@@ -0,0 +1,955 @@
+/**
+ * @file tdd_pixel_sim.c
+ * @author www.tuya.com
+ * @brief tdd_pixel_sim module is used to run pixel drivers on host (linux) without target hardware
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+#include "tdd_pixel_sim.h"
+
+#if (PIXEL_HOST_SIM == 1)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "tuya_cloud_types.h"
+#include "tal_log.h"
+#include "tal_memory.h"
+#include "tal_mutex.h"
+#include "tal_semaphore.h"
+#include "tal_sw_timer.h"
+#include "tal_system.h"
+#include "tal_thread.h"
+#include "tkl_spi.h"
+#include "tkl_timer.h"
+#include "tdd_pixel_basic.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define PIXEL_SIM_TIMER_MAX    16
+#define PIXEL_SIM_THREAD_MAX   16
+#define PIXEL_SIM_MEM_HDR_LEN  16     // 保持malloc返回地址的对齐
+#define PIXEL_SIM_TIME_NEVER   0xFFFFFFFFFFFFFFFFULL
+/* 等待模拟线程全部阻塞的真实时间上限，超过时认为有线程阻塞在模拟以外（如测试驱动线程持有的锁） */
+#define PIXEL_SIM_SETTLE_GUARD_MS  2000
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    BOOL_T used;
+    BOOL_T active;
+    TAL_TIMER_CB cb;
+    VOID_T *arg;
+    TIMER_TYPE type;
+    unsigned int period;
+    unsigned long long deadline;
+} SIM_TIMER_T;
+
+typedef struct {
+    BOOL_T inited;
+    PIXEL_SIM_SPI_STAT_T stat;
+    unsigned char *capture;
+    unsigned int fail_cnt;              // 之后返回失败的发送次数
+    BOOL_T repeat;                      // 支持无间隔的重复块发送
+} SIM_SPI_PORT_T;
+
+typedef struct {
+    unsigned int count;
+    unsigned int max;                   // 计数上限，二值信号量为1
+} SIM_SEM_T;
+
+typedef struct {
+    BOOL_T used;
+    BOOL_T alive;                       // 线程函数尚未返回
+    pthread_t tid;
+    THREAD_FUNC_CB func;
+    VOID_T *args;
+    BOOL_T waiting;                     // 阻塞在tal_system_sleep或tal_semaphore_wait中
+    SIM_SEM_T *wait_sem;                // 等待的信号量，NULL为只等待时间
+    unsigned long long wait_until;      // 等待的虚拟截止时间，PIXEL_SIM_TIME_NEVER为不超时
+} SIM_THREAD_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static pthread_mutex_t sim_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sim_clock_cond = PTHREAD_COND_INITIALIZER;   // 虚拟时钟前进
+static pthread_mutex_t sim_critical_lock = PTHREAD_MUTEX_INITIALIZER; // 模拟关中断临界区
+static unsigned long long sim_now_ms = 0;
+/* 由tal_thread_create_and_start创建的线程：等待只按虚拟时钟到期，不推进时钟；其他线程为测试驱动线程 */
+static __thread SIM_THREAD_T *sim_thread_self = NULL;
+static SIM_THREAD_T sim_threads[PIXEL_SIM_THREAD_MAX];
+static SIM_TIMER_T sim_timers[PIXEL_SIM_TIMER_MAX];
+static SIM_SPI_PORT_T sim_spi[TUYA_SPI_NUM_MAX];
+static PIXEL_SIM_SPI_HOOK sim_spi_hook = NULL;
+static void *sim_spi_hook_arg = NULL;
+static PIXEL_SIM_MEM_STAT_T sim_mem;
+static int sim_log_level = TAL_LOG_LEVEL_NOTICE;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+void tdd_pixel_sim_reset(void)
+{
+    unsigned int i = 0;
+
+    pthread_mutex_lock(&sim_lock);
+    sim_now_ms = 0;
+    memset(sim_timers, 0, sizeof(sim_timers));
+    for (i = 0; i < TUYA_SPI_NUM_MAX; i++) {
+        memset(&sim_spi[i].stat, 0, sizeof(PIXEL_SIM_SPI_STAT_T));
+        sim_spi[i].fail_cnt = 0;
+        sim_spi[i].repeat = FALSE;
+        if (sim_spi[i].capture) {
+            memset(sim_spi[i].capture, 0, PIXEL_SIM_SPI_CAPTURE_MAX);
+        }
+    }
+    memset(&sim_mem, 0, sizeof(sim_mem));
+    pthread_cond_broadcast(&sim_clock_cond);
+    pthread_mutex_unlock(&sim_lock);
+}
+
+/**
+ * @brief 所有模拟线程都阻塞在模拟的等待中，且等待条件都未满足（时钟不前进就不会再有线程运行）
+ */
+static BOOL_T __sim_quiescent_locked(void)
+{
+    SIM_THREAD_T *thrd = NULL;
+    unsigned int i = 0;
+
+    for (i = 0; i < PIXEL_SIM_THREAD_MAX; i++) {
+        thrd = &sim_threads[i];
+        if (!thrd->used || !thrd->alive) {
+            continue;
+        }
+        if (!thrd->waiting || (thrd->wait_sem && thrd->wait_sem->count) || thrd->wait_until <= sim_now_ms) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief 测试驱动线程等待模拟线程处理完当前时刻的事件，sem已有计数时提前返回
+ */
+static void __sim_settle_locked(const SIM_SEM_T *sem)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += PIXEL_SIM_SETTLE_GUARD_MS / 1000;
+
+    while (!__sim_quiescent_locked() && !(sem && sem->count)) {
+        if (ETIMEDOUT == pthread_cond_timedwait(&sim_clock_cond, &sim_lock, &ts)) {
+            fprintf(stderr, "pixel sim: threads not settled at %llu ms\n", sim_now_ms);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 将虚拟时钟推进到不晚于target的下一个事件（软件定时器到期或模拟线程等待超时）并处理
+ *
+ * @return 没有不晚于target的事件时返回FALSE，时钟不变
+ */
+static BOOL_T __sim_step_locked(unsigned long long target)
+{
+    SIM_TIMER_T *next = NULL;
+    unsigned long long wake = PIXEL_SIM_TIME_NEVER;
+    TAL_TIMER_CB cb = NULL;
+    VOID_T *arg = NULL;
+    unsigned int i = 0;
+
+    for (i = 0; i < PIXEL_SIM_TIMER_MAX; i++) {
+        if (sim_timers[i].used && sim_timers[i].active && sim_timers[i].deadline <= target &&
+            (NULL == next || sim_timers[i].deadline < next->deadline)) {
+            next = &sim_timers[i];
+        }
+    }
+    for (i = 0; i < PIXEL_SIM_THREAD_MAX; i++) {
+        if (sim_threads[i].used && sim_threads[i].alive && sim_threads[i].waiting &&
+            sim_threads[i].wait_until <= target && sim_threads[i].wait_until < wake) {
+            wake = sim_threads[i].wait_until;
+        }
+    }
+    if (NULL == next && PIXEL_SIM_TIME_NEVER == wake) {
+        return FALSE;
+    }
+
+    if (NULL == next || wake < next->deadline) {
+        sim_now_ms = (wake > sim_now_ms) ? wake : sim_now_ms;
+        pthread_cond_broadcast(&sim_clock_cond);
+        return TRUE;
+    }
+
+    sim_now_ms = (next->deadline > sim_now_ms) ? next->deadline : sim_now_ms;
+    pthread_cond_broadcast(&sim_clock_cond);
+    if (TAL_TIMER_ONCE == next->type) {
+        next->active = FALSE;
+    } else {
+        next->deadline += next->period;
+    }
+    cb = next->cb;
+    arg = next->arg;
+
+    /* 回调中可能重新启动/停止定时器 */
+    pthread_mutex_unlock(&sim_lock);
+    cb((TIMER_ID)next, arg);
+    pthread_mutex_lock(&sim_lock);
+
+    return TRUE;
+}
+
+void tdd_pixel_sim_advance(unsigned int ms)
+{
+    unsigned long long target = 0;
+
+    pthread_mutex_lock(&sim_lock);
+    target = sim_now_ms + ms;
+    __sim_settle_locked(NULL);
+    while (__sim_step_locked(target)) {
+        __sim_settle_locked(NULL);
+    }
+    sim_now_ms = target;
+    pthread_cond_broadcast(&sim_clock_cond);
+    __sim_settle_locked(NULL);
+    pthread_mutex_unlock(&sim_lock);
+}
+
+OPERATE_RET tdd_pixel_sim_spi_get_stat(TUYA_SPI_NUM_E port, PIXEL_SIM_SPI_STAT_T *stat)
+{
+    if (port >= TUYA_SPI_NUM_MAX || NULL == stat) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    memcpy(stat, &sim_spi[port].stat, sizeof(PIXEL_SIM_SPI_STAT_T));
+    pthread_mutex_unlock(&sim_lock);
+
+    return OPRT_OK;
+}
+
+int tdd_pixel_sim_spi_last_frame(TUYA_SPI_NUM_E port, unsigned char *buf, unsigned int len)
+{
+    unsigned int copy_len = 0;
+
+    if (port >= TUYA_SPI_NUM_MAX || NULL == buf) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    if (sim_spi[port].capture) {
+        copy_len = sim_spi[port].stat.last_len;
+        if (copy_len > PIXEL_SIM_SPI_CAPTURE_MAX) {
+            copy_len = PIXEL_SIM_SPI_CAPTURE_MAX;
+        }
+        if (copy_len > len) {
+            copy_len = len;
+        }
+        memcpy(buf, sim_spi[port].capture, copy_len);
+    }
+    pthread_mutex_unlock(&sim_lock);
+
+    return (int)copy_len;
+}
+
+void tdd_pixel_sim_spi_set_hook(PIXEL_SIM_SPI_HOOK hook, void *arg)
+{
+    pthread_mutex_lock(&sim_lock);
+    sim_spi_hook = hook;
+    sim_spi_hook_arg = arg;
+    pthread_mutex_unlock(&sim_lock);
+}
+
+OPERATE_RET tdd_pixel_sim_spi_fail_next(TUYA_SPI_NUM_E port, unsigned int cnt)
+{
+    if (port >= TUYA_SPI_NUM_MAX) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    sim_spi[port].fail_cnt = cnt;
+    pthread_mutex_unlock(&sim_lock);
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tdd_pixel_sim_spi_set_repeat(TUYA_SPI_NUM_E port, BOOL_T enable)
+{
+    if (port >= TUYA_SPI_NUM_MAX) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    sim_spi[port].repeat = enable;
+    pthread_mutex_unlock(&sim_lock);
+
+    return OPRT_OK;
+}
+
+void tdd_pixel_sim_get_mem_stat(PIXEL_SIM_MEM_STAT_T *stat)
+{
+    if (NULL == stat) {
+        return;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    memcpy(stat, &sim_mem, sizeof(sim_mem));
+    pthread_mutex_unlock(&sim_lock);
+}
+
+unsigned long long tdd_pixel_sim_get_real_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (unsigned long long)ts.tv_sec * 1000000ULL + (unsigned long long)ts.tv_nsec / 1000ULL;
+}
+
+void tdd_pixel_sim_set_log_level(int level)
+{
+    sim_log_level = level;
+}
+
+/***********************************************************
+*********************tdd_pixel_perf************************
+***********************************************************/
+/* 覆盖tdd_pixel_basic中的弱符号：性能计时取主机真实时钟，虚拟时钟不随CPU耗时前进 */
+unsigned long long tdd_pixel_perf_now_us(void)
+{
+    return tdd_pixel_sim_get_real_us();
+}
+
+unsigned int tdd_pixel_perf_tick_us(void)
+{
+    return 1;
+}
+
+/* 覆盖tdd_pixel_basic中的弱符号：重复块展开后一次发送，线上与连续的链式DMA传输相同 */
+BOOL_T tdd_pixel_spi_repeat_supported(TUYA_SPI_NUM_E port)
+{
+    BOOL_T repeat = FALSE;
+
+    if (port >= TUYA_SPI_NUM_MAX) {
+        return FALSE;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    repeat = sim_spi[port].repeat;
+    pthread_mutex_unlock(&sim_lock);
+
+    return repeat;
+}
+
+OPERATE_RET tdd_pixel_spi_send_repeat(TUYA_SPI_NUM_E port, const unsigned char *pattern, unsigned int pattern_len,
+                                      unsigned int total_len, const unsigned char *tail, unsigned int tail_len)
+{
+    OPERATE_RET ret = OPRT_OK;
+    unsigned char *buf = NULL;
+    unsigned int len = 0;
+
+    if (!tdd_pixel_spi_repeat_supported(port)) {
+        return OPRT_NOT_SUPPORTED;
+    }
+    if (NULL == pattern || 0 == pattern_len || (NULL == tail && tail_len) || total_len + tail_len > 0xFFFF) {
+        return OPRT_INVALID_PARM;
+    }
+
+    buf = (unsigned char *)malloc(total_len + tail_len);
+    if (NULL == buf) {
+        return OPRT_MALLOC_FAILED;
+    }
+    for (len = 0; len < total_len; len += pattern_len) {
+        memcpy(&buf[len], pattern, (total_len - len < pattern_len) ? total_len - len : pattern_len);
+    }
+    if (tail_len) {
+        memcpy(&buf[total_len], tail, tail_len);
+    }
+
+    ret = tkl_spi_send(port, buf, (UINT16_T)(total_len + tail_len));
+    free(buf);
+    if (OPRT_OK == ret) {
+        pthread_mutex_lock(&sim_lock);
+        sim_spi[port].stat.repeat_cnt++;
+        pthread_mutex_unlock(&sim_lock);
+    }
+
+    return ret;
+}
+
+/***********************************************************
+************************tkl_spi*****************************
+***********************************************************/
+OPERATE_RET tkl_spi_init(TUYA_SPI_NUM_E port, const TUYA_SPI_BASE_CFG_T *cfg)
+{
+    if (port >= TUYA_SPI_NUM_MAX || NULL == cfg) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    if (NULL == sim_spi[port].capture) {
+        sim_spi[port].capture = (unsigned char *)malloc(PIXEL_SIM_SPI_CAPTURE_MAX);
+    }
+    sim_spi[port].inited = TRUE;
+    sim_spi[port].stat.freq_hz = cfg->freq_hz;
+    pthread_mutex_unlock(&sim_lock);
+
+    return (NULL == sim_spi[port].capture) ? OPRT_MALLOC_FAILED : OPRT_OK;
+}
+
+OPERATE_RET tkl_spi_deinit(TUYA_SPI_NUM_E port)
+{
+    if (port >= TUYA_SPI_NUM_MAX) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    sim_spi[port].inited = FALSE;
+    pthread_mutex_unlock(&sim_lock);
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tkl_spi_send(TUYA_SPI_NUM_E port, VOID_T *data, UINT16_T size)
+{
+    PIXEL_SIM_SPI_HOOK hook = NULL;
+    void *hook_arg = NULL;
+
+    if (port >= TUYA_SPI_NUM_MAX || NULL == data) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    if (!sim_spi[port].inited) {
+        pthread_mutex_unlock(&sim_lock);
+        return OPRT_RESOURCE_NOT_READY;
+    }
+    /* 模拟传输失败：不抓取，不调用钩子 */
+    if (sim_spi[port].fail_cnt > 0) {
+        sim_spi[port].fail_cnt--;
+        pthread_mutex_unlock(&sim_lock);
+        return OPRT_COM_ERROR;
+    }
+    /* UINT16_T的size总小于PIXEL_SIM_SPI_CAPTURE_MAX */
+    memcpy(sim_spi[port].capture, data, size);
+    sim_spi[port].stat.send_cnt++;
+    sim_spi[port].stat.send_bytes += size;
+    sim_spi[port].stat.last_len = size;
+    hook = sim_spi_hook;
+    hook_arg = sim_spi_hook_arg;
+    pthread_mutex_unlock(&sim_lock);
+
+    if (hook) {
+        hook(port, (const unsigned char *)data, size, hook_arg);
+    }
+
+    return OPRT_OK;
+}
+
+/***********************************************************
+************************tal_memory**************************
+***********************************************************/
+VOID_T *tal_malloc(SIZE_T size)
+{
+    unsigned char *ptr = (unsigned char *)malloc(size + PIXEL_SIM_MEM_HDR_LEN);
+
+    if (NULL == ptr) {
+        return NULL;
+    }
+    *(SIZE_T *)ptr = size;
+
+    pthread_mutex_lock(&sim_lock);
+    sim_mem.alloc_cnt++;
+    sim_mem.bytes_in_use += size;
+    if (sim_mem.bytes_in_use > sim_mem.bytes_peak) {
+        sim_mem.bytes_peak = sim_mem.bytes_in_use;
+    }
+    pthread_mutex_unlock(&sim_lock);
+
+    return ptr + PIXEL_SIM_MEM_HDR_LEN;
+}
+
+VOID_T tal_free(VOID_T *ptr)
+{
+    unsigned char *raw = NULL;
+
+    if (NULL == ptr) {
+        return;
+    }
+    raw = (unsigned char *)ptr - PIXEL_SIM_MEM_HDR_LEN;
+
+    pthread_mutex_lock(&sim_lock);
+    sim_mem.free_cnt++;
+    sim_mem.bytes_in_use -= *(SIZE_T *)raw;
+    pthread_mutex_unlock(&sim_lock);
+
+    free(raw);
+}
+
+/***********************************************************
+************************tkl_timer***************************
+***********************************************************/
+/* 主机没有硬件定时器，性能计时已由tdd_pixel_perf_now_us直接提供 */
+OPERATE_RET tkl_timer_init(TUYA_TIMER_NUM_E timer_id, TUYA_TIMER_BASE_CFG_T *cfg)
+{
+    (void)timer_id;
+    (void)cfg;
+
+    return OPRT_NOT_SUPPORTED;
+}
+
+OPERATE_RET tkl_timer_start(TUYA_TIMER_NUM_E timer_id, UINT_T us)
+{
+    (void)timer_id;
+    (void)us;
+
+    return OPRT_NOT_SUPPORTED;
+}
+
+OPERATE_RET tkl_timer_stop(TUYA_TIMER_NUM_E timer_id)
+{
+    (void)timer_id;
+
+    return OPRT_NOT_SUPPORTED;
+}
+
+OPERATE_RET tkl_timer_deinit(TUYA_TIMER_NUM_E timer_id)
+{
+    (void)timer_id;
+
+    return OPRT_NOT_SUPPORTED;
+}
+
+OPERATE_RET tkl_timer_get(TUYA_TIMER_NUM_E timer_id, UINT_T *us)
+{
+    (void)timer_id;
+    (void)us;
+
+    return OPRT_NOT_SUPPORTED;
+}
+
+/***********************************************************
+************************tal_system**************************
+***********************************************************/
+SYS_TIME_T tal_system_get_millisecond(VOID_T)
+{
+    SYS_TIME_T now = 0;
+
+    pthread_mutex_lock(&sim_lock);
+    now = (SYS_TIME_T)sim_now_ms;
+    pthread_mutex_unlock(&sim_lock);
+
+    return now;
+}
+
+UINT_T tkl_system_enter_critical(VOID_T)
+{
+    pthread_mutex_lock(&sim_critical_lock);
+
+    return 0;
+}
+
+VOID_T tkl_system_exit_critical(UINT_T irq_mask)
+{
+    (void)irq_mask;
+    pthread_mutex_unlock(&sim_critical_lock);
+}
+
+INT_T tal_system_get_free_heap_size(VOID_T)
+{
+    INT_T free_size = 0;
+
+    pthread_mutex_lock(&sim_lock);
+    free_size = (INT_T)(PIXEL_SIM_HEAP_SIZE - sim_mem.bytes_in_use);
+    pthread_mutex_unlock(&sim_lock);
+
+    return free_size;
+}
+
+/**
+ * @brief 模拟线程阻塞到sem有计数或虚拟时钟到达until，返回时sem的计数已取走（有计数时）
+ */
+static OPERATE_RET __sim_thread_wait_locked(SIM_SEM_T *sem, unsigned long long until)
+{
+    SIM_THREAD_T *self = sim_thread_self;
+    OPERATE_RET ret = OPRT_OK;
+
+    self->wait_sem = sem;
+    self->wait_until = until;
+    self->waiting = TRUE;
+    /* 测试驱动线程可能在等待本线程阻塞 */
+    pthread_cond_broadcast(&sim_clock_cond);
+    while (!(sem && sem->count) && sim_now_ms < until) {
+        pthread_cond_wait(&sim_clock_cond, &sim_lock);
+    }
+    self->waiting = FALSE;
+    self->wait_sem = NULL;
+
+    if (sem && sem->count) {
+        sem->count--;
+    } else if (sem) {
+        ret = OPRT_TIMEOUT;
+    }
+
+    return ret;
+}
+
+VOID_T tal_system_sleep(const UINT_T time_ms)
+{
+    if (NULL == sim_thread_self) {
+        /* 测试驱动线程：推进虚拟时钟 */
+        tdd_pixel_sim_advance(time_ms);
+        return;
+    }
+
+    /* 模拟线程：等待测试驱动把时钟推进到本线程的截止时间，时间进度与线程调度无关 */
+    pthread_mutex_lock(&sim_lock);
+    __sim_thread_wait_locked(NULL, sim_now_ms + time_ms);
+    pthread_mutex_unlock(&sim_lock);
+}
+
+/***********************************************************
+************************tal_mutex***************************
+***********************************************************/
+OPERATE_RET tal_mutex_create_init(MUTEX_HANDLE *handle)
+{
+    pthread_mutex_t *mutex = NULL;
+    pthread_mutexattr_t attr;
+
+    if (NULL == handle) {
+        return OPRT_INVALID_PARM;
+    }
+
+    mutex = (pthread_mutex_t *)malloc(sizeof(pthread_mutex_t));
+    if (NULL == mutex) {
+        return OPRT_MALLOC_FAILED;
+    }
+    /* 检错锁：重复解锁返回错误而不是未定义行为 */
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_ERRORCHECK);
+    pthread_mutex_init(mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    *handle = (MUTEX_HANDLE)mutex;
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tal_mutex_lock(const MUTEX_HANDLE handle)
+{
+    if (NULL == handle) {
+        return OPRT_INVALID_PARM;
+    }
+    return (0 == pthread_mutex_lock((pthread_mutex_t *)handle)) ? OPRT_OK : OPRT_COM_ERROR;
+}
+
+OPERATE_RET tal_mutex_unlock(const MUTEX_HANDLE handle)
+{
+    if (NULL == handle) {
+        return OPRT_INVALID_PARM;
+    }
+    return (0 == pthread_mutex_unlock((pthread_mutex_t *)handle)) ? OPRT_OK : OPRT_COM_ERROR;
+}
+
+OPERATE_RET tal_mutex_release(const MUTEX_HANDLE handle)
+{
+    if (NULL == handle) {
+        return OPRT_INVALID_PARM;
+    }
+    pthread_mutex_destroy((pthread_mutex_t *)handle);
+    free(handle);
+
+    return OPRT_OK;
+}
+
+/***********************************************************
+************************tal_semaphore***********************
+***********************************************************/
+OPERATE_RET tal_semaphore_create_init(SEM_HANDLE *handle, const UINT_T sem_cnt, const UINT_T sem_max)
+{
+    SIM_SEM_T *sem = NULL;
+
+    if (NULL == handle || 0 == sem_max) {
+        return OPRT_INVALID_PARM;
+    }
+
+    sem = (SIM_SEM_T *)malloc(sizeof(SIM_SEM_T));
+    if (NULL == sem) {
+        return OPRT_MALLOC_FAILED;
+    }
+    sem->max = sem_max;
+    sem->count = (sem_cnt > sem_max) ? sem_max : sem_cnt;
+    *handle = (SEM_HANDLE)sem;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief 超时按虚拟时钟计算：模拟线程等待测试驱动推进时钟；测试驱动线程等待期间由自己推进时钟，
+ *        模拟线程处理完当前时刻后时钟前进到下一个事件，直到信号量有计数或到达超时时间
+ */
+OPERATE_RET tal_semaphore_wait(const SEM_HANDLE handle, const UINT_T timeout)
+{
+    SIM_SEM_T *sem = (SIM_SEM_T *)handle;
+    unsigned long long deadline = PIXEL_SIM_TIME_NEVER;
+    OPERATE_RET ret = OPRT_OK;
+
+    if (NULL == sem) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    if (timeout != SEM_WAIT_FOREVER) {
+        deadline = sim_now_ms + timeout;
+    }
+
+    if (sim_thread_self) {
+        ret = __sim_thread_wait_locked(sem, deadline);
+        pthread_mutex_unlock(&sim_lock);
+        return ret;
+    }
+
+    for (;;) {
+        if (sem->count) {
+            sem->count--;
+            break;
+        }
+        if (sim_now_ms >= deadline) {
+            ret = OPRT_TIMEOUT;
+            break;
+        }
+        if (PIXEL_SIM_TIME_NEVER == deadline) {
+            pthread_cond_wait(&sim_clock_cond, &sim_lock);
+            continue;
+        }
+        __sim_settle_locked(sem);
+        if (sem->count) {
+            continue;
+        }
+        if (!__sim_step_locked(deadline)) {
+            sim_now_ms = deadline;
+            pthread_cond_broadcast(&sim_clock_cond);
+        }
+        __sim_settle_locked(sem);
+    }
+    pthread_mutex_unlock(&sim_lock);
+
+    return ret;
+}
+
+OPERATE_RET tal_semaphore_post(const SEM_HANDLE handle)
+{
+    SIM_SEM_T *sem = (SIM_SEM_T *)handle;
+
+    if (NULL == sem) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    if (sem->count < sem->max) {
+        sem->count++;
+    }
+    pthread_cond_broadcast(&sim_clock_cond);
+    pthread_mutex_unlock(&sim_lock);
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tal_semaphore_release(const SEM_HANDLE handle)
+{
+    if (NULL == handle) {
+        return OPRT_INVALID_PARM;
+    }
+    free(handle);
+
+    return OPRT_OK;
+}
+
+/***********************************************************
+************************tal_thread**************************
+***********************************************************/
+static void *__sim_thread_entry(void *arg)
+{
+    SIM_THREAD_T *thrd = (SIM_THREAD_T *)arg;
+
+    sim_thread_self = thrd;
+    thrd->func(thrd->args);
+
+    pthread_mutex_lock(&sim_lock);
+    thrd->alive = FALSE;
+    pthread_cond_broadcast(&sim_clock_cond);
+    pthread_mutex_unlock(&sim_lock);
+
+    return NULL;
+}
+
+OPERATE_RET tal_thread_create_and_start(THREAD_HANDLE *handle, const THREAD_ENTER_CB enter, const THREAD_EXIT_CB exit,
+                                        const THREAD_FUNC_CB func, const VOID_T *func_args, const THREAD_CFG_T *cfg)
+{
+    SIM_THREAD_T *thrd = NULL;
+    unsigned int i = 0;
+
+    (void)enter;
+    (void)exit;
+    (void)cfg;
+
+    if (NULL == handle || NULL == func) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    for (i = 0; i < PIXEL_SIM_THREAD_MAX; i++) {
+        if (!sim_threads[i].used) {
+            thrd = &sim_threads[i];
+            break;
+        }
+    }
+    if (NULL == thrd) {
+        pthread_mutex_unlock(&sim_lock);
+        return OPRT_EXCEED_UPPER_LIMIT;
+    }
+    memset(thrd, 0, sizeof(SIM_THREAD_T));
+    thrd->used = TRUE;
+    thrd->alive = TRUE;
+    thrd->func = func;
+    thrd->args = (VOID_T *)func_args;
+    thrd->wait_until = PIXEL_SIM_TIME_NEVER;
+    if (0 != pthread_create(&thrd->tid, NULL, __sim_thread_entry, thrd)) {
+        thrd->used = FALSE;
+        pthread_mutex_unlock(&sim_lock);
+        return OPRT_COM_ERROR;
+    }
+    pthread_mutex_unlock(&sim_lock);
+    *handle = (THREAD_HANDLE)thrd;
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tal_thread_delete(const THREAD_HANDLE handle)
+{
+    SIM_THREAD_T *thrd = (SIM_THREAD_T *)handle;
+
+    if (NULL == thrd) {
+        return OPRT_INVALID_PARM;
+    }
+
+    /* 线程自身删除时分离，由其他线程删除时等待其退出 */
+    if (pthread_equal(thrd->tid, pthread_self())) {
+        pthread_detach(thrd->tid);
+    } else {
+        pthread_join(thrd->tid, NULL);
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    thrd->alive = FALSE;
+    thrd->used = FALSE;
+    pthread_cond_broadcast(&sim_clock_cond);
+    pthread_mutex_unlock(&sim_lock);
+
+    return OPRT_OK;
+}
+
+/***********************************************************
+************************tal_sw_timer************************
+***********************************************************/
+OPERATE_RET tal_sw_timer_create(TAL_TIMER_CB func, VOID_T *arg, TIMER_ID *timer_id)
+{
+    unsigned int i = 0;
+
+    if (NULL == func || NULL == timer_id) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    for (i = 0; i < PIXEL_SIM_TIMER_MAX; i++) {
+        if (!sim_timers[i].used) {
+            memset(&sim_timers[i], 0, sizeof(SIM_TIMER_T));
+            sim_timers[i].used = TRUE;
+            sim_timers[i].cb = func;
+            sim_timers[i].arg = arg;
+            *timer_id = (TIMER_ID)&sim_timers[i];
+            pthread_mutex_unlock(&sim_lock);
+            return OPRT_OK;
+        }
+    }
+    pthread_mutex_unlock(&sim_lock);
+
+    return OPRT_EXCEED_UPPER_LIMIT;
+}
+
+OPERATE_RET tal_sw_timer_delete(TIMER_ID timer_id)
+{
+    if (NULL == timer_id) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    memset(timer_id, 0, sizeof(SIM_TIMER_T));
+    pthread_mutex_unlock(&sim_lock);
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tal_sw_timer_stop(TIMER_ID timer_id)
+{
+    if (NULL == timer_id) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    ((SIM_TIMER_T *)timer_id)->active = FALSE;
+    pthread_mutex_unlock(&sim_lock);
+
+    return OPRT_OK;
+}
+
+OPERATE_RET tal_sw_timer_start(TIMER_ID timer_id, TIME_MS time_ms, TIMER_TYPE timer_type)
+{
+    SIM_TIMER_T *timer = (SIM_TIMER_T *)timer_id;
+
+    if (NULL == timer) {
+        return OPRT_INVALID_PARM;
+    }
+
+    pthread_mutex_lock(&sim_lock);
+    timer->type = timer_type;
+    timer->period = time_ms;
+    timer->deadline = sim_now_ms + time_ms;
+    timer->active = TRUE;
+    pthread_mutex_unlock(&sim_lock);
+
+    return OPRT_OK;
+}
+
+/***********************************************************
+************************tal_log*****************************
+***********************************************************/
+OPERATE_RET tal_log_print(const TAL_LOG_LEVEL_E level, const char *file, const int line, const char *fmt, ...)
+{
+    va_list ap;
+
+    if ((int)level > sim_log_level) {
+        return OPRT_OK;
+    }
+
+    printf("[%llu][%d][%s:%d] ", (unsigned long long)tal_system_get_millisecond(), (int)level, file, line);
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    printf("\n");
+
+    return OPRT_OK;
+}
+
+#endif /* PIXEL_HOST_SIM */
@@ -0,0 +1,179 @@
+/**
+ * @file tdd_pixel_sim.h
+ * @author www.tuya.com
+ * @brief tdd_pixel_sim module is used to run pixel drivers on host (linux) without target hardware
+ *
+ * 编译时定义 PIXEL_HOST_SIM=1 启用，提供以下接口的进程内替身：
+ * tkl_spi_*、tal_sw_timer_*、tal_mutex_*、tal_semaphore_*、tal_thread_*、
+ * tal_malloc/tal_free、tal_system_get_millisecond/tal_system_sleep/tal_system_get_free_heap_size、
+ * tkl_system_enter_critical/tkl_system_exit_critical、tkl_timer_*（均返回不支持）
+ * 以及 tal_log_print；并以主机真实时钟强符号覆盖 tdd_pixel_perf_now_us/tdd_pixel_perf_tick_us。
+ * SPI发送的数据按端口抓取，可配合 tdd_pixel_decode 还原为像素数据和时序。
+ * 时间为虚拟时钟，只由测试驱动线程推进（tdd_pixel_sim_advance，或在测试驱动线程中调用
+ * tal_system_sleep/带超时的tal_semaphore_wait）；tal_thread_create_and_start创建的线程调用
+ * tal_system_sleep/tal_semaphore_wait时按虚拟时钟计算截止时间，不推进时钟。
+ * 时钟逐个事件前进（软件定时器到期、模拟线程等待超时），每前进一步都等所有模拟线程重新阻塞后
+ * 再继续，时间进度与线程调度无关，便于确定性地回放状态机。
+ * 信号量按tal_semaphore_create_init的sem_max限制计数，与目标平台一致。
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+
+#ifndef __TDD_PIXEL_SIM_H__
+#define __TDD_PIXEL_SIM_H__
+
+#include "tdd_pixel_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#ifndef PIXEL_HOST_SIM
+#define PIXEL_HOST_SIM 0
+#endif
+
+#if (PIXEL_HOST_SIM == 1)
+
+/* 每个端口抓取的最大帧长 */
+#define PIXEL_SIM_SPI_CAPTURE_MAX      (256 * 1024)
+/* tal_system_get_free_heap_size返回的模拟堆大小 */
+#define PIXEL_SIM_HEAP_SIZE            (64 * 1024 * 1024)
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    unsigned int freq_hz;               // tkl_spi_init配置的波特率
+    unsigned int send_cnt;              // tkl_spi_send调用次数
+    unsigned long long send_bytes;      // 累计发送字节数
+    unsigned int last_len;              // 最近一次发送的长度
+    unsigned int repeat_cnt;            // tdd_pixel_spi_send_repeat调用次数（计入send_cnt）
+} PIXEL_SIM_SPI_STAT_T;
+
+typedef struct {
+    unsigned int alloc_cnt;             // tal_malloc次数
+    unsigned int free_cnt;              // tal_free次数
+    unsigned int bytes_in_use;          // 当前占用
+    unsigned int bytes_peak;            // 峰值占用
+} PIXEL_SIM_MEM_STAT_T;
+
+/**
+ * @brief SPI发送钩子，每次tkl_spi_send在抓取后调用
+ */
+typedef void (*PIXEL_SIM_SPI_HOOK)(TUYA_SPI_NUM_E port, const unsigned char *data, unsigned int len, void *arg);
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+/**
+ * @brief       清空所有抓取数据、统计与软件定时器并将虚拟时钟归零
+ *
+ * 已创建的定时器句柄失效（不再到期），已初始化的SPI端口保持打开，应在模拟线程未运行时调用
+ *
+ * @return none
+ */
+void tdd_pixel_sim_reset(void);
+
+/**
+ * @brief       推进虚拟时钟，依次执行到期的软件定时器并唤醒到期的模拟线程
+ *
+ * 每个事件处理后等待所有模拟线程重新阻塞，返回时模拟线程都已处理完截止时间内的事件
+ *
+ * @param[in]   ms                  推进的时间
+ *
+ * @return none
+ */
+void tdd_pixel_sim_advance(unsigned int ms);
+
+/**
+ * @brief       获取SPI端口统计
+ *
+ * @param[in]   port                SPI端口
+ * @param[out]  stat                统计数据
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_sim_spi_get_stat(TUYA_SPI_NUM_E port, PIXEL_SIM_SPI_STAT_T *stat);
+
+/**
+ * @brief       拷贝SPI端口最近一次发送的数据
+ *
+ * @param[in]   port                SPI端口
+ * @param[out]  buf                 数据缓存
+ * @param[in]   len                 缓存长度
+ *
+ * @return 拷贝的字节数，小于0为错误码
+ */
+int tdd_pixel_sim_spi_last_frame(TUYA_SPI_NUM_E port, unsigned char *buf, unsigned int len);
+
+/**
+ * @brief       设置SPI发送钩子
+ *
+ * @param[in]   hook                钩子函数，NULL为取消
+ * @param[in]   arg                 钩子参数
+ *
+ * @return none
+ */
+void tdd_pixel_sim_spi_set_hook(PIXEL_SIM_SPI_HOOK hook, void *arg);
+
+/**
+ * @brief       让SPI端口之后的若干次发送失败（返回OPRT_COM_ERROR，不抓取数据）
+ *
+ * @param[in]   port                SPI端口
+ * @param[in]   cnt                 失败的发送次数，0为取消
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_sim_spi_fail_next(TUYA_SPI_NUM_E port, unsigned int cnt);
+
+/**
+ * @brief       设置SPI端口是否支持无间隔的重复块发送（tdd_pixel_spi_repeat_supported），默认不支持
+ *
+ * 支持时tdd_pixel_spi_send_repeat展开为一次tkl_spi_send
+ *
+ * @param[in]   port                SPI端口
+ * @param[in]   enable              TRUE为支持
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_sim_spi_set_repeat(TUYA_SPI_NUM_E port, BOOL_T enable);
+
+/**
+ * @brief       获取内存统计
+ *
+ * @param[out]  stat                统计数据
+ *
+ * @return none
+ */
+void tdd_pixel_sim_get_mem_stat(PIXEL_SIM_MEM_STAT_T *stat);
+
+/**
+ * @brief       获取主机真实单调时间，用于基准测试计时（虚拟时钟不随CPU耗时前进）
+ *
+ * @return 微秒
+ */
+unsigned long long tdd_pixel_sim_get_real_us(void);
+
+/**
+ * @brief       设置日志输出等级，低于该等级的日志不输出
+ *
+ * @param[in]   level               TAL_LOG_LEVEL_E
+ *
+ * @return none
+ */
+void tdd_pixel_sim_set_log_level(int level);
+
+#endif /* PIXEL_HOST_SIM */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDD_PIXEL_SIM_H__ */
@@ -0,0 +1,445 @@
+/**
+ * @file tdd_pixel_trace.c
+ * @author www.tuya.com
+ * @brief tdd_pixel_trace module is used to record timestamped hot-path events of the pixel pipeline
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+#include <string.h>
+#include <stdlib.h>
+#if defined(PIXEL_HOST_SIM) && (PIXEL_HOST_SIM == 1)
+#include <stdio.h>
+#endif
+
+#include "tal_log.h"
+#include "tal_memory.h"
+
+#include "tdd_pixel_basic.h"
+#include "tdd_pixel_trace.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#if (PIXEL_TRACE_DEPTH & (PIXEL_TRACE_DEPTH - 1)) != 0
+#error "PIXEL_TRACE_DEPTH must be a power of 2"
+#endif
+
+/* __trace_metric_print按16个桶输出 */
+#if (PIXEL_PERF_HIST_NUM != 16)
+#error "update __trace_metric_print for PIXEL_PERF_HIST_NUM"
+#endif
+
+/* 请求跟踪阶段 */
+#define TRACE_REQ_QUEUED        0   // 已提交，等待执行
+#define TRACE_REQ_APPLIED       1   // 已执行，等待刷新
+#define TRACE_REQ_REFRESHING    2   // 刷新中，等待驱动提交
+#define TRACE_REQ_SUBMITTED     3   // 所在帧已提交，等待发送完成
+
+/* 导出日志的行标记与字段数（seq,ts_us,type,arg8,arg16,arg） */
+#define TRACE_LINE_TAG          "PIXEL_TRACE,"
+#define TRACE_CLOCK_TAG         "PIXEL_TRACE_CLOCK,"
+#define TRACE_LINE_FIELD_NUM    6
+#define TRACE_LINE_MAX          256
+/* 日志中没有计时精度时按目标板默认的毫秒时钟 */
+#define TRACE_TARGET_TICK_US    1000
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    unsigned int ticket;            // 命令序号
+    unsigned int ts_us;             // 提交时间
+    unsigned int frame;             // 所在的驱动帧序号
+    unsigned char stage;
+} TRACE_REQ_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+static PIXEL_TRACE_EVT_T trace_ring[PIXEL_TRACE_DEPTH];
+static unsigned int trace_pos = 0;      // 下一个写入序号，原子操作
+static unsigned int trace_base = 0;     // 清空时的写入序号，之前的事件不再读出
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+/**
+* @brief       记录一个事件，一般通过PIXEL_TRACE调用
+*
+* @param[in]   type                事件类型
+* @param[in]   arg8                参数
+* @param[in]   arg16               参数
+* @param[in]   arg                 参数
+*
+* @return none
+*/
+void tdd_pixel_trace(PIXEL_TRACE_TYPE_E type, unsigned char arg8, unsigned short arg16, unsigned int arg)
+{
+    unsigned int pos = __atomic_fetch_add(&trace_pos, 1, __ATOMIC_RELAXED);
+    PIXEL_TRACE_EVT_T *evt = &trace_ring[pos & (PIXEL_TRACE_DEPTH - 1)];
+
+    /* 先清seq再写内容，读取方据此识别正在写入的事件 */
+    __atomic_store_n(&evt->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    evt->ts_us = (unsigned int)PIXEL_PERF_NOW_US();
+    evt->arg = arg;
+    evt->arg16 = arg16;
+    evt->type = type;
+    evt->arg8 = arg8;
+    __atomic_store_n(&evt->seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+/**
+* @brief       按时间顺序拷贝事件环中的事件，跳过读取时正在写入的事件
+*
+* @param[out]  evt                 事件缓存
+* @param[in]   max                 缓存可容纳的事件数，不足时只拷贝最新的事件
+*
+* @return 拷贝的事件数
+*/
+unsigned int tdd_pixel_trace_dump(PIXEL_TRACE_EVT_T *evt, unsigned int max)
+{
+    unsigned int pos = __atomic_load_n(&trace_pos, __ATOMIC_ACQUIRE);
+    unsigned int base = __atomic_load_n(&trace_base, __ATOMIC_RELAXED);
+    unsigned int start = 0, i = 0, num = 0, seq = 0;
+    const PIXEL_TRACE_EVT_T *src = NULL;
+
+    if (NULL == evt || 0 == max) {
+        return 0;
+    }
+
+    start = pos - base;
+    if (start > PIXEL_TRACE_DEPTH) {
+        start = PIXEL_TRACE_DEPTH;
+    }
+    if (start > max) {
+        start = max;
+    }
+    start = pos - start;
+
+    for (i = start; i != pos; i++) {
+        src = &trace_ring[i & (PIXEL_TRACE_DEPTH - 1)];
+        seq = __atomic_load_n(&src->seq, __ATOMIC_ACQUIRE);
+        if (seq != i + 1) {
+            continue;
+        }
+        memcpy(&evt[num], src, sizeof(PIXEL_TRACE_EVT_T));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        /* 拷贝期间被覆盖 */
+        if (__atomic_load_n(&src->seq, __ATOMIC_RELAXED) != seq) {
+            continue;
+        }
+        evt[num].seq = seq;
+        num++;
+    }
+
+    return num;
+}
+
+/**
+* @brief       清空事件环
+*
+* @return none
+*/
+void tdd_pixel_trace_clear(void)
+{
+    __atomic_store_n(&trace_base, __atomic_load_n(&trace_pos, __ATOMIC_ACQUIRE), __ATOMIC_RELAXED);
+}
+
+/**
+* @brief       按行输出事件到日志，每行为 PIXEL_TRACE,seq,ts_us,type,arg8,arg16,arg，便于导出到主机
+*
+* 事件前先输出一行 PIXEL_TRACE_CLOCK,tick_us 记录计时精度
+*
+* @param[in]   evt                 事件
+* @param[in]   num                 事件数
+*
+* @return none
+*/
+void tdd_pixel_trace_print(const PIXEL_TRACE_EVT_T *evt, unsigned int num)
+{
+    unsigned int i = 0;
+
+    if (NULL == evt) {
+        return;
+    }
+
+    TAL_PR_NOTICE("PIXEL_TRACE_CLOCK,%u", tdd_pixel_perf_tick_us());
+    for (i = 0; i < num; i++) {
+        TAL_PR_NOTICE("PIXEL_TRACE,%u,%u,%u,%u,%u,%u", evt[i].seq, evt[i].ts_us, evt[i].type,
+                      evt[i].arg8, evt[i].arg16, evt[i].arg);
+    }
+}
+
+/**
+ * @brief 请求推进到下一阶段：from阶段中满足条件的请求进入to阶段
+ */
+static void __trace_req_advance(TRACE_REQ_T *req, unsigned int req_num, unsigned char from, unsigned char to,
+                                unsigned int frame)
+{
+    unsigned int i = 0;
+
+    for (i = 0; i < req_num; i++) {
+        if (req[i].stage == from) {
+            req[i].stage = to;
+            req[i].frame = frame;
+        }
+    }
+}
+
+/**
+ * @brief 点亮：记录延迟并移出跟踪列表，all为TRUE时刷新中的请求全部点亮，否则只点亮帧序号不大于frame的请求
+ */
+static unsigned int __trace_req_light(TRACE_REQ_T *req, unsigned int req_num, unsigned char stage,
+                                      BOOL_T all, unsigned int frame, unsigned int ts_us,
+                                      PIXEL_TRACE_REPORT_T *report)
+{
+    unsigned int i = 0, num = 0;
+
+    for (i = 0; i < req_num; i++) {
+        if (req[i].stage == stage && (all || (int)(req[i].frame - frame) <= 0)) {
+            tdd_pixel_perf_record_us(&report->light_latency_us, ts_us - req[i].ts_us);
+        } else {
+            req[num++] = req[i];
+        }
+    }
+
+    return num;
+}
+
+/**
+* @brief       统计节拍抖动与请求到点亮的延迟
+*
+* @param[in]   evt                 按时间顺序的事件（tdd_pixel_trace_dump的输出）
+* @param[in]   num                 事件数
+* @param[out]  report              统计结果
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdd_pixel_trace_analyze(const PIXEL_TRACE_EVT_T *evt, unsigned int num, PIXEL_TRACE_REPORT_T *report)
+{
+    TRACE_REQ_T req[PIXEL_TRACE_REQ_PENDING_MAX];
+    const PIXEL_TRACE_EVT_T *e = NULL, *last_tick = NULL;
+    unsigned int req_num = 0, i = 0, j = 0;
+    int jitter = 0;
+
+    if (NULL == evt || NULL == report) {
+        return OPRT_INVALID_PARM;
+    }
+
+    memset(report, 0, sizeof(PIXEL_TRACE_REPORT_T));
+    report->clock_tick_us = tdd_pixel_perf_tick_us();
+
+    for (i = 0; i < num; i++) {
+        e = &evt[i];
+        if (i > 0 && e->seq != evt[i - 1].seq + 1) {
+            report->lost += e->seq - evt[i - 1].seq - 1;
+        }
+        report->events++;
+
+        switch (e->type) {
+            case PIXEL_TRACE_STATE_REQ:
+                if (req_num >= PIXEL_TRACE_REQ_PENDING_MAX) {
+                    report->req_unmatched++;
+                    break;
+                }
+                req[req_num].ticket = e->arg;
+                req[req_num].ts_us = e->ts_us;
+                req[req_num].frame = 0;
+                req[req_num].stage = TRACE_REQ_QUEUED;
+                req_num++;
+                break;
+
+            case PIXEL_TRACE_STATE_APPLY:
+                /* 同一批取出的命令按图层合并，序号不大于已执行命令的请求都已生效 */
+                for (j = 0; j < req_num; j++) {
+                    if (TRACE_REQ_QUEUED == req[j].stage && (int)(req[j].ticket - e->arg) <= 0) {
+                        req[j].stage = TRACE_REQ_APPLIED;
+                    }
+                }
+                break;
+
+            case PIXEL_TRACE_REFRESH:
+                __trace_req_advance(req, req_num, TRACE_REQ_APPLIED, TRACE_REQ_REFRESHING, 0);
+                break;
+
+            case PIXEL_TRACE_FRAME_SUBMIT:
+                __trace_req_advance(req, req_num, TRACE_REQ_REFRESHING, TRACE_REQ_SUBMITTED, e->arg);
+                break;
+
+            case PIXEL_TRACE_FRAME_SKIP:
+                /* 帧与已发送的帧相同，画面已是请求的结果 */
+                req_num = __trace_req_light(req, req_num, TRACE_REQ_REFRESHING, TRUE, 0, e->ts_us, report);
+                break;
+
+            case PIXEL_TRACE_REFRESH_END:
+                /* 刷新失败未提交，等待下一次刷新 */
+                __trace_req_advance(req, req_num, TRACE_REQ_REFRESHING, TRACE_REQ_APPLIED, 0);
+                break;
+
+            case PIXEL_TRACE_SPI_DONE:
+                req_num = __trace_req_light(req, req_num, TRACE_REQ_SUBMITTED, FALSE, e->arg, e->ts_us, report);
+                break;
+
+            case PIXEL_TRACE_TICK:
+                if (last_tick) {
+                    jitter = (int)((e->ts_us - last_tick->ts_us) - (e->arg - last_tick->arg) * 1000U);
+                    tdd_pixel_perf_record_us(&report->tick_jitter_us, (unsigned int)((jitter < 0) ? -jitter : jitter));
+                }
+                last_tick = e;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    report->req_unmatched += req_num;
+
+    return OPRT_OK;
+}
+
+/**
+* @brief       解析一行导出的事件
+*
+* @param[in]   line                一行日志
+* @param[out]  evt                 事件
+*
+* @return OPRT_OK on success. OPRT_NOT_FOUND 不是事件行
+*/
+OPERATE_RET tdd_pixel_trace_parse_line(const char *line, PIXEL_TRACE_EVT_T *evt)
+{
+    unsigned long val[TRACE_LINE_FIELD_NUM];
+    const char *p = NULL;
+    char *end = NULL;
+    unsigned int i = 0;
+
+    if (NULL == line || NULL == evt) {
+        return OPRT_INVALID_PARM;
+    }
+
+    /* 跳过日志前缀（时间、级别、文件名等） */
+    p = strstr(line, TRACE_LINE_TAG);
+    if (NULL == p) {
+        return OPRT_NOT_FOUND;
+    }
+    p += strlen(TRACE_LINE_TAG);
+
+    for (i = 0; i < TRACE_LINE_FIELD_NUM; i++) {
+        val[i] = strtoul(p, &end, 10);
+        if (end == p || (i + 1 < TRACE_LINE_FIELD_NUM && ',' != *end)) {
+            return OPRT_NOT_FOUND;
+        }
+        p = end + 1;
+    }
+
+    evt->seq = (unsigned int)val[0];
+    evt->ts_us = (unsigned int)val[1];
+    evt->type = (PIXEL_TRACE_TYPE_E)val[2];
+    evt->arg8 = (unsigned char)val[3];
+    evt->arg16 = (unsigned short)val[4];
+    evt->arg = (unsigned int)val[5];
+
+    return OPRT_OK;
+}
+
+#if defined(PIXEL_HOST_SIM) && (PIXEL_HOST_SIM == 1)
+/**
+* @brief       读取保存的日志（一次tdd_pixel_trace_print的输出）并统计，仅主机仿真可用
+*
+* @param[in]   path                日志文件
+* @param[out]  report              统计结果
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdd_pixel_trace_analyze_file(const char *path, PIXEL_TRACE_REPORT_T *report)
+{
+    OPERATE_RET ret = OPRT_OK;
+    FILE *fp = NULL;
+    char line[TRACE_LINE_MAX];
+    PIXEL_TRACE_EVT_T *evt = NULL, tmp;
+    const char *p = NULL;
+    unsigned int num = 0, max = 0, tick_us = TRACE_TARGET_TICK_US;
+
+    if (NULL == path || NULL == report) {
+        return OPRT_INVALID_PARM;
+    }
+
+    fp = fopen(path, "r");
+    if (NULL == fp) {
+        return OPRT_COM_ERROR;
+    }
+
+    /* 先计数再按事件数申请，一次导出的事件数不超过目标板的缓存 */
+    while (fgets(line, sizeof(line), fp)) {
+        if (OPRT_OK == tdd_pixel_trace_parse_line(line, &tmp)) {
+            max++;
+        }
+    }
+    if (0 == max) {
+        fclose(fp);
+        return OPRT_NOT_FOUND;
+    }
+    evt = (PIXEL_TRACE_EVT_T *)tal_malloc(max * sizeof(PIXEL_TRACE_EVT_T));
+    if (NULL == evt) {
+        fclose(fp);
+        return OPRT_MALLOC_FAILED;
+    }
+
+    rewind(fp);
+    while (fgets(line, sizeof(line), fp)) {
+        p = strstr(line, TRACE_CLOCK_TAG);
+        if (p) {
+            tick_us = (unsigned int)strtoul(p + strlen(TRACE_CLOCK_TAG), NULL, 10);
+            continue;
+        }
+        if (num < max && OPRT_OK == tdd_pixel_trace_parse_line(line, &evt[num])) {
+            num++;
+        }
+    }
+    fclose(fp);
+
+    ret = tdd_pixel_trace_analyze(evt, num, report);
+    /* 统计粒度取目标板的计时精度，而不是主机的 */
+    report->clock_tick_us = tick_us ? tick_us : TRACE_TARGET_TICK_US;
+    tal_free(evt);
+
+    return ret;
+}
+#endif
+
+/**
+ * @brief 输出一项统计
+ */
+static void __trace_metric_print(const char *name, const PIXEL_PERF_METRIC_T *metric)
+{
+    TAL_PR_NOTICE("PIXEL_TRACE_STAT,%s,%u,%u,%u,%u", name, metric->count, metric->min,
+                  tdd_pixel_perf_avg(metric), metric->max);
+    TAL_PR_NOTICE("PIXEL_TRACE_HIST,%s,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u", name,
+                  metric->hist[0], metric->hist[1], metric->hist[2], metric->hist[3],
+                  metric->hist[4], metric->hist[5], metric->hist[6], metric->hist[7],
+                  metric->hist[8], metric->hist[9], metric->hist[10], metric->hist[11],
+                  metric->hist[12], metric->hist[13], metric->hist[14], metric->hist[15]);
+}
+
+/**
+* @brief       输出统计结果到日志
+*
+* @param[in]   report              统计结果
+*
+* @return none
+*/
+void tdd_pixel_trace_report_print(const PIXEL_TRACE_REPORT_T *report)
+{
+    if (NULL == report) {
+        return;
+    }
+
+    TAL_PR_NOTICE("PIXEL_TRACE_REPORT,events %u,lost %u,unmatched %u,clock_tick_us %u", report->events,
+                  report->lost, report->req_unmatched, report->clock_tick_us);
+    __trace_metric_print("tick_jitter_us", &report->tick_jitter_us);
+    __trace_metric_print("light_latency_us", &report->light_latency_us);
+}
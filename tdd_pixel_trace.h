@@ -0,0 +1,191 @@
+/**
+ * @file tdd_pixel_trace.h
+ * @author www.tuya.com
+ * @brief tdd_pixel_trace module is used to record timestamped hot-path events of the pixel pipeline
+ *
+ * 固定长度的二进制事件环：写入只占用一次原子加与几次存储，可在任意线程与中断中调用，
+ * 写满后覆盖最旧的事件。事件时间戳取自PIXEL_PERF_NOW_US（微秒，32位回绕）。
+ * tdd_pixel_trace_dump按时间顺序拷贝出事件，tdd_pixel_trace_analyze对拷贝出的事件
+ * （目标板上，或导出到主机后）统计渲染节拍抖动与状态请求到点亮的延迟。
+ * 导出到主机：目标板用tdd_pixel_trace_print输出日志，主机仿真构建中用
+ * tdd_pixel_trace_analyze_file读取保存的日志，得到同样的统计与直方图。
+ * 计时精度见tdd_pixel_perf_tick_us：目标板默认为毫秒时钟，配置PIXEL_PERF_TIMER_ID后由硬件定时器提供微秒精度；
+ * 毫秒时钟下节拍抖动与延迟以1000us为粒度，小于一个计时单位的抖动不可见。
+ *
+ * 事件参数约定：
+ *   PIXEL_TRACE_STATE_REQ     arg8 状态  arg16 参数  arg 命令序号
+ *   PIXEL_TRACE_STATE_APPLY   arg8 状态             arg 命令序号
+ *   PIXEL_TRACE_TICK                     arg16 延迟ms arg 截止时间ms
+ *   PIXEL_TRACE_REFRESH                              arg 渲染帧序号
+ *   PIXEL_TRACE_REFRESH_END              arg16 结果
+ *   PIXEL_TRACE_FRAME_SUBMIT  arg8 端口             arg 驱动帧序号
+ *   PIXEL_TRACE_SPI_DONE      arg8 端口  arg16 结果  arg 驱动帧序号
+ *   PIXEL_TRACE_FRAME_SKIP    arg8 端口
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+
+#ifndef __TDD_PIXEL_TRACE_H__
+#define __TDD_PIXEL_TRACE_H__
+
+#include "tdd_pixel_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#ifndef PIXEL_TRACE_ENABLE
+#define PIXEL_TRACE_ENABLE             1
+#endif
+
+/* 事件环长度，必须为2的幂，每个事件16字节 */
+#ifndef PIXEL_TRACE_DEPTH
+#define PIXEL_TRACE_DEPTH              128
+#endif
+
+/* 统计请求到点亮延迟时同时跟踪的最大请求数 */
+#define PIXEL_TRACE_REQ_PENDING_MAX    32
+
+/* 事件类型 */
+typedef unsigned char PIXEL_TRACE_TYPE_E;
+#define PIXEL_TRACE_STATE_REQ          0x01    // 提交状态命令
+#define PIXEL_TRACE_STATE_APPLY        0x02    // 渲染线程执行状态命令
+#define PIXEL_TRACE_TICK               0x03    // 渲染节拍
+#define PIXEL_TRACE_REFRESH            0x04    // 开始刷新（提交驱动）
+#define PIXEL_TRACE_REFRESH_END        0x05    // 刷新返回
+#define PIXEL_TRACE_FRAME_SUBMIT       0x06    // 驱动提交发送
+#define PIXEL_TRACE_SPI_DONE           0x07    // 驱动SPI发送完成
+#define PIXEL_TRACE_FRAME_SKIP         0x08    // 驱动判定帧未变化，跳过发送
+
+#if (PIXEL_TRACE_ENABLE == 1)
+#define PIXEL_TRACE(type, arg8, arg16, arg) tdd_pixel_trace((type), (arg8), (arg16), (arg))
+#else
+#define PIXEL_TRACE(type, arg8, arg16, arg) ((void)0)
+#endif
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    unsigned int seq;               // 写入序号 + 1，0为未写入或正在写入
+    unsigned int ts_us;             // 时间戳
+    unsigned int arg;
+    unsigned short arg16;
+    PIXEL_TRACE_TYPE_E type;
+    unsigned char arg8;
+} PIXEL_TRACE_EVT_T;
+
+typedef struct {
+    unsigned int events;            // 参与统计的事件数
+    unsigned int lost;              // 被覆盖或读取时正在写入而缺失的事件数
+    unsigned int req_unmatched;     // 事件结束时仍未点亮或超出跟踪上限的请求数
+    unsigned int clock_tick_us;     // 事件时间戳的计时精度，统计值以此为粒度
+    PIXEL_PERF_METRIC_T tick_jitter_us;     // 相邻节拍实际间隔与计划间隔之差的绝对值
+    PIXEL_PERF_METRIC_T light_latency_us;   // 状态请求到所在帧SPI发送完成（或判定无需发送）的延迟
+} PIXEL_TRACE_REPORT_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+/**
+ * @brief       记录一个事件，一般通过PIXEL_TRACE调用
+ *
+ * @param[in]   type                事件类型
+ * @param[in]   arg8                参数
+ * @param[in]   arg16               参数
+ * @param[in]   arg                 参数
+ *
+ * @return none
+ */
+void tdd_pixel_trace(PIXEL_TRACE_TYPE_E type, unsigned char arg8, unsigned short arg16, unsigned int arg);
+
+/**
+ * @brief       按时间顺序拷贝事件环中的事件，跳过读取时正在写入的事件
+ *
+ * @param[out]  evt                 事件缓存
+ * @param[in]   max                 缓存可容纳的事件数，不足时只拷贝最新的事件
+ *
+ * @return 拷贝的事件数
+ */
+unsigned int tdd_pixel_trace_dump(PIXEL_TRACE_EVT_T *evt, unsigned int max);
+
+/**
+ * @brief       清空事件环
+ *
+ * @return none
+ */
+void tdd_pixel_trace_clear(void);
+
+/**
+ * @brief       按行输出事件到日志，每行为 PIXEL_TRACE,seq,ts_us,type,arg8,arg16,arg，便于导出到主机
+ *
+ * 事件前先输出一行 PIXEL_TRACE_CLOCK,tick_us 记录计时精度
+ *
+ * @param[in]   evt                 事件
+ * @param[in]   num                 事件数
+ *
+ * @return none
+ */
+void tdd_pixel_trace_print(const PIXEL_TRACE_EVT_T *evt, unsigned int num);
+
+/**
+ * @brief       统计节拍抖动与请求到点亮的延迟
+ *
+ * 请求在序号不小于它的命令被执行后，随其后的第一次刷新提交，
+ * 以该帧的SPI_DONE（或FRAME_SKIP）作为点亮时间
+ *
+ * @param[in]   evt                 按时间顺序的事件（tdd_pixel_trace_dump的输出）
+ * @param[in]   num                 事件数
+ * @param[out]  report              统计结果
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_trace_analyze(const PIXEL_TRACE_EVT_T *evt, unsigned int num, PIXEL_TRACE_REPORT_T *report);
+
+/**
+ * @brief       解析一行导出的事件
+ *
+ * 行中 PIXEL_TRACE, 之前的日志前缀被忽略
+ *
+ * @param[in]   line                一行日志
+ * @param[out]  evt                 事件
+ *
+ * @return OPRT_OK on success. OPRT_NOT_FOUND 不是事件行
+ */
+OPERATE_RET tdd_pixel_trace_parse_line(const char *line, PIXEL_TRACE_EVT_T *evt);
+
+#if defined(PIXEL_HOST_SIM) && (PIXEL_HOST_SIM == 1)
+/**
+ * @brief       读取保存的日志（一次tdd_pixel_trace_print的输出）并统计，仅主机仿真可用
+ *
+ * 计时精度取日志中的 PIXEL_TRACE_CLOCK 行，没有时按目标板默认的1000us
+ *
+ * @param[in]   path                日志文件
+ * @param[out]  report              统计结果
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_pixel_trace_analyze_file(const char *path, PIXEL_TRACE_REPORT_T *report);
+#endif
+
+/**
+ * @brief       输出统计结果到日志
+ *
+ * @param[in]   report              统计结果
+ *
+ * @return none
+ */
+void tdd_pixel_trace_report_print(const PIXEL_TRACE_REPORT_T *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDD_PIXEL_TRACE_H__ */
@@ -34,12 +34,56 @@ typedef unsigned char RGB_ORDER_MODE_E;
 #define BRG_ORDER 0x04
 #define BGR_ORDER 0x05
 
+/* 每个WS2812数据位占用的SPI位数，决定发送缓存大小与SPI频率 */
+typedef unsigned char PIXEL_SPI_CODE_MODE_E;
+#define PIXEL_SPI_CODE_8BIT 0x00  // 8 SPI位/数据位 @4.5MHz
+#define PIXEL_SPI_CODE_4BIT 0x01  // 4 SPI位/数据位 @3.2MHz
+#define PIXEL_SPI_CODE_3BIT 0x02  // 3 SPI位/数据位 @2.4MHz
+
+/* 打包的8位像素帧格式，颜色按R、G、B(、W)顺序存放 */
+typedef unsigned char PIXEL_FRAME_FMT_E;
+#define PIXEL_FRAME_FMT_RGB888   0x00  // 3字节/像素
+#define PIXEL_FRAME_FMT_RGBX8888 0x01  // 4字节/像素，按字对齐，第4字节不使用
+#define PIXEL_FRAME_FMT_RGBW8888 0x02  // 4字节/像素，第4字节为白色通道
+
+#define PIXEL_FRAME_BYTES_PER_PIXEL(fmt) ((PIXEL_FRAME_FMT_RGB888 == (fmt)) ? 3 : 4)
+
+typedef struct {
+    PIXEL_FRAME_FMT_E fmt;
+    unsigned short pixel_num;
+    unsigned char *data;       // pixel_num * PIXEL_FRAME_BYTES_PER_PIXEL(fmt)字节
+} PIXEL_FRAME_T;
+
+/* 芯片型号，决定帧间复位（锁存）低电平时间，0为最保守的WS2812B */
+typedef unsigned char PIXEL_CHIP_E;
+#define PIXEL_CHIP_WS2812B  0x00  // 复位 >= 280us
+#define PIXEL_CHIP_WS2812   0x01  // 复位 >= 50us
+#define PIXEL_CHIP_SK6812   0x02  // 复位 >= 80us
+/* 时钟+数据两线制芯片，使用tdd_pixel_apa102驱动 */
+#define PIXEL_CHIP_APA102   0x03
+#define PIXEL_CHIP_SK9822   0x04  // 结束帧前需额外的复位帧
 
 typedef struct {
     TUYA_SPI_NUM_E port;
     RGB_ORDER_MODE_E line_seq;
+    PIXEL_SPI_CODE_MODE_E code_mode;
+    PIXEL_CHIP_E chip;
+    unsigned char chan_num;    // 颜色通道数：3为RGB，4为RGBW（如SK6812 RGBW，W在线序之后发送），0按3处理
+    unsigned short stream_px;  // 流式发送每块像素数：按块边编码边发送，发送缓存只占2块，0为整帧编码
 } PIXEL_DRIVER_CONFIG_T;
 
+/* 性能计数：桶0统计0，桶i（i>=1）统计[2^(i-1), 2^i)，最后一桶包含所有更大的值；
+ * tdd_pixel_perf_record_us记录的耗时按计时单位（tdd_pixel_perf_tick_us）分桶，桶0为不足1个单位 */
+#define PIXEL_PERF_HIST_NUM 16
+
+typedef struct {
+    unsigned int count;
+    unsigned int min;
+    unsigned int max;
+    unsigned long long sum;
+    unsigned int hist[PIXEL_PERF_HIST_NUM];
+} PIXEL_PERF_METRIC_T;
+
 typedef struct {
     UINT_T                  pwm_freq;       // pwm frequency (Hz)
     BOOL_T                  active_level;   // true means active high, false means active low
@@ -9,14 +9,21 @@
  *
  */
 #include "string.h"
+#include "math.h"
 #include "tuya_iot_config.h"
 
 
 #include "tal_log.h"
+#include "tal_memory.h"
+#include "tal_system.h"
+#include "tal_thread.h"
+#include "tal_semaphore.h"
+#include "tal_mutex.h"
 #include "tkl_spi.h"
 
 #include "tdl_pixel_driver.h"
 #include "tdd_pixel_basic.h"
+#include "tdd_pixel_trace.h"
 #include "tdd_pixel_ws2812.h"
 /*********************************************************************
 ******************************macro define****************************
@@ -28,96 +35,1527 @@
 #define DRVICE_DATA_0 0XC0   //11000000
 #define DRVICE_DATA_1 0xFC//0XF0   //11110000
 
+/* 4位码型：3.2MHz下每位312.5ns，0码T0H=312ns，1码T1H=937ns */
+#define DRV_SPI_SPEED_4BIT   3200000
+#define DRVICE_DATA_0_4BIT   0x08   //1000
+#define DRVICE_DATA_1_4BIT   0x0E   //1110
+
+/* 3位码型：2.4MHz下每位417ns，0码T0H=417ns，1码T1H=833ns */
+#define DRV_SPI_SPEED_3BIT   2400000
+#define DRVICE_DATA_0_3BIT   0x04   //100
+#define DRVICE_DATA_1_3BIT   0x06   //110
+
 #define COLOR_PRIMARY_NUM 3
+/* 单个像素的最大通道数（RGBW），白色通道在R、G、B之后 */
+#define COLOR_CHANNEL_MAX 4
+#define COLOR_W_IDX       3
 #define COLOR_RESOLUTION  255
 
-/*********************************************************************
-****************************typedef define****************************
-*********************************************************************/
+/* 异步模式下的双缓存 */
+#define WS2812_TX_BUF_NUM      2
+
+/* 流式发送的块缓存数：一块发送时编码另一块 */
+#define WS2812_STREAM_CHUNK_NUM 2
+
+#define WS2812_TX_THREAD_STACK 1024
+#define WS2812_TX_THREAD_PRIO  THREAD_PRIO_1
+
+/* 伽马值x10的线性值，线性且亮度、通道校正均为255时直接使用码型查找表 */
+#define WS2812_GAMMA_LINEAR    10
+
+/* 编码帧缓存：帧的键在最近未命中记录中再次出现才写入缓存，不重复的动画帧与周期长于记录的
+ * 渐变（如呼吸）不会每帧申请、拷贝、淘汰条目；任意32位值都可能是键，记录按槽位标记有效，
+ * 槽位数不超过cache_admit_valid的位数 */
+#define WS2812_CACHE_ADMIT_NUM 8
+#define WS2812_FNV_OFFSET      2166136261u
+#define WS2812_FNV_PRIME       16777619u
+
+/* 生成一个编码函数：线序（第k个发送分量取R、G、B中的Ik）与码型长度均为编译期常量，
+ * 线序置换折叠为源数据与查找表的固定偏移，只编码与该缓存上次编码结果不同的像素 */
+#define WS2812_ENCODE_FUNC_DEFINE(NAME, LUT_FUNC, CODE_LEN, I0, I1, I2)                             \
+static unsigned int NAME(struct ws2812_handle *drv, DRV_WS2812_TX_BUF_T *tx_buf,                    \
+                         const unsigned char *src, unsigned int src_step, unsigned int pixel_cnt)   \
+{                                                                                                   \
+    const DRV_PIXEL_SPI_TABLE_T *t0 = drv->chan_table[0];                                           \
+    const DRV_PIXEL_SPI_TABLE_T *t1 = drv->chan_table[1];                                           \
+    const DRV_PIXEL_SPI_TABLE_T *t2 = drv->chan_table[2];                                           \
+    unsigned char *dst = tx_buf->tx_ctrl->tx_buffer;                                                \
+    unsigned char *last = tx_buf->last_frame;                                                       \
+    BOOL_T valid = tx_buf->frame_valid;                                                             \
+    unsigned int j = 0, encoded = 0;                                                                \
+                                                                                                    \
+    for (j = 0; j < pixel_cnt; j++, src += src_step, last += COLOR_PRIMARY_NUM,                     \
+         dst += (CODE_LEN) * COLOR_PRIMARY_NUM) {                                                   \
+        if (valid && last[0] == src[0] && last[1] == src[1] && last[2] == src[2]) {                 \
+            continue;                                                                               \
+        }                                                                                           \
+        last[0] = src[0];                                                                           \
+        last[1] = src[1];                                                                           \
+        last[2] = src[2];                                                                           \
+        LUT_FUNC(t0, src[I0], dst);                                                                 \
+        LUT_FUNC(t1, src[I1], dst + (CODE_LEN));                                                    \
+        LUT_FUNC(t2, src[I2], dst + 2 * (CODE_LEN));                                                \
+        encoded++;                                                                                  \
+    }                                                                                               \
+                                                                                                    \
+    return encoded;                                                                                 \
+}
+
+/* 四通道（RGBW）编码函数：源数据为4字节/像素，R、G、B按线序发送后发送W */
+#define WS2812_ENCODE_FUNC_DEFINE_W(NAME, LUT_FUNC, CODE_LEN, I0, I1, I2)                           \
+static unsigned int NAME(struct ws2812_handle *drv, DRV_WS2812_TX_BUF_T *tx_buf,                    \
+                         const unsigned char *src, unsigned int src_step, unsigned int pixel_cnt)   \
+{                                                                                                   \
+    const DRV_PIXEL_SPI_TABLE_T *t0 = drv->chan_table[0];                                           \
+    const DRV_PIXEL_SPI_TABLE_T *t1 = drv->chan_table[1];                                           \
+    const DRV_PIXEL_SPI_TABLE_T *t2 = drv->chan_table[2];                                           \
+    const DRV_PIXEL_SPI_TABLE_T *t3 = drv->chan_table[COLOR_W_IDX];                                 \
+    unsigned char *dst = tx_buf->tx_ctrl->tx_buffer;                                                \
+    unsigned char *last = tx_buf->last_frame;                                                       \
+    BOOL_T valid = tx_buf->frame_valid;                                                             \
+    unsigned int j = 0, encoded = 0;                                                                \
+                                                                                                    \
+    for (j = 0; j < pixel_cnt; j++, src += src_step, last += COLOR_CHANNEL_MAX,                     \
+         dst += (CODE_LEN) * COLOR_CHANNEL_MAX) {                                                   \
+        if (valid && last[0] == src[0] && last[1] == src[1] && last[2] == src[2] &&                 \
+            last[3] == src[3]) {                                                                    \
+            continue;                                                                               \
+        }                                                                                           \
+        last[0] = src[0];                                                                           \
+        last[1] = src[1];                                                                           \
+        last[2] = src[2];                                                                           \
+        last[3] = src[3];                                                                           \
+        LUT_FUNC(t0, src[I0], dst);                                                                 \
+        LUT_FUNC(t1, src[I1], dst + (CODE_LEN));                                                    \
+        LUT_FUNC(t2, src[I2], dst + 2 * (CODE_LEN));                                                \
+        LUT_FUNC(t3, src[COLOR_W_IDX], dst + 3 * (CODE_LEN));                                       \
+        encoded++;                                                                                  \
+    }                                                                                               \
+                                                                                                    \
+    return encoded;                                                                                 \
+}
+
+/* 生成一种码型下6种线序的三通道与四通道编码函数，下标与line_seq_idx_tbl一致 */
+#define WS2812_ENCODE_ORDERS_DEFINE(SUFFIX, LUT_FUNC, CODE_LEN)                                     \
+    WS2812_ENCODE_FUNC_DEFINE(__ws2812_encode_rgb_##SUFFIX, LUT_FUNC, CODE_LEN, 0, 1, 2)            \
+    WS2812_ENCODE_FUNC_DEFINE(__ws2812_encode_rbg_##SUFFIX, LUT_FUNC, CODE_LEN, 0, 2, 1)            \
+    WS2812_ENCODE_FUNC_DEFINE(__ws2812_encode_grb_##SUFFIX, LUT_FUNC, CODE_LEN, 1, 0, 2)            \
+    WS2812_ENCODE_FUNC_DEFINE(__ws2812_encode_gbr_##SUFFIX, LUT_FUNC, CODE_LEN, 1, 2, 0)            \
+    WS2812_ENCODE_FUNC_DEFINE(__ws2812_encode_brg_##SUFFIX, LUT_FUNC, CODE_LEN, 2, 0, 1)            \
+    WS2812_ENCODE_FUNC_DEFINE(__ws2812_encode_bgr_##SUFFIX, LUT_FUNC, CODE_LEN, 2, 1, 0)            \
+    WS2812_ENCODE_FUNC_DEFINE_W(__ws2812_encode_rgbw_##SUFFIX, LUT_FUNC, CODE_LEN, 0, 1, 2)         \
+    WS2812_ENCODE_FUNC_DEFINE_W(__ws2812_encode_rbgw_##SUFFIX, LUT_FUNC, CODE_LEN, 0, 2, 1)         \
+    WS2812_ENCODE_FUNC_DEFINE_W(__ws2812_encode_grbw_##SUFFIX, LUT_FUNC, CODE_LEN, 1, 0, 2)         \
+    WS2812_ENCODE_FUNC_DEFINE_W(__ws2812_encode_gbrw_##SUFFIX, LUT_FUNC, CODE_LEN, 1, 2, 0)         \
+    WS2812_ENCODE_FUNC_DEFINE_W(__ws2812_encode_brgw_##SUFFIX, LUT_FUNC, CODE_LEN, 2, 0, 1)         \
+    WS2812_ENCODE_FUNC_DEFINE_W(__ws2812_encode_bgrw_##SUFFIX, LUT_FUNC, CODE_LEN, 2, 1, 0)
+
+#define WS2812_ENCODE_ORDERS_TABLE(SUFFIX, W)                                                       \
+    {                                                                                               \
+        [RGB_ORDER] = __ws2812_encode_rgb##W##_##SUFFIX,                                            \
+        [RBG_ORDER] = __ws2812_encode_rbg##W##_##SUFFIX,                                            \
+        [GRB_ORDER] = __ws2812_encode_grb##W##_##SUFFIX,                                            \
+        [GBR_ORDER] = __ws2812_encode_gbr##W##_##SUFFIX,                                            \
+        [BRG_ORDER] = __ws2812_encode_brg##W##_##SUFFIX,                                            \
+        [BGR_ORDER] = __ws2812_encode_bgr##W##_##SUFFIX,                                            \
+    }
+
+/*********************************************************************
+****************************typedef define****************************
+*********************************************************************/
+typedef struct {
+    unsigned char code_bits;    // 每个数据位的SPI位数
+    unsigned char code_0;       // 0码
+    unsigned char code_1;       // 1码
+    unsigned int  spi_freq;     // 对应的SPI波特率
+} WS2812_CODE_CFG_T;
+
+/* 编码帧缓存条目，结构体后紧跟SPI码流与非均匀帧的颜色数据 */
+typedef struct ws2812_cache_entry {
+    struct ws2812_cache_entry *next;
+    unsigned int hash;                  // 均匀帧为颜色值（R | G << 8 | B << 16），否则为颜色数据的哈希
+    unsigned int last_use;              // 最近一次使用的序号，淘汰最久未使用的条目
+    unsigned int size;                  // 条目占用的内存
+    BOOL_T uniform;                     // 均匀帧，以颜色为键
+    BOOL_T valid;                       // 码型或颜色校正变化后失效
+    unsigned char *code;                // SPI码流
+    unsigned char *key;                 // 非均匀帧的颜色数据（R、G、B），均匀帧为NULL
+} WS2812_CACHE_ENTRY_T;
+
+typedef struct {
+    DRV_PIXEL_TX_CTRL_T *tx_ctrl;       // SPI发送缓存
+    unsigned char *last_frame;          // 该缓存上次编码的颜色数据（线序转换前），chan_num字节/像素
+    BOOL_T frame_valid;                 // last_frame与发送缓存是否一致
+    SEM_HANDLE idle_sem;                // 缓存空闲（未在发送中），仅异步模式使用
+    WS2812_CACHE_ENTRY_T *entry;        // 最近一次提交发送的缓存条目，NULL为发送tx_buffer
+    BOOL_T chain;                       // 最近一次提交的是链式发送的纯色重复块
+    unsigned char *repeat_buf;          // 纯色重复块的码流，链式发送首次使用时申请
+    unsigned int repeat_color;          // 最近一次准备的纯色
+    BOOL_T repeat_valid;                // repeat_buf已按repeat_color编码
+    BOOL_T fill_valid;                  // tx_buffer仍为repeat_color铺满的码流，整帧编码后失效
+    unsigned int seq;                   // 最近一次提交的帧序号，用于跟踪事件
+} DRV_WS2812_TX_BUF_T;
+
+/* 流式发送的块缓存 */
+typedef struct {
+    DRV_PIXEL_TX_CTRL_T *tx_ctrl;       // 块码流，长度为一块的码流加复位零字节
+    unsigned int len;                   // 本次待发送的长度
+    BOOL_T last;                        // 帧的最后一块，码流后已补复位零字节
+    unsigned int seq;                   // 最后一块所在的帧序号
+    SEM_HANDLE idle_sem;                // 块空闲（未在发送中）
+} DRV_WS2812_CHUNK_T;
+
+struct ws2812_handle;
+
+/* 编码函数：按打开时的线序与码型选定，返回重新编码的像素数 */
+typedef unsigned int (*WS2812_ENCODE_FUNC_T)(struct ws2812_handle *drv, DRV_WS2812_TX_BUF_T *tx_buf,
+                                             const unsigned char *src, unsigned int src_step,
+                                             unsigned int pixel_cnt);
+
+typedef struct ws2812_handle {
+    PIXEL_DRIVER_CONFIG_T cfg;          // 打开时的配置（端口、线序、码型）
+    DRV_PIXEL_SPI_TABLE_T spi_table;    // 码型查找表
+    PIXEL_COLOR_CORRECTION_T color_cfg; // 颜色校正参数
+    BOOL_T color_dirty;                 // 颜色校正参数或线序变化，下一帧编码前重建查找表
+    DRV_PIXEL_SPI_TABLE_T *color_table; // 按线序位置折叠了颜色校正的查找表，恒等变换时为NULL
+    const DRV_PIXEL_SPI_TABLE_T *chan_table[COLOR_CHANNEL_MAX]; // 各线序位置编码使用的查找表
+    unsigned char seq_idx[COLOR_CHANNEL_MAX]; // 线序第i个分量对应的R、G、B(、W)下标
+    unsigned char chan_num;             // 颜色通道数（3或4）
+    WS2812_ENCODE_FUNC_T encode;        // 当前线序与码型的编码函数
+    unsigned char *shim_buf;            // 16位颜色数据或三通道帧转换为chan_num字节/像素打包帧的缓存，首次使用时申请
+    unsigned short pixel_num;           // 像素点数
+    unsigned int data_len;              // 像素码流长度
+    unsigned int reset_len;             // 码流后的复位零字节数，发送缓存长度为data_len + reset_len
+    unsigned short stream_px;           // 流式发送每块像素数，0为整帧编码
+    DRV_WS2812_CHUNK_T chunk[WS2812_STREAM_CHUNK_NUM]; // 流式发送的块缓存，发送线程按顺序交替发送
+    unsigned char chunk_idx;            // 下一块编码使用的块缓存，与发送线程的tx_idx同序
+    unsigned char back;                 // 下一帧编码使用的缓存
+    unsigned char front;                // 最近一次提交发送的缓存
+    BOOL_T sent_valid;                  // front缓存的数据已提交发送，发送结果见done_seq、done_ret
+    BOOL_T async;                       // 是否为异步双缓存模式
+    DRV_WS2812_TX_BUF_T buf[WS2812_TX_BUF_NUM];
+
+    THREAD_HANDLE tx_thread;            // 异步发送线程
+    SEM_HANDLE tx_sem;                  // 待发送帧计数（流式发送时为待发送块计数）
+    SEM_HANDLE exit_sem;                // 发送线程退出通知
+    volatile BOOL_T tx_exit;            // 发送线程退出标志
+    unsigned char tx_idx;               // 发送线程下一次发送的缓存
+    unsigned int tx_seq;                // 已提交的帧序号
+    unsigned int done_seq;              // 最近一次发送结束的帧序号，stats_mutex保护
+    OPERATE_RET done_ret;               // 其发送结果，stats_mutex保护
+
+    PIXEL_FRAME_DONE_CB done_cb;        // 帧发送完成回调
+    void *done_arg;                     // 回调参数
+    PIXEL_DRV_TX_STATS_T stats;         // 发送统计
+    MUTEX_HANDLE stats_mutex;           // 保护stats、cache_stats、perf的更新、读取、清零，以及发送结果
+
+    WS2812_CACHE_ENTRY_T *cache;        // 编码帧缓存
+    unsigned int cache_budget;          // 缓存内存上限，0为关闭
+    unsigned int cache_tick;            // 缓存使用序号
+    unsigned int cache_admit[WS2812_CACHE_ADMIT_NUM]; // 最近未命中的帧的缓存键
+    unsigned char cache_admit_valid;    // cache_admit中已写入键的槽位，按位标记
+    unsigned char cache_admit_idx;
+    WS2812_CACHE_ENTRY_T *sent_entry;   // 最近一次提交发送的缓存条目，NULL为发送缓存自身的码流
+    PIXEL_DRV_CACHE_STATS_T cache_stats;
+    PIXEL_DRV_PERF_STATS_T perf;        // 性能统计，spi_us在异步模式下由发送线程在stats_mutex内更新
+
+    unsigned short repeat_block;        // 纯色帧重复块的像素数，0为关闭
+    BOOL_T repeat_chain;                // SPI端口支持无间隔的重复块发送，否则纯色帧铺满发送缓存
+    BOOL_T sent_repeat;                 // 最近一次提交发送的是纯色帧
+    unsigned int sent_color;            // 其颜色，sent_repeat为TRUE时有效
+} DRV_WS2812_HANDLE_T;
+
+/*********************************************************************
+****************************variable define***************************
+*********************************************************************/
+/* 各芯片的复位（锁存）低电平时间，按PIXEL_CHIP_E索引 */
+static const unsigned short chip_reset_us_tbl[] = {
+    [PIXEL_CHIP_WS2812B] = 280,
+    [PIXEL_CHIP_WS2812]  = 50,
+    [PIXEL_CHIP_SK6812]  = 80,
+};
+
+static const WS2812_CODE_CFG_T code_cfg_tbl[] = {
+    [PIXEL_SPI_CODE_8BIT] = {ONE_BYTE_LEN, DRVICE_DATA_0,      DRVICE_DATA_1,      DRV_SPI_SPEED},
+    [PIXEL_SPI_CODE_4BIT] = {4,            DRVICE_DATA_0_4BIT, DRVICE_DATA_1_4BIT, DRV_SPI_SPEED_4BIT},
+    [PIXEL_SPI_CODE_3BIT] = {3,            DRVICE_DATA_0_3BIT, DRVICE_DATA_1_3BIT, DRV_SPI_SPEED_3BIT},
+};
+
+/* tdd_2812_driver_open使用的默认配置，打开时拷贝到句柄中 */
+static PIXEL_DRIVER_CONFIG_T driver_info;
+/*********************************************************************
+****************************function define***************************
+*********************************************************************/
+WS2812_ENCODE_ORDERS_DEFINE(8bit, tdd_rgb_transform_spi_data_lut, ONE_BYTE_LEN)
+WS2812_ENCODE_ORDERS_DEFINE(4bit, tdd_rgb_transform_spi_data_lut4, 4)
+WS2812_ENCODE_ORDERS_DEFINE(3bit, tdd_rgb_transform_spi_data_lut3, 3)
+
+/* 编码函数表，按码型与线序索引 */
+static const WS2812_ENCODE_FUNC_T encode_func_tbl[][BGR_ORDER + 1] = {
+    [PIXEL_SPI_CODE_8BIT] = WS2812_ENCODE_ORDERS_TABLE(8bit, ),
+    [PIXEL_SPI_CODE_4BIT] = WS2812_ENCODE_ORDERS_TABLE(4bit, ),
+    [PIXEL_SPI_CODE_3BIT] = WS2812_ENCODE_ORDERS_TABLE(3bit, ),
+};
+
+static const WS2812_ENCODE_FUNC_T encode_func_tbl_w[][BGR_ORDER + 1] = {
+    [PIXEL_SPI_CODE_8BIT] = WS2812_ENCODE_ORDERS_TABLE(8bit, w),
+    [PIXEL_SPI_CODE_4BIT] = WS2812_ENCODE_ORDERS_TABLE(4bit, w),
+    [PIXEL_SPI_CODE_3BIT] = WS2812_ENCODE_ORDERS_TABLE(3bit, w),
+};
+
+/**
+ * @brief 按线序、码型与通道数选定编码函数与各线序位置的源通道下标
+ */
+static void __ws2812_encode_select(DRV_WS2812_HANDLE_T *drv)
+{
+    tdd_rgb_line_seq_index(drv->cfg.line_seq, drv->seq_idx);
+    drv->seq_idx[COLOR_W_IDX] = COLOR_W_IDX;
+    if (COLOR_CHANNEL_MAX == drv->chan_num) {
+        drv->encode = encode_func_tbl_w[drv->cfg.code_mode][drv->cfg.line_seq];
+    } else {
+        drv->encode = encode_func_tbl[drv->cfg.code_mode][drv->cfg.line_seq];
+    }
+}
+
+/**
+ * @brief 申请一个发送缓存（SPI码流 + 复位零字节 + 对应的颜色数据）
+ */
+static OPERATE_RET __ws2812_tx_buf_create(DRV_WS2812_HANDLE_T *drv, DRV_WS2812_TX_BUF_T *tx_buf)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    unsigned short pixel_num = drv->pixel_num;
+    unsigned int tx_buf_len = drv->data_len + drv->reset_len;
+
+    tx_buf->last_frame = (unsigned char *)tal_malloc(drv->chan_num * pixel_num);
+    if (NULL == tx_buf->last_frame) {
+        return OPRT_MALLOC_FAILED;
+    }
+    /* 部分帧只写入前pixel_cnt个像素，其余像素与另一缓存比较时需有确定的值 */
+    memset(tx_buf->last_frame, 0, drv->chan_num * pixel_num);
+
+    op_ret = tdd_pixel_create_tx_ctrl(tx_buf_len, &tx_buf->tx_ctrl);
+    if (op_ret != OPRT_OK) {
+        tal_free(tx_buf->last_frame);
+        tx_buf->last_frame = NULL;
+        return op_ret;
+    }
+    tx_buf->frame_valid = FALSE;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief 释放发送缓存
+ */
+static void __ws2812_tx_buf_release(DRV_WS2812_TX_BUF_T *tx_buf)
+{
+    if (tx_buf->idle_sem) {
+        tal_semaphore_release(tx_buf->idle_sem);
+    }
+    if (tx_buf->tx_ctrl) {
+        tdd_pixel_tx_ctrl_release(tx_buf->tx_ctrl);
+    }
+    if (tx_buf->last_frame) {
+        tal_free(tx_buf->last_frame);
+    }
+    if (tx_buf->repeat_buf) {
+        tal_free(tx_buf->repeat_buf);
+    }
+    memset(tx_buf, 0, sizeof(DRV_WS2812_TX_BUF_T));
+}
+
+/**
+ * @brief 编码结果失效：下一帧全部重新编码并发送
+ */
+static void __ws2812_frame_invalidate(DRV_WS2812_HANDLE_T *drv)
+{
+    unsigned char i = 0;
+
+    WS2812_CACHE_ENTRY_T *entry = NULL;
+
+    for (i = 0; i < WS2812_TX_BUF_NUM; i++) {
+        drv->buf[i].frame_valid = FALSE;
+        drv->buf[i].repeat_valid = FALSE;
+        drv->buf[i].fill_valid = FALSE;
+    }
+    drv->sent_valid = FALSE;
+
+    /* 缓存的码流按旧的查找表编码，等待淘汰 */
+    for (entry = drv->cache; entry; entry = entry->next) {
+        entry->valid = FALSE;
+    }
+}
+
+/**
+ * @brief 像素颜色值：R | G << 8 | B << 16，四通道时W << 24
+ */
+static unsigned int __ws2812_pixel_color(const unsigned char *src, unsigned char chan_num)
+{
+    unsigned int color = src[0] | (src[1] << 8) | (src[2] << 16);
+
+    if (COLOR_CHANNEL_MAX == chan_num) {
+        color |= (unsigned int)src[COLOR_W_IDX] << 24;
+    }
+
+    return color;
+}
+
+/**
+ * @brief 判断是否为纯色帧
+ */
+static BOOL_T __ws2812_frame_uniform(const unsigned char *src, unsigned int step, unsigned int pixel_cnt,
+                                     unsigned char chan_num)
+{
+    const unsigned char *p = NULL;
+    unsigned int j = 0;
+    BOOL_T w = (COLOR_CHANNEL_MAX == chan_num) ? TRUE : FALSE;
+
+    for (j = 1, p = src + step; j < pixel_cnt; j++, p += step) {
+        if (p[0] != src[0] || p[1] != src[1] || p[2] != src[2] || (w && p[3] != src[3])) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief 计算缓存键：纯色帧为颜色值，否则为颜色数据的FNV-1a哈希
+ */
+static unsigned int __ws2812_cache_key(const unsigned char *src, unsigned int step, unsigned int pixel_cnt,
+                                       unsigned char chan_num, BOOL_T uniform)
+{
+    const unsigned char *p = NULL;
+    unsigned int hash = WS2812_FNV_OFFSET;
+    unsigned int j = 0, i = 0;
+
+    if (uniform) {
+        return __ws2812_pixel_color(src, chan_num);
+    }
+
+    for (j = 0, p = src; j < pixel_cnt; j++, p += step) {
+        for (i = 0; i < chan_num; i++) {
+            hash = (hash ^ p[i]) * WS2812_FNV_PRIME;
+        }
+    }
+
+    return hash;
+}
+
+/**
+ * @brief 按键查找有效的缓存条目，非均匀帧逐字节比较颜色数据
+ */
+static WS2812_CACHE_ENTRY_T *__ws2812_cache_lookup(DRV_WS2812_HANDLE_T *drv, unsigned int hash, BOOL_T uniform,
+                                                   const unsigned char *src, unsigned int step, unsigned int pixel_cnt)
+{
+    WS2812_CACHE_ENTRY_T *entry = NULL;
+    const unsigned char *p = NULL, *k = NULL;
+    unsigned int j = 0;
+
+    for (entry = drv->cache; entry; entry = entry->next) {
+        if (!entry->valid || entry->hash != hash || entry->uniform != uniform) {
+            continue;
+        }
+        if (uniform) {
+            return entry;
+        }
+        for (j = 0, p = src, k = entry->key; j < pixel_cnt; j++, p += step, k += drv->chan_num) {
+            if (memcmp(p, k, drv->chan_num) != 0) {
+                break;
+            }
+        }
+        if (j == pixel_cnt) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 淘汰一个条目：优先淘汰失效条目，其次最久未使用的条目，busy（在途发送的条目）不淘汰
+ *
+ * 调用前需保证除busy所在的缓存外没有在途发送，淘汰时会清除各缓存对条目的引用
+ */
+static BOOL_T __ws2812_cache_evict(DRV_WS2812_HANDLE_T *drv, const WS2812_CACHE_ENTRY_T *busy)
+{
+    WS2812_CACHE_ENTRY_T **pp = NULL, **victim = NULL;
+    WS2812_CACHE_ENTRY_T *entry = NULL;
+
+    for (pp = &drv->cache; *pp; pp = &(*pp)->next) {
+        if (*pp == busy) {
+            continue;
+        }
+        if (NULL == victim || (!(*pp)->valid && (*victim)->valid) ||
+            ((*pp)->valid == (*victim)->valid && (int)((*pp)->last_use - (*victim)->last_use) < 0)) {
+            victim = pp;
+        }
+    }
+    if (NULL == victim) {
+        return FALSE;
+    }
+
+    entry = *victim;
+    *victim = entry->next;
+    /* 同步模式下缓存可能仍引用已淘汰的条目 */
+    if (drv->buf[0].entry == entry) {
+        drv->buf[0].entry = NULL;
+    }
+    if (drv->buf[1].entry == entry) {
+        drv->buf[1].entry = NULL;
+    }
+    if (drv->sent_entry == entry) {
+        drv->sent_entry = NULL;
+        drv->sent_valid = FALSE;
+    }
+    tal_mutex_lock(drv->stats_mutex);
+    drv->cache_stats.bytes -= entry->size;
+    drv->cache_stats.entries--;
+    drv->cache_stats.evictions++;
+    tal_mutex_unlock(drv->stats_mutex);
+    tal_free(entry);
+
+    return TRUE;
+}
+
+/**
+ * @brief 将刚编码完成的码流写入缓存，帧在最近未命中记录中第二次出现才写入
+ */
+static void __ws2812_cache_insert(DRV_WS2812_HANDLE_T *drv, unsigned int hash, BOOL_T uniform,
+                                  const unsigned char *src, unsigned int step, unsigned int pixel_cnt,
+                                  const DRV_PIXEL_TX_CTRL_T *tx_ctrl)
+{
+    WS2812_CACHE_ENTRY_T *entry = NULL;
+    unsigned int size = 0, i = 0, j = 0;
+
+    for (i = 0; i < WS2812_CACHE_ADMIT_NUM; i++) {
+        if ((drv->cache_admit_valid & (1u << i)) && drv->cache_admit[i] == hash) {
+            break;
+        }
+    }
+    if (WS2812_CACHE_ADMIT_NUM == i) {
+        drv->cache_admit[drv->cache_admit_idx] = hash;
+        drv->cache_admit_valid |= (unsigned char)(1u << drv->cache_admit_idx);
+        drv->cache_admit_idx = (drv->cache_admit_idx + 1) % WS2812_CACHE_ADMIT_NUM;
+        return;
+    }
+
+    size = sizeof(WS2812_CACHE_ENTRY_T) + tx_ctrl->tx_buffer_len + (uniform ? 0 : drv->chan_num * pixel_cnt);
+    if (size > drv->cache_budget) {
+        return;
+    }
+    while (drv->cache_stats.bytes + size > drv->cache_budget) {
+        /* 调用方已等到back缓存空闲，只有另一个缓存可能在发送 */
+        if (!__ws2812_cache_evict(drv, drv->async ? drv->buf[drv->back ^ 1].entry : NULL)) {
+            return;
+        }
+    }
+
+    entry = (WS2812_CACHE_ENTRY_T *)tal_malloc(size);
+    if (NULL == entry) {
+        return;
+    }
+    entry->hash = hash;
+    entry->uniform = uniform;
+    entry->valid = TRUE;
+    entry->size = size;
+    entry->last_use = ++drv->cache_tick;
+    entry->code = (unsigned char *)(entry + 1);
+    memcpy(entry->code, tx_ctrl->tx_buffer, tx_ctrl->tx_buffer_len);
+    entry->key = NULL;
+    if (!uniform) {
+        entry->key = entry->code + tx_ctrl->tx_buffer_len;
+        for (j = 0; j < pixel_cnt; j++, src += step) {
+            memcpy(&entry->key[j * drv->chan_num], src, drv->chan_num);
+        }
+    }
+    entry->next = drv->cache;
+    drv->cache = entry;
+
+    tal_mutex_lock(drv->stats_mutex);
+    drv->cache_stats.bytes += size;
+    drv->cache_stats.entries++;
+    drv->cache_stats.inserts++;
+    tal_mutex_unlock(drv->stats_mutex);
+}
+
+/**
+ * @brief 释放所有缓存条目，调用前需保证没有在途发送
+ */
+static void __ws2812_cache_release(DRV_WS2812_HANDLE_T *drv)
+{
+    WS2812_CACHE_ENTRY_T *entry = NULL;
+    unsigned char i = 0;
+
+    while (drv->cache) {
+        entry = drv->cache;
+        drv->cache = entry->next;
+        tal_free(entry);
+    }
+    for (i = 0; i < WS2812_TX_BUF_NUM; i++) {
+        drv->buf[i].entry = NULL;
+    }
+    if (drv->sent_entry) {
+        drv->sent_entry = NULL;
+        drv->sent_valid = FALSE;
+    }
+    drv->cache_admit_valid = 0;
+    tal_mutex_lock(drv->stats_mutex);
+    drv->cache_stats.entries = 0;
+    drv->cache_stats.bytes = 0;
+    tal_mutex_unlock(drv->stats_mutex);
+}
+
+/**
+ * @brief 按颜色校正参数重建各线序位置的查找表，颜色值直接映射到校正后的SPI码型
+ */
+static OPERATE_RET __ws2812_color_table_update(DRV_WS2812_HANDLE_T *drv)
+{
+    PIXEL_COLOR_CORRECTION_T *cc = &drv->color_cfg;
+    /* 白色通道只做伽马与全局亮度校正 */
+    unsigned char gain[COLOR_CHANNEL_MAX] = {cc->r_gain, cc->g_gain, cc->b_gain, COLOR_RESOLUTION};
+    unsigned char lut[SPI_CODE_TABLE_SIZE];
+    float gamma = 0, scale = 0, level = 0;
+    unsigned int i = 0, v = 0;
+
+    if (WS2812_GAMMA_LINEAR == cc->gamma_x10 && COLOR_RESOLUTION == cc->brightness &&
+        COLOR_RESOLUTION == cc->r_gain && COLOR_RESOLUTION == cc->g_gain && COLOR_RESOLUTION == cc->b_gain) {
+        if (drv->color_table) {
+            tal_free(drv->color_table);
+            drv->color_table = NULL;
+        }
+        for (i = 0; i < COLOR_CHANNEL_MAX; i++) {
+            drv->chan_table[i] = &drv->spi_table;
+        }
+        drv->color_dirty = FALSE;
+        __ws2812_frame_invalidate(drv);
+        return OPRT_OK;
+    }
+
+    if (NULL == drv->color_table) {
+        drv->color_table = (DRV_PIXEL_SPI_TABLE_T *)tal_malloc(drv->chan_num * sizeof(DRV_PIXEL_SPI_TABLE_T));
+        if (NULL == drv->color_table) {
+            return OPRT_MALLOC_FAILED;
+        }
+    }
+
+    gamma = (float)cc->gamma_x10 / WS2812_GAMMA_LINEAR;
+
+    for (i = 0; i < drv->chan_num; i++) {
+        /* 线序位置i上发送的是seq_idx[i]（0-R，1-G，2-B，3-W）通道 */
+        scale = (float)cc->brightness * gain[drv->seq_idx[i]] / COLOR_RESOLUTION;
+        for (v = 0; v < SPI_CODE_TABLE_SIZE; v++) {
+            level = powf((float)v / COLOR_RESOLUTION, gamma) * scale + 0.5f;
+            lut[v] = (level >= COLOR_RESOLUTION) ? COLOR_RESOLUTION : (unsigned char)level;
+        }
+        tdd_pixel_spi_table_remap(&drv->spi_table, lut, &drv->color_table[i]);
+        drv->chan_table[i] = &drv->color_table[i];
+    }
+
+    drv->color_dirty = FALSE;
+    __ws2812_frame_invalidate(drv);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief 帧发送结束处理：通知上层、统计并记录发送结果，异步模式下在发送线程中调用
+ *
+ * notify为FALSE时不回调（同步发送失败，output返回错误）。回调在记录发送结果之前完成：
+ * 跳过发送的帧只在__ws2812_frame_sent为TRUE时立即回调，不会先于在途帧的回调
+ */
+static void __ws2812_frame_done(DRV_WS2812_HANDLE_T *drv, unsigned int seq, OPERATE_RET result, BOOL_T notify)
+{
+    if (notify && drv->done_cb) {
+        drv->done_cb((DRIVER_HANDLE_T)drv, result, drv->done_arg);
+    }
+
+    tal_mutex_lock(drv->stats_mutex);
+    if (OPRT_OK == result) {
+        drv->stats.frames_sent++;
+    }
+    drv->done_seq = seq;
+    drv->done_ret = result;
+    tal_mutex_unlock(drv->stats_mutex);
+}
+
+/**
+ * @brief 发送缓存最近一次提交的码流：缓存条目、链式发送的纯色重复块或tx_buffer
+ */
+static OPERATE_RET __ws2812_tx_buf_send(DRV_WS2812_HANDLE_T *drv, DRV_WS2812_TX_BUF_T *tx_buf)
+{
+    OPERATE_RET ret = OPRT_OK;
+    unsigned long long start = PIXEL_PERF_NOW_US();
+
+    if (tx_buf->entry) {
+        ret = tdd_pixel_spi_send(drv->cfg.port, tx_buf->entry->code, tx_buf->tx_ctrl->tx_buffer_len);
+    } else if (tx_buf->chain) {
+        /* 复位零字节：tx_buffer码流之后的零区 */
+        ret = tdd_pixel_spi_send_repeat(drv->cfg.port, tx_buf->repeat_buf,
+                                        drv->repeat_block * drv->spi_table.code_len * drv->chan_num, drv->data_len,
+                                        tx_buf->tx_ctrl->tx_buffer + drv->data_len, drv->reset_len);
+    } else {
+        ret = tdd_pixel_spi_send(drv->cfg.port, tx_buf->tx_ctrl->tx_buffer, tx_buf->tx_ctrl->tx_buffer_len);
+    }
+    tal_mutex_lock(drv->stats_mutex);
+    tdd_pixel_perf_record_us(&drv->perf.spi_us, (unsigned int)(PIXEL_PERF_NOW_US() - start));
+    tal_mutex_unlock(drv->stats_mutex);
+    PIXEL_TRACE(PIXEL_TRACE_SPI_DONE, drv->cfg.port, (unsigned short)ret, tx_buf->seq);
+
+    return ret;
+}
+
+/**
+ * @brief 异步发送线程：依次发送提交的缓存，码流末尾的复位零字节保证帧间复位时间，无需等待
+ */
+static void __ws2812_tx_task(void *args)
+{
+    DRV_WS2812_HANDLE_T *drv = (DRV_WS2812_HANDLE_T *)args;
+    DRV_WS2812_TX_BUF_T *tx_buf = NULL;
+    OPERATE_RET ret = OPRT_OK;
+
+    for (;;) {
+        tal_semaphore_wait(drv->tx_sem, SEM_WAIT_FOREVER);
+        if (drv->tx_exit) {
+            break;
+        }
+
+        tx_buf = &drv->buf[drv->tx_idx];
+        ret = __ws2812_tx_buf_send(drv, tx_buf);
+
+        tal_semaphore_post(tx_buf->idle_sem);
+        drv->tx_idx ^= 1;
+
+        __ws2812_frame_done(drv, tx_buf->seq, ret, TRUE);
+    }
+
+    tal_semaphore_post(drv->exit_sem);
+}
+
+/**
+ * @brief 停止异步模式：等待在途帧发送完成，退出发送线程并释放第二个缓存
+ */
+static void __ws2812_async_stop(DRV_WS2812_HANDLE_T *drv)
+{
+    unsigned char i = 0;
+
+    if (!drv->async) {
+        return;
+    }
+
+    /* 等待所有缓存空闲 */
+    for (i = 0; i < WS2812_TX_BUF_NUM; i++) {
+        tal_semaphore_wait(drv->buf[i].idle_sem, SEM_WAIT_FOREVER);
+    }
+
+    drv->tx_exit = TRUE;
+    tal_semaphore_post(drv->tx_sem);
+    tal_semaphore_wait(drv->exit_sem, SEM_WAIT_FOREVER);
+    tal_thread_delete(drv->tx_thread);
+    drv->tx_thread = NULL;
+
+    tal_semaphore_release(drv->tx_sem);
+    tal_semaphore_release(drv->exit_sem);
+    drv->tx_sem = NULL;
+    drv->exit_sem = NULL;
+
+    for (i = 0; i < WS2812_TX_BUF_NUM; i++) {
+        tal_semaphore_release(drv->buf[i].idle_sem);
+        drv->buf[i].idle_sem = NULL;
+    }
+
+    /* 保留最近一次发送的缓存作为同步模式的缓存 */
+    if (drv->front != 0) {
+        DRV_WS2812_TX_BUF_T tmp = drv->buf[0];
+        drv->buf[0] = drv->buf[1];
+        drv->buf[1] = tmp;
+    }
+    __ws2812_tx_buf_release(&drv->buf[1]);
+
+    drv->front = 0;
+    drv->back = 0;
+    drv->async = FALSE;
+}
+
+/**
+ * @brief 开启异步模式：申请第二个缓存并创建发送线程
+ */
+static OPERATE_RET __ws2812_async_start(DRV_WS2812_HANDLE_T *drv)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    unsigned char i = 0;
+    THREAD_CFG_T thrd_cfg = {
+        .stackDepth = WS2812_TX_THREAD_STACK,
+        .priority = WS2812_TX_THREAD_PRIO,
+        .thrdname = "ws2812_tx",
+    };
+
+    if (drv->async) {
+        return OPRT_OK;
+    }
+
+    op_ret = __ws2812_tx_buf_create(drv, &drv->buf[1]);
+    if (op_ret != OPRT_OK) {
+        return op_ret;
+    }
+
+    for (i = 0; i < WS2812_TX_BUF_NUM; i++) {
+        op_ret = tal_semaphore_create_init(&drv->buf[i].idle_sem, 1, 1);
+        if (op_ret != OPRT_OK) {
+            goto __ERR;
+        }
+    }
+    op_ret = tal_semaphore_create_init(&drv->tx_sem, 0, WS2812_TX_BUF_NUM);
+    if (op_ret != OPRT_OK) {
+        goto __ERR;
+    }
+    op_ret = tal_semaphore_create_init(&drv->exit_sem, 0, 1);
+    if (op_ret != OPRT_OK) {
+        goto __ERR;
+    }
+
+    drv->front = 0;
+    drv->back = 1;
+    drv->tx_idx = 1;
+    drv->tx_exit = FALSE;
+    op_ret = tal_thread_create_and_start(&drv->tx_thread, NULL, NULL, __ws2812_tx_task, drv, &thrd_cfg);
+    if (op_ret != OPRT_OK) {
+        goto __ERR;
+    }
+    drv->async = TRUE;
+
+    return OPRT_OK;
+
+__ERR:
+    TAL_PR_ERR("ws2812 async start fail:%d", op_ret);
+    if (drv->tx_sem) {
+        tal_semaphore_release(drv->tx_sem);
+        drv->tx_sem = NULL;
+    }
+    if (drv->exit_sem) {
+        tal_semaphore_release(drv->exit_sem);
+        drv->exit_sem = NULL;
+    }
+    if (drv->buf[0].idle_sem) {
+        tal_semaphore_release(drv->buf[0].idle_sem);
+        drv->buf[0].idle_sem = NULL;
+    }
+    __ws2812_tx_buf_release(&drv->buf[1]);
+    drv->front = 0;
+    drv->back = 0;
+
+    return op_ret;
+}
+
+/**
+ * @brief 流式发送线程：按顺序发送编码完成的块，最后一块发送后结束一帧
+ *
+ * 同一帧相邻两块之间线路保持低电平，间隔超过芯片复位时间会提前锁存，
+ * 下一块未编码完成时记为欠载。块的编码应快于发送，SPI连续发送（DMA链式传输）的平台上不产生间隔。
+ */
+static void __ws2812_stream_task(void *args)
+{
+    DRV_WS2812_HANDLE_T *drv = (DRV_WS2812_HANDLE_T *)args;
+    DRV_WS2812_CHUNK_T *chunk = NULL;
+    OPERATE_RET ret = OPRT_OK, frame_ret = OPRT_OK;
+    unsigned long long start = 0;
+    BOOL_T in_frame = FALSE;
+
+    for (;;) {
+        if (in_frame && tal_semaphore_wait(drv->tx_sem, 0) != OPRT_OK) {
+            tal_mutex_lock(drv->stats_mutex);
+            drv->stats.stream_underruns++;
+            tal_mutex_unlock(drv->stats_mutex);
+            tal_semaphore_wait(drv->tx_sem, SEM_WAIT_FOREVER);
+        } else if (!in_frame) {
+            tal_semaphore_wait(drv->tx_sem, SEM_WAIT_FOREVER);
+        }
+        if (drv->tx_exit) {
+            break;
+        }
+
+        chunk = &drv->chunk[drv->tx_idx];
+        if (!in_frame) {
+            in_frame = TRUE;
+            frame_ret = OPRT_OK;
+            start = PIXEL_PERF_NOW_US();
+        }
+        ret = tdd_pixel_spi_send(drv->cfg.port, chunk->tx_ctrl->tx_buffer, chunk->len);
+        if (ret != OPRT_OK) {
+            frame_ret = ret;
+        }
+
+        drv->tx_idx = (drv->tx_idx + 1) % WS2812_STREAM_CHUNK_NUM;
+        if (!chunk->last) {
+            tal_semaphore_post(chunk->idle_sem);
+            continue;
+        }
+
+        in_frame = FALSE;
+        tal_mutex_lock(drv->stats_mutex);
+        tdd_pixel_perf_record_us(&drv->perf.spi_us, (unsigned int)(PIXEL_PERF_NOW_US() - start));
+        tal_mutex_unlock(drv->stats_mutex);
+        PIXEL_TRACE(PIXEL_TRACE_SPI_DONE, drv->cfg.port, (unsigned short)frame_ret, chunk->seq);
+        tal_semaphore_post(chunk->idle_sem);
+        __ws2812_frame_done(drv, chunk->seq, frame_ret, TRUE);
+    }
+
+    tal_semaphore_post(drv->exit_sem);
+}
+
+/**
+ * @brief 停止流式发送：等待在途的块发送完成，退出发送线程并释放块缓存
+ */
+static void __ws2812_stream_stop(DRV_WS2812_HANDLE_T *drv)
+{
+    unsigned char i = 0;
+
+    if (drv->tx_thread) {
+        for (i = 0; i < WS2812_STREAM_CHUNK_NUM; i++) {
+            tal_semaphore_wait(drv->chunk[i].idle_sem, SEM_WAIT_FOREVER);
+        }
+        drv->tx_exit = TRUE;
+        tal_semaphore_post(drv->tx_sem);
+        tal_semaphore_wait(drv->exit_sem, SEM_WAIT_FOREVER);
+        tal_thread_delete(drv->tx_thread);
+        drv->tx_thread = NULL;
+    }
+
+    if (drv->tx_sem) {
+        tal_semaphore_release(drv->tx_sem);
+        drv->tx_sem = NULL;
+    }
+    if (drv->exit_sem) {
+        tal_semaphore_release(drv->exit_sem);
+        drv->exit_sem = NULL;
+    }
+    for (i = 0; i < WS2812_STREAM_CHUNK_NUM; i++) {
+        if (drv->chunk[i].idle_sem) {
+            tal_semaphore_release(drv->chunk[i].idle_sem);
+        }
+        if (drv->chunk[i].tx_ctrl) {
+            tdd_pixel_tx_ctrl_release(drv->chunk[i].tx_ctrl);
+        }
+        memset(&drv->chunk[i], 0, sizeof(DRV_WS2812_CHUNK_T));
+    }
+}
+
+/**
+ * @brief 开启流式发送：申请块缓存与颜色数据缓存，创建发送线程，不申请整帧码流缓存
+ */
+static OPERATE_RET __ws2812_stream_start(DRV_WS2812_HANDLE_T *drv)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    unsigned int chunk_len = drv->spi_table.code_len * drv->chan_num * drv->stream_px;
+    unsigned char i = 0;
+    THREAD_CFG_T thrd_cfg = {
+        .stackDepth = WS2812_TX_THREAD_STACK,
+        .priority = WS2812_TX_THREAD_PRIO,
+        .thrdname = "ws2812_stream",
+    };
+
+    /* 编码从颜色数据缓存读取整条灯带，未写入的像素为熄灭 */
+    drv->buf[0].last_frame = (unsigned char *)tal_malloc(drv->chan_num * drv->pixel_num);
+    if (NULL == drv->buf[0].last_frame) {
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(drv->buf[0].last_frame, 0, drv->chan_num * drv->pixel_num);
+
+    for (i = 0; i < WS2812_STREAM_CHUNK_NUM; i++) {
+        op_ret = tdd_pixel_create_tx_ctrl(chunk_len + drv->reset_len, &drv->chunk[i].tx_ctrl);
+        if (op_ret != OPRT_OK) {
+            goto __ERR;
+        }
+        op_ret = tal_semaphore_create_init(&drv->chunk[i].idle_sem, 1, 1);
+        if (op_ret != OPRT_OK) {
+            goto __ERR;
+        }
+    }
+    op_ret = tal_semaphore_create_init(&drv->tx_sem, 0, WS2812_STREAM_CHUNK_NUM);
+    if (op_ret != OPRT_OK) {
+        goto __ERR;
+    }
+    op_ret = tal_semaphore_create_init(&drv->exit_sem, 0, 1);
+    if (op_ret != OPRT_OK) {
+        goto __ERR;
+    }
+
+    drv->chunk_idx = 0;
+    drv->tx_idx = 0;
+    drv->tx_exit = FALSE;
+    op_ret = tal_thread_create_and_start(&drv->tx_thread, NULL, NULL, __ws2812_stream_task, drv, &thrd_cfg);
+    if (op_ret != OPRT_OK) {
+        goto __ERR;
+    }
+
+    return OPRT_OK;
+
+__ERR:
+    TAL_PR_ERR("ws2812 stream start fail:%d", op_ret);
+    __ws2812_stream_stop(drv);
+    __ws2812_tx_buf_release(&drv->buf[0]);
+
+    return op_ret;
+}
 
-/*********************************************************************
-****************************variable define***************************
-*********************************************************************/
-static PIXEL_DRIVER_CONFIG_T driver_info;
-/*********************************************************************
-****************************function define***************************
-*********************************************************************/
 /**
- * @function:tdd_2812_driver_open
- * @brief: 打开（初始化）设备
+ * @brief 最近一次提交的帧已发送成功：异步模式下仍在发送或发送失败时不能跳过下一帧
+ */
+static BOOL_T __ws2812_frame_sent(DRV_WS2812_HANDLE_T *drv)
+{
+    BOOL_T sent = FALSE;
+
+    if (!drv->sent_valid) {
+        return FALSE;
+    }
+
+    tal_mutex_lock(drv->stats_mutex);
+    sent = (drv->done_seq == drv->tx_seq && OPRT_OK == drv->done_ret) ? TRUE : FALSE;
+    tal_mutex_unlock(drv->stats_mutex);
+
+    return sent;
+}
+
+/**
+ * @brief 判断新编码的帧是否与最近一次发出的帧相同
+ */
+static BOOL_T __ws2812_frame_unchanged(DRV_WS2812_HANDLE_T *drv, unsigned int encoded)
+{
+    if (drv->sent_entry || drv->buf[drv->front].chain || !__ws2812_frame_sent(drv)) {
+        return FALSE;
+    }
+
+    /* 同步模式只有一个缓存，没有重新编码的像素即与上一帧相同 */
+    if (drv->back == drv->front) {
+        return (0 == encoded) ? TRUE : FALSE;
+    }
+
+    return (0 == memcmp(drv->buf[drv->back].last_frame, drv->buf[drv->front].last_frame,
+                        drv->chan_num * drv->pixel_num)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief 帧与已发送的帧相同，跳过发送
+ */
+static OPERATE_RET __ws2812_frame_skip(DRV_WS2812_HANDLE_T *drv, DRV_WS2812_TX_BUF_T *tx_buf)
+{
+    tal_mutex_lock(drv->stats_mutex);
+    drv->stats.frames_skipped++;
+    tal_mutex_unlock(drv->stats_mutex);
+    PIXEL_TRACE(PIXEL_TRACE_FRAME_SKIP, drv->cfg.port, 0, 0);
+    if (drv->async) {
+        tal_semaphore_post(tx_buf->idle_sem);
+    }
+    if (drv->done_cb) {
+        drv->done_cb((DRIVER_HANDLE_T)drv, OPRT_OK, drv->done_arg);
+    }
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief 提交发送：entry不为NULL时发送缓存条目的码流，否则发送tx_buf编码的码流；
+ *        repeat为TRUE表示tx_buf准备了repeat_color的纯色帧，chain为TRUE时链式发送repeat_buf
+ */
+static OPERATE_RET __ws2812_frame_submit(DRV_WS2812_HANDLE_T *drv, DRV_WS2812_TX_BUF_T *tx_buf,
+                                         WS2812_CACHE_ENTRY_T *entry, BOOL_T repeat, BOOL_T chain)
+{
+    OPERATE_RET ret = OPRT_OK;
+
+    tx_buf->entry = entry;
+    tx_buf->chain = chain;
+    drv->sent_entry = entry;
+    drv->sent_repeat = repeat;
+    drv->sent_color = tx_buf->repeat_color;
+    drv->front = drv->back;
+    drv->sent_valid = TRUE;
+    tx_buf->seq = ++drv->tx_seq;
+    PIXEL_TRACE(PIXEL_TRACE_FRAME_SUBMIT, drv->cfg.port, 0, tx_buf->seq);
+
+    if (drv->async) {
+        drv->back ^= 1;
+        tal_semaphore_post(drv->tx_sem);
+        return OPRT_OK;
+    }
+
+    ret = __ws2812_tx_buf_send(drv, tx_buf);
+    /* 同步发送失败时返回错误，不回调 */
+    __ws2812_frame_done(drv, tx_buf->seq, ret, (OPRT_OK == ret) ? TRUE : FALSE);
+
+    return ret;
+}
+
+/**
+ * @brief 三通道帧转换为白色通道为0的RGBW帧，写入shim_buf
+ */
+static OPERATE_RET __ws2812_frame_expand_w(DRV_WS2812_HANDLE_T *drv, const unsigned char *src,
+                                           unsigned int src_step, unsigned int pixel_cnt)
+{
+    unsigned char *dst = NULL;
+    unsigned int j = 0;
+
+    if (NULL == drv->shim_buf) {
+        drv->shim_buf = (unsigned char *)tal_malloc(COLOR_CHANNEL_MAX * drv->pixel_num);
+        if (NULL == drv->shim_buf) {
+            return OPRT_MALLOC_FAILED;
+        }
+    }
+
+    for (j = 0, dst = drv->shim_buf; j < pixel_cnt; j++, src += src_step, dst += COLOR_CHANNEL_MAX) {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+        dst[COLOR_W_IDX] = 0;
+    }
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief 以buf开头的unit字节为单元按倍增拷贝铺满total字节
+ */
+static void __ws2812_buf_tile(unsigned char *buf, unsigned int unit, unsigned int total)
+{
+    unsigned int len = 0;
+
+    for (len = unit; len < total; len *= 2) {
+        memcpy(&buf[len], buf, (len * 2 > total) ? total - len : len);
+    }
+}
+
+/**
+ * @brief 编码一个像素的码流到buf开头
+ */
+static void __ws2812_pixel_encode(DRV_WS2812_HANDLE_T *drv, unsigned char *buf, const unsigned char *src)
+{
+    unsigned int i = 0;
+
+    for (i = 0; i < drv->chan_num; i++) {
+        memcpy(&buf[i * drv->spi_table.code_len], drv->chan_table[i]->code[src[drv->seq_idx[i]]].byte,
+               drv->spi_table.code_len);
+    }
+}
+
+/**
+ * @brief 准备纯色重复块：只编码一个像素，再按倍增拷贝铺满repeat_block个像素，颜色不变时直接复用
+ */
+static OPERATE_RET __ws2812_repeat_prepare(DRV_WS2812_HANDLE_T *drv, DRV_WS2812_TX_BUF_T *tx_buf,
+                                           const unsigned char *src, unsigned int color)
+{
+    unsigned int block_len = drv->repeat_block * drv->spi_table.code_len * drv->chan_num;
+
+    if (NULL == tx_buf->repeat_buf) {
+        tx_buf->repeat_buf = (unsigned char *)tal_malloc(block_len);
+        if (NULL == tx_buf->repeat_buf) {
+            return OPRT_MALLOC_FAILED;
+        }
+        tx_buf->repeat_valid = FALSE;
+    }
+    if (tx_buf->repeat_valid && tx_buf->repeat_color == color) {
+        return OPRT_OK;
+    }
+
+    __ws2812_pixel_encode(drv, tx_buf->repeat_buf, src);
+    __ws2812_buf_tile(tx_buf->repeat_buf, drv->spi_table.code_len * drv->chan_num, block_len);
+    if (tx_buf->repeat_color != color) {
+        tx_buf->fill_valid = FALSE;
+    }
+    tx_buf->repeat_color = color;
+    tx_buf->repeat_valid = TRUE;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief 纯色帧铺满发送缓存：只编码一个像素，再按倍增拷贝铺满tx_buffer的码流区与last_frame，
+ *        整帧由一次发送连续输出；tx_buffer已是该颜色时直接复用
+ *
+ * 端口不支持链式发送时使用，省去逐像素查表，但拷贝仍与帧长成正比，也不节省内存
+ */
+static void __ws2812_repeat_fill(DRV_WS2812_HANDLE_T *drv, DRV_WS2812_TX_BUF_T *tx_buf,
+                                 const unsigned char *src, unsigned int color)
+{
+    unsigned char *buf = tx_buf->tx_ctrl->tx_buffer;
+
+    if (tx_buf->frame_valid && tx_buf->fill_valid && tx_buf->repeat_color == color) {
+        return;
+    }
+
+    __ws2812_pixel_encode(drv, buf, src);
+    __ws2812_buf_tile(buf, drv->spi_table.code_len * drv->chan_num, drv->data_len);
+
+    /* last_frame与码流保持一致，之后的非纯色帧仍可逐像素比较 */
+    memcpy(tx_buf->last_frame, src, drv->chan_num);
+    __ws2812_buf_tile(tx_buf->last_frame, drv->chan_num, drv->chan_num * drv->pixel_num);
+
+    tx_buf->frame_valid = TRUE;
+    if (tx_buf->repeat_color != color) {
+        tx_buf->repeat_valid = FALSE;
+    }
+    tx_buf->repeat_color = color;
+    tx_buf->fill_valid = TRUE;
+}
+
+/**
+ * @brief 流式发送一帧：颜色数据合入last_frame后按块编码，每块编码完成即交给发送线程，
+ *        返回时最后一块可能仍在发送
+ */
+static OPERATE_RET __ws2812_stream_frame(DRV_WS2812_HANDLE_T *drv, const unsigned char *src,
+                                         unsigned int src_step, unsigned int pixel_cnt)
+{
+    DRV_WS2812_TX_BUF_T chunk_buf = {0};
+    DRV_WS2812_CHUNK_T *chunk = NULL;
+    unsigned char *frame = drv->buf[0].last_frame;
+    unsigned int pixel_len = drv->spi_table.code_len * drv->chan_num;
+    unsigned int changed = 0, pos = 0, cnt = 0, j = 0;
+    unsigned int encode_us = 0, wait_us = 0, seq = 0;
+    unsigned long long start = 0;
+
+    for (j = 0; j < pixel_cnt; j++, src += src_step, frame += drv->chan_num) {
+        if (memcmp(frame, src, drv->chan_num) != 0) {
+            memcpy(frame, src, drv->chan_num);
+            changed++;
+        }
+    }
+    if (0 == changed && __ws2812_frame_sent(drv)) {
+        return __ws2812_frame_skip(drv, &drv->buf[0]);
+    }
+
+    drv->sent_valid = TRUE;
+    seq = ++drv->tx_seq;
+    PIXEL_TRACE(PIXEL_TRACE_FRAME_SUBMIT, drv->cfg.port, 0, seq);
+
+    /* 块编码不做逐像素比较：last_frame即编码源，块缓存在各像素区间之间复用 */
+    chunk_buf.frame_valid = FALSE;
+    for (pos = 0; pos < drv->pixel_num; pos += cnt) {
+        chunk = &drv->chunk[drv->chunk_idx];
+        cnt = drv->pixel_num - pos;
+        if (cnt > drv->stream_px) {
+            cnt = drv->stream_px;
+        }
+
+        start = PIXEL_PERF_NOW_US();
+        tal_semaphore_wait(chunk->idle_sem, SEM_WAIT_FOREVER);
+        wait_us += (unsigned int)(PIXEL_PERF_NOW_US() - start);
+
+        start = PIXEL_PERF_NOW_US();
+        chunk_buf.tx_ctrl = chunk->tx_ctrl;
+        chunk_buf.last_frame = &drv->buf[0].last_frame[pos * drv->chan_num];
+        drv->encode(drv, &chunk_buf, chunk_buf.last_frame, drv->chan_num, cnt);
+        chunk->len = cnt * pixel_len;
+        chunk->last = (pos + cnt >= drv->pixel_num) ? TRUE : FALSE;
+        if (chunk->last) {
+            memset(chunk->tx_ctrl->tx_buffer + chunk->len, 0, drv->reset_len);
+            chunk->len += drv->reset_len;
+            chunk->seq = seq;
+        }
+        encode_us += (unsigned int)(PIXEL_PERF_NOW_US() - start);
+
+        tal_semaphore_post(drv->tx_sem);
+        drv->chunk_idx = (drv->chunk_idx + 1) % WS2812_STREAM_CHUNK_NUM;
+    }
+
+    tal_mutex_lock(drv->stats_mutex);
+    drv->stats.pixels_encoded += drv->pixel_num;
+    tdd_pixel_perf_record_us(&drv->perf.encode_us, encode_us);
+    tdd_pixel_perf_record_us(&drv->perf.wait_us, wait_us);
+    tal_mutex_unlock(drv->stats_mutex);
+
+    return OPRT_OK;
+}
+
+/**
+ * @function:tdd_ws2812_driver_open_cfg
+ * @brief: 按指定配置打开（初始化）设备，每个句柄独立持有端口、线序、码型与缓存，
+ *         不同SPI端口上的多个灯带可以分别打开并并发刷新
  * @param[in]: pixel_num -> 像素点数
+ * @param[in]: cfg -> 设备配置
  * @param[out]: *handle  -> 设备句柄
  * @return: success -> 0  fail -> else
  */
-OPERATE_RET tdd_2812_driver_open(OUT DRIVER_HANDLE_T *handle, IN unsigned short pixel_num)
+OPERATE_RET tdd_ws2812_driver_open_cfg(OUT DRIVER_HANDLE_T *handle, IN unsigned short pixel_num,
+                                       IN PIXEL_DRIVER_CONFIG_T *cfg)
 {
     OPERATE_RET op_ret = OPRT_OK;
     TUYA_SPI_BASE_CFG_T spi_cfg = {0};
-    DRV_PIXEL_TX_CTRL_T *pixels_send = NULL;
-    unsigned int tx_buf_len = 0;
+    DRV_WS2812_HANDLE_T *drv = NULL;
+    const WS2812_CODE_CFG_T *code_cfg = NULL;
+    unsigned char i = 0;
 
-    if (NULL == handle || (0 == pixel_num)) {
+    if (NULL == handle || (0 == pixel_num) || NULL == cfg || cfg->code_mode > PIXEL_SPI_CODE_3BIT ||
+        cfg->line_seq > BGR_ORDER || cfg->port >= TUYA_SPI_NUM_MAX || cfg->chip > PIXEL_CHIP_SK6812 ||
+        (cfg->chan_num != 0 && cfg->chan_num != COLOR_PRIMARY_NUM && cfg->chan_num != COLOR_CHANNEL_MAX)) {
         return OPRT_INVALID_PARM;
     }
+    if (tdd_pixel_spi_port_claim(cfg->port) != OPRT_OK) {
+        TAL_PR_ERR("spi port %d already opened", cfg->port);
+        return OPRT_COM_ERROR;
+    }
+
+    drv = (DRV_WS2812_HANDLE_T *)tal_malloc(sizeof(DRV_WS2812_HANDLE_T));
+    if (NULL == drv) {
+        tdd_pixel_spi_port_release(cfg->port);
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(drv, 0, sizeof(DRV_WS2812_HANDLE_T));
+    memcpy(&drv->cfg, cfg, sizeof(PIXEL_DRIVER_CONFIG_T));
+    drv->pixel_num = pixel_num;
+    drv->chan_num = (COLOR_CHANNEL_MAX == cfg->chan_num) ? COLOR_CHANNEL_MAX : COLOR_PRIMARY_NUM;
+    drv->color_cfg.gamma_x10 = WS2812_GAMMA_LINEAR;
+    drv->color_cfg.brightness = COLOR_RESOLUTION;
+    drv->color_cfg.r_gain = COLOR_RESOLUTION;
+    drv->color_cfg.g_gain = COLOR_RESOLUTION;
+    drv->color_cfg.b_gain = COLOR_RESOLUTION;
+    op_ret = tal_mutex_create_init(&drv->stats_mutex);
+    if (op_ret != OPRT_OK) {
+        tal_free(drv);
+        tdd_pixel_spi_port_release(cfg->port);
+        return op_ret;
+    }
+
+    code_cfg = &code_cfg_tbl[drv->cfg.code_mode];
+    tdd_pixel_spi_table_init(code_cfg->code_0, code_cfg->code_1, code_cfg->code_bits, &drv->spi_table);
+    for (i = 0; i < COLOR_CHANNEL_MAX; i++) {
+        drv->chan_table[i] = &drv->spi_table;
+    }
+    __ws2812_encode_select(drv);
+    /* 复位低电平按SPI时钟换算为码流末尾的零字节，连续帧之间不需要等待 */
+    drv->data_len = drv->spi_table.code_len * drv->chan_num * pixel_num;
+    drv->reset_len = tdd_pixel_reset_bytes(code_cfg->spi_freq, chip_reset_us_tbl[drv->cfg.chip]);
+
+    if (cfg->stream_px) {
+        /* 块不小于一个像素，不大于整条灯带 */
+        drv->stream_px = (cfg->stream_px > pixel_num) ? pixel_num : cfg->stream_px;
+        op_ret = __ws2812_stream_start(drv);
+    } else {
+        op_ret = __ws2812_tx_buf_create(drv, &drv->buf[0]);
+    }
+    if (op_ret != OPRT_OK) {
+        tal_mutex_release(drv->stats_mutex);
+        tal_free(drv);
+        tdd_pixel_spi_port_release(cfg->port);
+        return op_ret;
+    }
+    if (0 == drv->stream_px && drv->data_len + drv->reset_len > PIXEL_SPI_SEND_MAX) {
+        /* 整帧码流需分段发送，分段间隔超过复位时间会在帧中间锁存 */
+        TAL_PR_WARN("ws2812 frame %u bytes exceeds one spi send, needs chained dma or stream mode",
+                    drv->data_len + drv->reset_len);
+    }
+
     extern void tkl_spi_set_spic_flag(void);
     tkl_spi_set_spic_flag();
     spi_cfg.role = TUYA_SPI_ROLE_MASTER;
     spi_cfg.mode = TUYA_SPI_MODE0;
     spi_cfg.type = TUYA_SPI_SOFT_TYPE;
     spi_cfg.databits = TUYA_SPI_DATA_BIT8;
-    spi_cfg.freq_hz = DRV_SPI_SPEED;
+    spi_cfg.freq_hz = code_cfg->spi_freq;
     spi_cfg.spi_dma_flags = TRUE;
-    op_ret = tkl_spi_init(driver_info.port, &spi_cfg);
+    op_ret = tkl_spi_init(drv->cfg.port, &spi_cfg);
     if (op_ret != OPRT_OK) {
         TAL_PR_ERR("tkl_spi_init fail op_ret:%d", op_ret);
+        __ws2812_stream_stop(drv);
+        __ws2812_tx_buf_release(&drv->buf[0]);
+        tal_mutex_release(drv->stats_mutex);
+        tal_free(drv);
+        tdd_pixel_spi_port_release(cfg->port);
         return op_ret;
     }
 
-    tx_buf_len = ONE_BYTE_LEN * COLOR_PRIMARY_NUM * pixel_num;
-    op_ret = tdd_pixel_create_tx_ctrl(tx_buf_len, &pixels_send);
-    if (op_ret != OPRT_OK) {
-        return op_ret;
+    *handle = drv;
+
+    return OPRT_OK;
+}
+
+/**
+ * @function:tdd_2812_driver_open
+ * @brief: 按tdd_ws2812_driver_register注册的配置打开（初始化）设备
+ * @param[in]: pixel_num -> 像素点数
+ * @param[out]: *handle  -> 设备句柄
+ * @return: success -> 0  fail -> else
+ */
+OPERATE_RET tdd_2812_driver_open(OUT DRIVER_HANDLE_T *handle, IN unsigned short pixel_num)
+{
+    return tdd_ws2812_driver_open_cfg(handle, pixel_num, &driver_info);
+}
+
+/**
+ * @function: tdd_ws2812_driver_send_frame
+ * @brief: 将打包的8位颜色帧转换为当前芯片的线序并转换为SPI码流, 通过SPI发送
+ *         异步模式下编码完成即返回，发送在发送线程中进行，完成后通过回调通知
+ * @param[in]: handle -> 设备句柄
+ * @param[in]: *frame -> 颜色帧，像素数超过设备像素点数时截断
+ * @return: success -> 0  fail -> else
+ */
+OPERATE_RET tdd_ws2812_driver_send_frame(IN DRIVER_HANDLE_T handle, IN const PIXEL_FRAME_T *frame)
+{
+    OPERATE_RET ret = OPRT_OK;
+    DRV_WS2812_HANDLE_T *drv = NULL;
+    DRV_WS2812_TX_BUF_T *tx_buf = NULL;
+    WS2812_CACHE_ENTRY_T *entry = NULL;
+    const unsigned char *src = NULL;
+    unsigned int pixel_cnt = 0, src_step = 0, encoded = 0;
+    unsigned int hash = 0, color = 0;
+    unsigned long long start = 0;
+    BOOL_T uniform = FALSE, cacheable = FALSE, chain = FALSE;
+
+    if (NULL == handle || NULL == frame || NULL == frame->data || 0 == frame->pixel_num ||
+        frame->fmt > PIXEL_FRAME_FMT_RGBW8888) {
+        return OPRT_INVALID_PARM;
     }
 
-    *handle = pixels_send;
+    drv = (DRV_WS2812_HANDLE_T *)handle;
+    pixel_cnt = frame->pixel_num;
+    if (pixel_cnt > drv->pixel_num) {
+        pixel_cnt = drv->pixel_num;
+    }
+    src = frame->data;
+    src_step = PIXEL_FRAME_BYTES_PER_PIXEL(frame->fmt);
 
-    return OPRT_OK;
+    /* 四通道设备的RGB帧白色通道为0，转换为RGBW帧；三通道设备的RGBW帧忽略白色通道 */
+    if (COLOR_CHANNEL_MAX == drv->chan_num && frame->fmt != PIXEL_FRAME_FMT_RGBW8888) {
+        ret = __ws2812_frame_expand_w(drv, src, src_step, pixel_cnt);
+        if (ret != OPRT_OK) {
+            return ret;
+        }
+        src = drv->shim_buf;
+        src_step = COLOR_CHANNEL_MAX;
+    }
+
+    if (drv->stream_px) {
+        if (drv->color_dirty) {
+            ret = __ws2812_color_table_update(drv);
+            if (ret != OPRT_OK) {
+                return ret;
+            }
+        }
+        return __ws2812_stream_frame(drv, src, src_step, pixel_cnt);
+    }
+
+    tx_buf = &drv->buf[drv->back];
+    if (drv->async) {
+        /* 等待该缓存上一次的发送结束，帧率不超过线速时不会阻塞 */
+        start = PIXEL_PERF_NOW_US();
+        tal_semaphore_wait(tx_buf->idle_sem, SEM_WAIT_FOREVER);
+        tal_mutex_lock(drv->stats_mutex);
+        tdd_pixel_perf_record_us(&drv->perf.wait_us, (unsigned int)(PIXEL_PERF_NOW_US() - start));
+        tal_mutex_unlock(drv->stats_mutex);
+    }
+
+    /* 查找表只在编码时使用，参数变化后在编码前重建 */
+    if (drv->color_dirty) {
+        ret = __ws2812_color_table_update(drv);
+        if (ret != OPRT_OK) {
+            if (drv->async) {
+                tal_semaphore_post(tx_buf->idle_sem);
+            }
+            return ret;
+        }
+    }
+
+    /* 只处理整帧：部分帧的码流还包含缓存中未更新的像素 */
+    cacheable = (drv->cache_budget && pixel_cnt == drv->pixel_num) ? TRUE : FALSE;
+    if ((cacheable || drv->repeat_block) && pixel_cnt == drv->pixel_num) {
+        uniform = __ws2812_frame_uniform(src, src_step, pixel_cnt, drv->chan_num);
+    }
+
+    /* 纯色帧只编码一个像素：端口支持时链式发送重复块，否则（或申请失败时）铺满发送缓存后整帧发送 */
+    if (uniform && drv->repeat_block) {
+        color = __ws2812_pixel_color(src, drv->chan_num);
+        if (drv->sent_repeat && drv->sent_color == color && __ws2812_frame_sent(drv)) {
+            return __ws2812_frame_skip(drv, tx_buf);
+        }
+        chain = (drv->repeat_chain && OPRT_OK == __ws2812_repeat_prepare(drv, tx_buf, src, color)) ? TRUE : FALSE;
+        if (!chain) {
+            __ws2812_repeat_fill(drv, tx_buf, src, color);
+        }
+        tal_mutex_lock(drv->stats_mutex);
+        drv->stats.frames_repeat++;
+        tal_mutex_unlock(drv->stats_mutex);
+        return __ws2812_frame_submit(drv, tx_buf, NULL, TRUE, chain);
+    }
+
+    if (cacheable) {
+        hash = __ws2812_cache_key(src, src_step, pixel_cnt, drv->chan_num, uniform);
+        entry = __ws2812_cache_lookup(drv, hash, uniform, src, src_step, pixel_cnt);
+        if (entry) {
+            tal_mutex_lock(drv->stats_mutex);
+            drv->cache_stats.hits++;
+            tal_mutex_unlock(drv->stats_mutex);
+            entry->last_use = ++drv->cache_tick;
+            if (drv->sent_entry == entry && __ws2812_frame_sent(drv)) {
+                return __ws2812_frame_skip(drv, tx_buf);
+            }
+            /* 直接发送缓存的码流，tx_buf的码流与last_frame保持不变 */
+            return __ws2812_frame_submit(drv, tx_buf, entry, FALSE, FALSE);
+        }
+        tal_mutex_lock(drv->stats_mutex);
+        drv->cache_stats.misses++;
+        tal_mutex_unlock(drv->stats_mutex);
+    }
+
+    start = PIXEL_PERF_NOW_US();
+    encoded = drv->encode(drv, tx_buf, src, src_step, pixel_cnt);
+    tx_buf->frame_valid = TRUE;
+    tx_buf->fill_valid = FALSE;
+    tal_mutex_lock(drv->stats_mutex);
+    drv->stats.pixels_encoded += encoded;
+    tdd_pixel_perf_record_us(&drv->perf.encode_us, (unsigned int)(PIXEL_PERF_NOW_US() - start));
+    tal_mutex_unlock(drv->stats_mutex);
+
+    if (cacheable) {
+        __ws2812_cache_insert(drv, hash, uniform, src, src_step, pixel_cnt, tx_buf->tx_ctrl);
+    }
+
+    /* 与已发送的帧完全相同，无需再次发送 */
+    if (__ws2812_frame_unchanged(drv, encoded)) {
+        return __ws2812_frame_skip(drv, tx_buf);
+    }
+
+    return __ws2812_frame_submit(drv, tx_buf, NULL, FALSE, FALSE);
 }
 
 /**
  * @function: tdd_ws2812_driver_send_data
- * @brief: 将颜色数据（RGBCW）转换为当前芯片的线序并转换为SPI码流, 通过SPI发送
+ * @brief: 16位颜色数据接口，转换为打包帧后按tdd_ws2812_driver_send_frame发送，
+ *         每个颜色分量只取低8位
  * @param[in]: handle -> 设备句柄
- * @param[in]: *data_buf -> 颜色数据
+ * @param[in]: *data_buf -> 颜色数据（R、G、B，四通道设备为R、G、B、W）
  * @param[in]: buf_len -> 颜色数据长度
  * @return: success -> 0  fail -> else
  */
 OPERATE_RET tdd_ws2812_driver_send_data(IN DRIVER_HANDLE_T handle, IN unsigned short *data_buf, IN unsigned int buf_len)
 {
-    OPERATE_RET ret = OPRT_OK;
-    DRV_PIXEL_TX_CTRL_T *tx_ctrl = NULL;
-    unsigned short swap_buf[COLOR_PRIMARY_NUM] = {0};
-    unsigned int i = 0, j = 0, idx = 0;
+    DRV_WS2812_HANDLE_T *drv = NULL;
+    PIXEL_FRAME_T frame = {0};
+    unsigned int i = 0, len = 0;
 
-    if (NULL == handle || NULL == data_buf || 0 == buf_len) {
+    if (NULL == handle || NULL == data_buf) {
         return OPRT_INVALID_PARM;
     }
 
-    tx_ctrl = (DRV_PIXEL_TX_CTRL_T *)handle;
-
-    for (j = 0; j < buf_len / COLOR_PRIMARY_NUM; j++) {
-        memset(swap_buf, 0, sizeof(swap_buf));
-        tdd_rgb_line_seq_transform(&data_buf[j * COLOR_PRIMARY_NUM], swap_buf, driver_info.line_seq);
-        for (i = 0; i < COLOR_PRIMARY_NUM; i++) {
-            tdd_rgb_transform_spi_data((unsigned char)swap_buf[i], DRVICE_DATA_0, DRVICE_DATA_1,
-                                       &tx_ctrl->tx_buffer[idx]);
-            idx += ONE_BYTE_LEN;
+    drv = (DRV_WS2812_HANDLE_T *)handle;
+    if (buf_len < drv->chan_num) {
+        return OPRT_INVALID_PARM;
+    }
+    if (NULL == drv->shim_buf) {
+        drv->shim_buf = (unsigned char *)tal_malloc(drv->chan_num * drv->pixel_num);
+        if (NULL == drv->shim_buf) {
+            return OPRT_MALLOC_FAILED;
         }
     }
 
-    ret = tkl_spi_send(driver_info.port, tx_ctrl->tx_buffer, tx_ctrl->tx_buffer_len);
+    frame.fmt = (COLOR_CHANNEL_MAX == drv->chan_num) ? PIXEL_FRAME_FMT_RGBW8888 : PIXEL_FRAME_FMT_RGB888;
+    frame.pixel_num = (buf_len / drv->chan_num > drv->pixel_num) ? drv->pixel_num :
+                      (unsigned short)(buf_len / drv->chan_num);
+    frame.data = drv->shim_buf;
 
-    return ret;
+    len = frame.pixel_num * drv->chan_num;
+    for (i = 0; i < len; i++) {
+        drv->shim_buf[i] = (unsigned char)data_buf[i];
+    }
+
+    /* 帧在返回前完成编码，shim_buf可以立即复用 */
+    return tdd_ws2812_driver_send_frame(handle, &frame);
 }
 
 /**
@@ -129,33 +1567,229 @@ OPERATE_RET tdd_ws2812_driver_send_data(IN DRIVER_HANDLE_T handle, IN unsigned s
 OPERATE_RET tdd_ws2812_driver_close(IN DRIVER_HANDLE_T *handle)
 {
     OPERATE_RET ret = OPRT_OK;
-    DRV_PIXEL_TX_CTRL_T *tx_ctrl = NULL;
+    DRV_WS2812_HANDLE_T *drv = NULL;
 
     if ((NULL == handle) || (*handle == NULL)) {
         return OPRT_INVALID_PARM;
     }
 
-    tx_ctrl = (DRV_PIXEL_TX_CTRL_T *)(*handle);
+    drv = (DRV_WS2812_HANDLE_T *)(*handle);
+
+    __ws2812_async_stop(drv);
+    __ws2812_stream_stop(drv);
 
-    ret = tkl_spi_deinit(driver_info.port);
+    ret = tkl_spi_deinit(drv->cfg.port);
     if (ret != OPRT_OK) {
         TAL_PR_ERR("spi deinit err:%d", ret);
     }
-    ret = tdd_pixel_tx_ctrl_release(tx_ctrl);
+    tdd_pixel_spi_port_release(drv->cfg.port);
+    __ws2812_cache_release(drv);
+    __ws2812_tx_buf_release(&drv->buf[0]);
+    if (drv->color_table) {
+        tal_free(drv->color_table);
+    }
+    if (drv->shim_buf) {
+        tal_free(drv->shim_buf);
+    }
+    tal_mutex_release(drv->stats_mutex);
+    tal_free(drv);
     *handle = NULL;
 
     return ret;
 }
 
+/**
+ * @function: tdd_ws2812_driver_config
+ * @brief: 设备配置
+ * @param[in]: handle -> 设备句柄
+ * @param[in]: cmd -> 配置命令
+ * @param[inout]: arg -> 命令参数
+ * @return: success -> 0  fail -> else
+ */
+OPERATE_RET tdd_ws2812_driver_config(IN DRIVER_HANDLE_T handle, IN unsigned char cmd, INOUT void *arg)
+{
+    DRV_WS2812_HANDLE_T *drv = NULL;
+    PIXEL_FRAME_DONE_CFG_T *done_cfg = NULL;
+    PIXEL_COLOR_CORRECTION_T *cc = NULL;
+    unsigned char i = 0;
+
+    if (NULL == handle) {
+        return OPRT_INVALID_PARM;
+    }
+
+    drv = (DRV_WS2812_HANDLE_T *)handle;
+
+    switch (cmd) {
+        case DRV_CMD_SET_RGB_ORDER_CFG:
+            if (NULL == arg || *(RGB_ORDER_MODE_E *)arg > BGR_ORDER) {
+                return OPRT_INVALID_PARM;
+            }
+            drv->cfg.line_seq = *(RGB_ORDER_MODE_E *)arg;
+            __ws2812_encode_select(drv);
+            __ws2812_frame_invalidate(drv);
+            /* 通道校正与线序位置相关 */
+            if (drv->color_table) {
+                drv->color_dirty = TRUE;
+            }
+            break;
+
+        case DRV_CMD_SET_COLOR_CORRECTION:
+            cc = (PIXEL_COLOR_CORRECTION_T *)arg;
+            if (NULL == cc || 0 == cc->gamma_x10) {
+                return OPRT_INVALID_PARM;
+            }
+            memcpy(&drv->color_cfg, cc, sizeof(PIXEL_COLOR_CORRECTION_T));
+            drv->color_dirty = TRUE;
+            break;
+
+        case DRV_CMD_GET_COLOR_CORRECTION:
+            if (NULL == arg) {
+                return OPRT_INVALID_PARM;
+            }
+            memcpy(arg, &drv->color_cfg, sizeof(PIXEL_COLOR_CORRECTION_T));
+            break;
+
+        case DRV_CMD_SET_BRIGHTNESS:
+            if (NULL == arg) {
+                return OPRT_INVALID_PARM;
+            }
+            if (drv->color_cfg.brightness != *(unsigned char *)arg) {
+                drv->color_cfg.brightness = *(unsigned char *)arg;
+                drv->color_dirty = TRUE;
+            }
+            break;
+
+        case DRV_CMD_GET_TX_STATS:
+            if (NULL == arg) {
+                return OPRT_INVALID_PARM;
+            }
+            tal_mutex_lock(drv->stats_mutex);
+            memcpy(arg, &drv->stats, sizeof(PIXEL_DRV_TX_STATS_T));
+            tal_mutex_unlock(drv->stats_mutex);
+            break;
+
+        case DRV_CMD_RESET_TX_STATS:
+            tal_mutex_lock(drv->stats_mutex);
+            memset(&drv->stats, 0, sizeof(PIXEL_DRV_TX_STATS_T));
+            drv->cache_stats.hits = 0;
+            drv->cache_stats.misses = 0;
+            drv->cache_stats.inserts = 0;
+            drv->cache_stats.evictions = 0;
+            memset(&drv->perf, 0, sizeof(PIXEL_DRV_PERF_STATS_T));
+            tal_mutex_unlock(drv->stats_mutex);
+            break;
+
+        case DRV_CMD_GET_PERF_STATS:
+            if (NULL == arg) {
+                return OPRT_INVALID_PARM;
+            }
+            tal_mutex_lock(drv->stats_mutex);
+            memcpy(arg, &drv->perf, sizeof(PIXEL_DRV_PERF_STATS_T));
+            tal_mutex_unlock(drv->stats_mutex);
+            break;
+
+        case DRV_CMD_SET_FRAME_CACHE:
+            if (NULL == arg) {
+                return OPRT_INVALID_PARM;
+            }
+            /* 流式发送没有整帧码流可以缓存 */
+            if (drv->stream_px && *(unsigned int *)arg) {
+                return OPRT_NOT_SUPPORTED;
+            }
+            drv->cache_budget = *(unsigned int *)arg;
+            /* 等待在途帧发送完成后释放或淘汰，发送线程不再引用任何条目 */
+            for (i = 0; drv->async && i < WS2812_TX_BUF_NUM; i++) {
+                tal_semaphore_wait(drv->buf[i].idle_sem, SEM_WAIT_FOREVER);
+            }
+            if (0 == drv->cache_budget) {
+                __ws2812_cache_release(drv);
+            } else {
+                /* 缩小上限时淘汰多出的条目 */
+                while (drv->cache_stats.bytes > drv->cache_budget && __ws2812_cache_evict(drv, NULL)) {
+                }
+            }
+            for (i = 0; drv->async && i < WS2812_TX_BUF_NUM; i++) {
+                tal_semaphore_post(drv->buf[i].idle_sem);
+            }
+            break;
+
+        case DRV_CMD_SET_UNIFORM_REPEAT:
+            if (NULL == arg) {
+                return OPRT_INVALID_PARM;
+            }
+            if (drv->stream_px && *(unsigned short *)arg) {
+                return OPRT_NOT_SUPPORTED;
+            }
+            /* 等待在途帧发送完成后释放旧的重复块 */
+            for (i = 0; drv->async && i < WS2812_TX_BUF_NUM; i++) {
+                tal_semaphore_wait(drv->buf[i].idle_sem, SEM_WAIT_FOREVER);
+            }
+            for (i = 0; i < WS2812_TX_BUF_NUM; i++) {
+                if (drv->buf[i].repeat_buf) {
+                    tal_free(drv->buf[i].repeat_buf);
+                    drv->buf[i].repeat_buf = NULL;
+                }
+                drv->buf[i].chain = FALSE;
+                drv->buf[i].repeat_valid = FALSE;
+            }
+            drv->sent_repeat = FALSE;
+            drv->sent_valid = FALSE;
+            drv->repeat_block = (*(unsigned short *)arg > drv->pixel_num) ? drv->pixel_num : *(unsigned short *)arg;
+            drv->repeat_chain = tdd_pixel_spi_repeat_supported(drv->cfg.port);
+            for (i = 0; drv->async && i < WS2812_TX_BUF_NUM; i++) {
+                tal_semaphore_post(drv->buf[i].idle_sem);
+            }
+            break;
+
+        case DRV_CMD_GET_FRAME_CACHE_STATS:
+            if (NULL == arg) {
+                return OPRT_INVALID_PARM;
+            }
+            tal_mutex_lock(drv->stats_mutex);
+            memcpy(arg, &drv->cache_stats, sizeof(PIXEL_DRV_CACHE_STATS_T));
+            tal_mutex_unlock(drv->stats_mutex);
+            break;
+
+        case DRV_CMD_SET_ASYNC_MODE:
+            if (NULL == arg) {
+                return OPRT_INVALID_PARM;
+            }
+            /* 流式发送已在发送线程中与编码重叠 */
+            if (drv->stream_px) {
+                return (*(BOOL_T *)arg) ? OPRT_NOT_SUPPORTED : OPRT_OK;
+            }
+            if (*(BOOL_T *)arg) {
+                return __ws2812_async_start(drv);
+            }
+            __ws2812_async_stop(drv);
+            break;
+
+        case DRV_CMD_SET_FRAME_DONE_CB:
+            done_cfg = (PIXEL_FRAME_DONE_CFG_T *)arg;
+            drv->done_cb = (NULL == done_cfg) ? NULL : done_cfg->cb;
+            drv->done_arg = (NULL == done_cfg) ? NULL : done_cfg->arg;
+            break;
+
+        default:
+            return OPRT_NOT_SUPPORTED;
+    }
+
+    return OPRT_OK;
+}
+
 /**
  * @function:tdd_ws2812_driver_register
- * @brief: 注册设备
- * @param[in]: 
+ * @brief: 注册设备配置，供之后的tdd_2812_driver_open使用，已打开的句柄不受影响
+ * @param[in]: init_param -> 设备配置
  * @return: success -> OPRT_OK
  */
 OPERATE_RET tdd_ws2812_driver_register(IN PIXEL_DRIVER_CONFIG_T *init_param)
 {
-    OPERATE_RET ret = OPRT_OK;
+    if (NULL == init_param || init_param->code_mode > PIXEL_SPI_CODE_3BIT || init_param->chip > PIXEL_CHIP_SK6812 ||
+        (init_param->chan_num != 0 && init_param->chan_num != COLOR_PRIMARY_NUM &&
+         init_param->chan_num != COLOR_CHANNEL_MAX)) {
+        return OPRT_INVALID_PARM;
+    }
     memcpy(&driver_info, init_param, sizeof(PIXEL_DRIVER_CONFIG_T));
     return OPRT_OK;
 }
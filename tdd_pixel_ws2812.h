@@ -13,6 +13,7 @@
 #define __TDD_PIXEL_WS2812_H__
 
 #include "tdd_pixel_type.h"
+#include "tdl_pixel_driver.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -41,6 +42,34 @@ extern "C" {
  */
 OPERATE_RET tdd_ws2812_driver_register(IN PIXEL_DRIVER_CONFIG_T *init_param);
 
+/**
+ * @brief  按注册的配置打开设备
+ *
+ * @param[out] handle 设备句柄
+ * @param[in] pixel_num 像素点数
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_2812_driver_open(OUT DRIVER_HANDLE_T *handle, IN unsigned short pixel_num);
+
+/**
+ * @brief  按指定配置打开设备，同一SPI端口只能被一个句柄打开
+ *
+ * @param[out] handle 设备句柄
+ * @param[in] pixel_num 像素点数
+ * @param[in] cfg 设备配置（端口、线序、码型），拷贝到句柄中
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdd_ws2812_driver_open_cfg(OUT DRIVER_HANDLE_T *handle, IN unsigned short pixel_num,
+                                       IN PIXEL_DRIVER_CONFIG_T *cfg);
+
+OPERATE_RET tdd_ws2812_driver_close(IN DRIVER_HANDLE_T *handle);
+
+OPERATE_RET tdd_ws2812_driver_send_data(IN DRIVER_HANDLE_T handle, IN unsigned short *data_buf, IN unsigned int buf_len);
+
+OPERATE_RET tdd_ws2812_driver_send_frame(IN DRIVER_HANDLE_T handle, IN const PIXEL_FRAME_T *frame);
+
+OPERATE_RET tdd_ws2812_driver_config(IN DRIVER_HANDLE_T handle, IN unsigned char cmd, INOUT void *arg);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
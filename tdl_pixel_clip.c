@@ -0,0 +1,336 @@
+/**
+ * @file tdl_pixel_clip.c
+ * @author www.tuya.com
+ * @brief tdl_pixel_clip module is used to play keyframed/delta-encoded pixel animation clips from a stream
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+#include <string.h>
+
+#include "tal_log.h"
+#include "tal_memory.h"
+
+#include "tdl_pixel_clip.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define CLIP_COLOR_NUM      3
+
+#define CLIP_GET_U16(p)     ((unsigned short)((p)[0] | ((p)[1] << 8)))
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef struct {
+    PIXEL_CLIP_READ_CB read;
+    void *ctx;
+    PIXEL_CLIP_INFO_T info;
+    unsigned int offset;                // 下一帧记录的偏移
+    unsigned char *frame_buf;           // 当前帧，pixel_num * 3 字节RGB
+} PIXEL_CLIP_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+/**
+ * @brief 从当前偏移读取len字节并前移，数据不足返回OPRT_NOT_FOUND
+ */
+static OPERATE_RET __clip_read(PIXEL_CLIP_T *clip, unsigned char *buf, unsigned int len)
+{
+    int rd = clip->read(clip->ctx, clip->offset, buf, len);
+
+    if (rd < 0) {
+        return OPRT_COM_ERROR;
+    }
+    if ((unsigned int)rd < len) {
+        return OPRT_NOT_FOUND;
+    }
+    clip->offset += len;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief 校验增量帧：全部片段的范围合法且数据完整，校验后偏移回到第一个片段
+ */
+static OPERATE_RET __clip_check_delta(PIXEL_CLIP_T *clip, unsigned char run_num)
+{
+    OPERATE_RET ret = OPRT_OK;
+    unsigned char head[PIXEL_CLIP_RUN_HEAD_LEN], last = 0;
+    unsigned int run_offset = clip->offset, start = 0, len = 0;
+
+    for (; run_num > 0; run_num--) {
+        ret = __clip_read(clip, head, PIXEL_CLIP_RUN_HEAD_LEN);
+        if (ret != OPRT_OK) {
+            return ret;
+        }
+        start = CLIP_GET_U16(head);
+        len = head[2] & PIXEL_CLIP_RUN_LEN_MASK;
+        if (0 == len || start + len > clip->info.pixel_num) {
+            TAL_PR_ERR("clip run %u+%u out of range", start, len);
+            return OPRT_COM_ERROR;
+        }
+        clip->offset += (head[2] & PIXEL_CLIP_RUN_FILL) ? CLIP_COLOR_NUM : len * CLIP_COLOR_NUM;
+    }
+
+    // 读到帧记录的最后一个字节即数据完整
+    if (clip->offset > run_offset) {
+        clip->offset--;
+        ret = __clip_read(clip, &last, 1);
+        if (ret != OPRT_OK) {
+            return ret;
+        }
+    }
+    clip->offset = run_offset;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief 在当前帧上应用一个增量帧；先校验整帧，截断或越界的增量帧不修改当前帧
+ */
+static OPERATE_RET __clip_apply_delta(PIXEL_CLIP_T *clip)
+{
+    OPERATE_RET ret = OPRT_OK;
+    unsigned char run_num = 0, head[PIXEL_CLIP_RUN_HEAD_LEN];
+    unsigned char *dst = NULL;
+    unsigned int start = 0, len = 0, i = 0;
+
+    ret = __clip_read(clip, &run_num, 1);
+    if (ret != OPRT_OK) {
+        return ret;
+    }
+    ret = __clip_check_delta(clip, run_num);
+    if (ret != OPRT_OK) {
+        return ret;
+    }
+
+    for (; run_num > 0; run_num--) {
+        ret = __clip_read(clip, head, PIXEL_CLIP_RUN_HEAD_LEN);
+        if (ret != OPRT_OK) {
+            return ret;
+        }
+        start = CLIP_GET_U16(head);
+        len = head[2] & PIXEL_CLIP_RUN_LEN_MASK;
+
+        dst = &clip->frame_buf[start * CLIP_COLOR_NUM];
+        if (head[2] & PIXEL_CLIP_RUN_FILL) {
+            ret = __clip_read(clip, dst, CLIP_COLOR_NUM);
+            for (i = 1; OPRT_OK == ret && i < len; i++) {
+                memcpy(&dst[i * CLIP_COLOR_NUM], dst, CLIP_COLOR_NUM);
+            }
+        } else {
+            ret = __clip_read(clip, dst, len * CLIP_COLOR_NUM);
+        }
+        if (ret != OPRT_OK) {
+            return ret;
+        }
+    }
+
+    return OPRT_OK;
+}
+
+/**
+* @brief       打开片段：读取并校验文件头，申请一帧像素缓存
+*
+* @param[out]  clip                片段句柄
+* @param[in]   read                读回调
+* @param[in]   ctx                 读回调参数
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdl_pixel_clip_open(PIXEL_CLIP_HANDLE_T *clip, PIXEL_CLIP_READ_CB read, void *ctx)
+{
+    PIXEL_CLIP_T *hdl = NULL;
+    unsigned char head[PIXEL_CLIP_HEADER_LEN];
+
+    if (NULL == clip || NULL == read) {
+        return OPRT_INVALID_PARM;
+    }
+
+    if (read(ctx, 0, head, PIXEL_CLIP_HEADER_LEN) != PIXEL_CLIP_HEADER_LEN ||
+        memcmp(head, PIXEL_CLIP_MAGIC, 4) != 0 || head[4] != PIXEL_CLIP_VERSION ||
+        0 == CLIP_GET_U16(&head[6])) {
+        TAL_PR_ERR("invalid clip header");
+        return OPRT_INVALID_PARM;
+    }
+
+    hdl = (PIXEL_CLIP_T *)tal_malloc(sizeof(PIXEL_CLIP_T));
+    if (NULL == hdl) {
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(hdl, 0, sizeof(PIXEL_CLIP_T));
+
+    hdl->read = read;
+    hdl->ctx = ctx;
+    hdl->info.flags = head[5];
+    hdl->info.pixel_num = CLIP_GET_U16(&head[6]);
+    hdl->info.frame_num = CLIP_GET_U16(&head[8]);
+    hdl->offset = PIXEL_CLIP_HEADER_LEN;
+
+    hdl->frame_buf = (unsigned char *)tal_malloc(hdl->info.pixel_num * CLIP_COLOR_NUM);
+    if (NULL == hdl->frame_buf) {
+        tal_free(hdl);
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(hdl->frame_buf, 0, hdl->info.pixel_num * CLIP_COLOR_NUM);
+
+    *clip = hdl;
+
+    return OPRT_OK;
+}
+
+/**
+* @brief       获取片段信息
+*
+* @param[in]   clip                片段句柄
+* @param[out]  info                片段信息
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdl_pixel_clip_get_info(PIXEL_CLIP_HANDLE_T clip, PIXEL_CLIP_INFO_T *info)
+{
+    if (NULL == clip || NULL == info) {
+        return OPRT_INVALID_PARM;
+    }
+
+    memcpy(info, &((PIXEL_CLIP_T *)clip)->info, sizeof(PIXEL_CLIP_INFO_T));
+
+    return OPRT_OK;
+}
+
+/**
+* @brief       解码下一帧
+*
+* @param[in]   clip                片段句柄
+* @param[out]  frame               当前帧
+* @param[out]  duration_ms         当前帧的显示时间
+*
+* @return OPRT_OK on success. OPRT_NOT_FOUND 片段已结束（非循环）. Others on error
+*/
+OPERATE_RET tdl_pixel_clip_next(PIXEL_CLIP_HANDLE_T clip, PIXEL_FRAME_T *frame, unsigned int *duration_ms)
+{
+    OPERATE_RET ret = OPRT_OK;
+    PIXEL_CLIP_T *hdl = (PIXEL_CLIP_T *)clip;
+    unsigned char head[PIXEL_CLIP_FRAME_HEAD_LEN];
+    BOOL_T rewound = FALSE;
+
+    if (NULL == hdl || NULL == frame) {
+        return OPRT_INVALID_PARM;
+    }
+
+    for (;;) {
+        ret = __clip_read(hdl, head, PIXEL_CLIP_FRAME_HEAD_LEN);
+        if (OPRT_NOT_FOUND == ret || (OPRT_OK == ret && PIXEL_CLIP_FRAME_END == head[0])) {
+            // 循环片段回到第一帧；回到第一帧后仍无帧可读时结束，避免空片段死循环
+            if (!(hdl->info.flags & PIXEL_CLIP_FLAG_LOOP) || rewound) {
+                return OPRT_NOT_FOUND;
+            }
+            hdl->offset = PIXEL_CLIP_HEADER_LEN;
+            rewound = TRUE;
+            continue;
+        }
+        if (ret != OPRT_OK) {
+            return ret;
+        }
+        break;
+    }
+
+    switch (head[0]) {
+        case PIXEL_CLIP_FRAME_KEY:
+            ret = __clip_read(hdl, hdl->frame_buf, hdl->info.pixel_num * CLIP_COLOR_NUM);
+            break;
+
+        case PIXEL_CLIP_FRAME_DELTA:
+            ret = __clip_apply_delta(hdl);
+            break;
+
+        default:
+            TAL_PR_ERR("unknown clip frame type %d", head[0]);
+            ret = OPRT_NOT_SUPPORTED;
+            break;
+    }
+    if (ret != OPRT_OK) {
+        // 帧记录不完整视为数据错误，不是正常结束
+        return (OPRT_NOT_FOUND == ret) ? OPRT_COM_ERROR : ret;
+    }
+
+    frame->fmt = PIXEL_FRAME_FMT_RGB888;
+    frame->pixel_num = hdl->info.pixel_num;
+    frame->data = hdl->frame_buf;
+    if (duration_ms) {
+        *duration_ms = CLIP_GET_U16(&head[1]);
+    }
+
+    return OPRT_OK;
+}
+
+/**
+* @brief       回到第一帧
+*
+* @param[in]   clip                片段句柄
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdl_pixel_clip_rewind(PIXEL_CLIP_HANDLE_T clip)
+{
+    if (NULL == clip) {
+        return OPRT_INVALID_PARM;
+    }
+
+    ((PIXEL_CLIP_T *)clip)->offset = PIXEL_CLIP_HEADER_LEN;
+
+    return OPRT_OK;
+}
+
+/**
+* @brief       关闭片段
+*
+* @param[in]   clip                片段句柄
+*
+* @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+*/
+OPERATE_RET tdl_pixel_clip_close(PIXEL_CLIP_HANDLE_T clip)
+{
+    PIXEL_CLIP_T *hdl = (PIXEL_CLIP_T *)clip;
+
+    if (NULL == hdl) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_free(hdl->frame_buf);
+    tal_free(hdl);
+
+    return OPRT_OK;
+}
+
+/**
+* @brief       内存片段读回调，ctx为PIXEL_CLIP_MEM_T
+*
+* @return 读取的字节数
+*/
+int tdl_pixel_clip_mem_read(void *ctx, unsigned int offset, unsigned char *buf, unsigned int len)
+{
+    PIXEL_CLIP_MEM_T *mem = (PIXEL_CLIP_MEM_T *)ctx;
+
+    if (NULL == mem || NULL == buf) {
+        return -1;
+    }
+    if (offset >= mem->len) {
+        return 0;
+    }
+    if (len > mem->len - offset) {
+        len = mem->len - offset;
+    }
+    memcpy(buf, &mem->data[offset], len);
+
+    return (int)len;
+}
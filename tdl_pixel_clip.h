@@ -0,0 +1,155 @@
+/**
+ * @file tdl_pixel_clip.h
+ * @author www.tuya.com
+ * @brief tdl_pixel_clip module is used to play keyframed/delta-encoded pixel animation clips from a stream
+ *
+ * 片段格式（多字节字段均为小端）：
+ *   文件头 PIXEL_CLIP_HEADER_LEN 字节：
+ *     magic[4] "PXCL" | version(1) | flags(1) | pixel_num(2) | frame_num(2) | reserved(2)
+ *   帧记录依次排列，每帧以 type(1) | duration_ms(2) 开头：
+ *     PIXEL_CLIP_FRAME_KEY    后跟 pixel_num * 3 字节RGB
+ *     PIXEL_CLIP_FRAME_DELTA  后跟 run_num(1) 个片段，在上一帧基础上修改：
+ *                             start(2) | len(1) | 数据
+ *                             len的bit7为0时数据为 len * 3 字节RGB，为1时为 3 字节RGB，
+ *                             将 len & 0x7F 个像素填充为同一颜色
+ *     PIXEL_CLIP_FRAME_END    片段结束（数据读完同样视为结束）
+ *   第一帧应为关键帧；flags含PIXEL_CLIP_FLAG_LOOP时结束后从第一帧重新播放。
+ *
+ * 播放器通过读回调按偏移逐帧读取（flash、文件或内存），只持有一帧像素缓存，
+ * 占用内存与片段长度无关。
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+
+#ifndef __TDL_PIXEL_CLIP_H__
+#define __TDL_PIXEL_CLIP_H__
+
+#include "tdd_pixel_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define PIXEL_CLIP_MAGIC               "PXCL"
+#define PIXEL_CLIP_VERSION             0x01
+#define PIXEL_CLIP_HEADER_LEN          12
+#define PIXEL_CLIP_FRAME_HEAD_LEN      3
+#define PIXEL_CLIP_RUN_HEAD_LEN        3
+
+/* flags */
+#define PIXEL_CLIP_FLAG_LOOP           0x01
+
+/* 帧类型 */
+#define PIXEL_CLIP_FRAME_END           0x00
+#define PIXEL_CLIP_FRAME_KEY           0x01
+#define PIXEL_CLIP_FRAME_DELTA         0x02
+
+/* 增量片段len字段 */
+#define PIXEL_CLIP_RUN_FILL            0x80
+#define PIXEL_CLIP_RUN_LEN_MASK        0x7F
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef void *PIXEL_CLIP_HANDLE_T;
+
+/**
+ * @brief 片段读回调
+ *
+ * @param[in]   ctx                 用户参数
+ * @param[in]   offset              片段内偏移
+ * @param[out]  buf                 数据缓存
+ * @param[in]   len                 读取长度
+ *
+ * @return 读取的字节数，小于len表示片段结束，小于0为错误
+ */
+typedef int (*PIXEL_CLIP_READ_CB)(void *ctx, unsigned int offset, unsigned char *buf, unsigned int len);
+
+/* 内存中的片段（如flash映射地址），配合tdl_pixel_clip_mem_read使用 */
+typedef struct {
+    const unsigned char *data;
+    unsigned int len;
+} PIXEL_CLIP_MEM_T;
+
+typedef struct {
+    unsigned char flags;
+    unsigned short pixel_num;
+    unsigned short frame_num;           // 文件头中的帧数，0为未知
+} PIXEL_CLIP_INFO_T;
+
+/***********************************************************
+********************function declaration********************
+***********************************************************/
+/**
+ * @brief       打开片段：读取并校验文件头，申请一帧像素缓存
+ *
+ * @param[out]  clip                片段句柄
+ * @param[in]   read                读回调
+ * @param[in]   ctx                 读回调参数，在关闭前需保持有效
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_clip_open(PIXEL_CLIP_HANDLE_T *clip, PIXEL_CLIP_READ_CB read, void *ctx);
+
+/**
+ * @brief       获取片段信息
+ *
+ * @param[in]   clip                片段句柄
+ * @param[out]  info                片段信息
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_clip_get_info(PIXEL_CLIP_HANDLE_T clip, PIXEL_CLIP_INFO_T *info);
+
+/**
+ * @brief       解码下一帧
+ *
+ * frame->data指向片段内部的像素缓存（RGB888），在下一次调用tdl_pixel_clip_next前有效。
+ * 截断或片段越界的增量帧返回错误且不修改像素缓存；校验通过后读回调再出错时像素缓存可能已部分更新，
+ * 应rewind后从关键帧重新播放
+ *
+ * @param[in]   clip                片段句柄
+ * @param[out]  frame               当前帧
+ * @param[out]  duration_ms         当前帧的显示时间
+ *
+ * @return OPRT_OK on success. OPRT_NOT_FOUND 片段已结束（非循环）. Others on error
+ */
+OPERATE_RET tdl_pixel_clip_next(PIXEL_CLIP_HANDLE_T clip, PIXEL_FRAME_T *frame, unsigned int *duration_ms);
+
+/**
+ * @brief       回到第一帧
+ *
+ * @param[in]   clip                片段句柄
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_clip_rewind(PIXEL_CLIP_HANDLE_T clip);
+
+/**
+ * @brief       关闭片段
+ *
+ * @param[in]   clip                片段句柄
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_clip_close(PIXEL_CLIP_HANDLE_T clip);
+
+/**
+ * @brief       内存片段读回调，ctx为PIXEL_CLIP_MEM_T
+ *
+ * @return 读取的字节数
+ */
+int tdl_pixel_clip_mem_read(void *ctx, unsigned int offset, unsigned char *buf, unsigned int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDL_PIXEL_CLIP_H__ */
@@ -11,6 +11,8 @@
  
 #ifndef __TDL_PIXEL_DRIVER_H__
 #define __TDL_PIXEL_DRIVER_H__
+
+#include "tdd_pixel_type.h"
  
  
 #ifdef __cplusplus
@@ -32,6 +34,18 @@ extern "C" {
 typedef unsigned char PIXEL_DRV_CMD_E;
 #define DRV_CMD_GET_PWM_HARDWARE_CFG                    0x01
 #define DRV_CMD_SET_RGB_ORDER_CFG                       0x02
+#define DRV_CMD_GET_TX_STATS                            0x03    // arg: PIXEL_DRV_TX_STATS_T *
+#define DRV_CMD_RESET_TX_STATS                          0x04    // arg: NULL
+#define DRV_CMD_SET_ASYNC_MODE                          0x05    // arg: BOOL_T *，异步双缓存发送
+#define DRV_CMD_SET_FRAME_DONE_CB                       0x06    // arg: PIXEL_FRAME_DONE_CFG_T *，NULL为取消
+#define DRV_CMD_SET_COLOR_CORRECTION                    0x07    // arg: PIXEL_COLOR_CORRECTION_T *
+#define DRV_CMD_GET_COLOR_CORRECTION                    0x08    // arg: PIXEL_COLOR_CORRECTION_T *
+#define DRV_CMD_SET_BRIGHTNESS                          0x09    // arg: unsigned char *，全局亮度
+#define DRV_CMD_SET_FRAME_CACHE                         0x0A    // arg: unsigned int *，编码帧缓存内存上限，0为关闭
+#define DRV_CMD_GET_FRAME_CACHE_STATS                   0x0B    // arg: PIXEL_DRV_CACHE_STATS_T *
+#define DRV_CMD_SET_UNIFORM_REPEAT                      0x0C    // arg: unsigned short *，纯色帧重复块的像素数，0为关闭；端口不支持链式发送时铺满发送缓存
+#define DRV_CMD_GET_PERF_STATS                          0x0D    // arg: PIXEL_DRV_PERF_STATS_T *
+#define DRV_CMD_SET_GLOBAL_CURRENT                      0x0E    // arg: unsigned char *，APA102/SK9822像素5位全局电流上限 0-31
 
 typedef unsigned char PIXEL_COLOR_TP_E;
 #define PIXEL_COLOR_TP_RGB             (COLOR_R_BIT|COLOR_G_BIT|COLOR_B_BIT)
@@ -40,13 +54,63 @@ typedef unsigned char PIXEL_COLOR_TP_E;
 #define PIXEL_COLOR_TP_RGBCW           (COLOR_R_BIT|COLOR_G_BIT|COLOR_B_BIT|COLOR_C_BIT|COLOR_W_BIT)
 
 typedef void* DRIVER_HANDLE_T;
+
+/**
+ * @brief 帧发送完成回调
+ *
+ * 每次output返回成功后按提交顺序回调一次，output返回错误时不回调：异步模式下在发送线程中调用，
+ * result为该帧的发送结果；同步模式或帧内容未变化而跳过发送时在output调用者上下文中调用，
+ * 跳过发送的帧在之前提交的帧回调之后才回调
+ */
+typedef void (*PIXEL_FRAME_DONE_CB)(DRIVER_HANDLE_T handle, int result, void *arg);
+
+typedef struct {
+    PIXEL_FRAME_DONE_CB cb;
+    void *arg;
+} PIXEL_FRAME_DONE_CFG_T;
 typedef struct {
     int (*open)(DRIVER_HANDLE_T *handle, unsigned short pixel_num);
     int (*close)(DRIVER_HANDLE_T *handle);
     int (*output)(DRIVER_HANDLE_T handle,  unsigned short *data_buf, unsigned int buf_len);
     int (*config)(DRIVER_HANDLE_T handle, unsigned char cmd, void *arg);
+    int (*output_frame)(DRIVER_HANDLE_T handle, const PIXEL_FRAME_T *frame);   // 打包8位颜色帧，可为NULL
 }PIXEL_DRIVER_INTFS_T;
 
+/* 颜色校正：out = 255 * (in / 255) ^ (gamma_x10 / 10) * brightness / 255 * gain / 255 */
+typedef struct {
+    unsigned char gamma_x10;        // 伽马值 x10，10为线性
+    unsigned char brightness;       // 全局亮度 0-255
+    unsigned char r_gain;           // 红色通道校正 0-255
+    unsigned char g_gain;           // 绿色通道校正 0-255
+    unsigned char b_gain;           // 蓝色通道校正 0-255
+} PIXEL_COLOR_CORRECTION_T;
+
+/* 发送统计 */
+typedef struct {
+    unsigned int frames_sent;       // 实际发送的帧数
+    unsigned int frames_skipped;    // 与上一帧相同而跳过发送的帧数
+    unsigned int pixels_encoded;    // 重新编码的像素点数
+    unsigned int frames_repeat;     // 纯色帧只编码一个像素后按重复块发送的帧数
+    unsigned int stream_underruns;  // 流式发送时下一块未编码完成、线路空闲等待的次数
+} PIXEL_DRV_TX_STATS_T;
+
+/* 编码帧缓存统计，DRV_CMD_RESET_TX_STATS同时清零计数 */
+typedef struct {
+    unsigned int hits;              // 命中，跳过编码直接发送缓存的码流
+    unsigned int misses;            // 未命中
+    unsigned int inserts;           // 写入的条目数
+    unsigned int evictions;         // 因内存上限淘汰的条目数
+    unsigned int entries;           // 当前条目数
+    unsigned int bytes;             // 当前占用内存
+} PIXEL_DRV_CACHE_STATS_T;
+
+/* 性能统计，时间单位为微秒，精度见tdd_pixel_perf_tick_us，DRV_CMD_RESET_TX_STATS同时清零 */
+typedef struct {
+    PIXEL_PERF_METRIC_T encode_us;  // 整帧编码耗时（缓存命中、纯色帧与跳过的帧不计入）
+    PIXEL_PERF_METRIC_T spi_us;     // 每帧SPI发送耗时
+    PIXEL_PERF_METRIC_T wait_us;    // 异步模式下等待空闲发送缓存的耗时
+} PIXEL_DRV_PERF_STATS_T;
+
 typedef struct {
     PIXEL_COLOR_TP_E color_tp;
     unsigned int     color_maximum;
@@ -0,0 +1,417 @@
+/**
+ * @file tdl_pixel_frame_sched.c
+ * @author www.tuya.com
+ * @brief tdl_pixel_frame_sched module is used to refresh several pixel strips in one frame window
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+#include <string.h>
+
+#include "tal_log.h"
+#include "tal_memory.h"
+#include "tal_mutex.h"
+#include "tal_semaphore.h"
+
+#include "tdd_pixel_basic.h"
+#include "tdl_pixel_frame_sched.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+struct pixel_frame_sched;
+
+typedef struct {
+    struct pixel_frame_sched *sched;
+    PIXEL_DRIVER_INTFS_T *intfs;
+    DRIVER_HANDLE_T handle;
+    unsigned short *data_buf;
+    unsigned int buf_len;
+    BOOL_T pending;                     // 已提交，等待帧完成回调
+    BOOL_T done;                        // 本次刷新已收到帧完成回调
+    unsigned int submit_seq;            // 已提交（会产生帧完成回调）的帧序号
+    unsigned int done_seq;              // 已收到的帧完成回调数，驱动按提交顺序回调
+    int result;                         // 本次刷新的发送结果
+    unsigned long long submit_us;       // 开始提交的时间
+    unsigned long long done_us;         // 发送结束的时间
+} PIXEL_SCHED_PORT_T;
+
+typedef struct pixel_frame_sched {
+    unsigned char port_num;
+    PIXEL_SCHED_PORT_T port[PIXEL_SCHED_PORT_MAX];      // 按添加顺序
+    unsigned char order[PIXEL_SCHED_PORT_MAX];          // 提交顺序，按颜色数据长度从大到小
+    SEM_HANDLE done_sem;
+    MUTEX_HANDLE mutex;                                 // 保护pending/done与统计
+    unsigned long long total_frame_us;
+    PIXEL_SCHED_STATS_T stats;
+} PIXEL_FRAME_SCHED_T;
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+/**
+ * @brief 计时，取驱动层性能计时时钟（精度见tdd_pixel_perf_tick_us）
+ */
+static unsigned long long __sched_now_us(void)
+{
+    return PIXEL_PERF_NOW_US();
+}
+
+/**
+ * @brief 帧完成回调：异步模式下在驱动发送线程中调用
+ */
+static void __sched_frame_done_cb(DRIVER_HANDLE_T handle, int result, void *arg)
+{
+    PIXEL_SCHED_PORT_T *port = (PIXEL_SCHED_PORT_T *)arg;
+    PIXEL_FRAME_SCHED_T *sched = port->sched;
+    unsigned long long now = __sched_now_us();
+    BOOL_T notify = FALSE;
+
+    (void)handle;
+
+    tal_mutex_lock(sched->mutex);
+    /* 超时后迟到的回调属于之前的帧，不计入本次刷新 */
+    port->done_seq++;
+    if (port->pending && port->done_seq == port->submit_seq) {
+        port->pending = FALSE;
+        port->done = TRUE;
+        port->result = result;
+        port->done_us = now;
+        notify = TRUE;
+    }
+    tal_mutex_unlock(sched->mutex);
+
+    if (notify) {
+        tal_semaphore_post(sched->done_sem);
+    }
+}
+
+/**
+ * @brief 汇总本次刷新的统计
+ */
+static void __sched_update_stats(PIXEL_FRAME_SCHED_T *sched, unsigned long long frame_start)
+{
+    PIXEL_SCHED_PORT_T *port = NULL;
+    PIXEL_SCHED_PORT_STATS_T *port_stats = NULL;
+    unsigned long long first_done = 0, last_done = 0;
+    BOOL_T any_done = FALSE;
+    unsigned int frame_us = 0, skew_us = 0;
+    unsigned char i = 0;
+
+    for (i = 0; i < sched->port_num; i++) {
+        port = &sched->port[i];
+        port_stats = &sched->stats.port[i];
+        if (!port->done || port->result != OPRT_OK) {
+            port_stats->errors++;
+            continue;
+        }
+
+        port_stats->frames++;
+        port_stats->last_frame_us = (unsigned int)(port->done_us - port->submit_us);
+        if (port_stats->last_frame_us > port_stats->max_frame_us) {
+            port_stats->max_frame_us = port_stats->last_frame_us;
+        }
+
+        if (!any_done || port->done_us < first_done) {
+            first_done = port->done_us;
+        }
+        if (!any_done || port->done_us > last_done) {
+            last_done = port->done_us;
+        }
+        any_done = TRUE;
+    }
+
+    if (any_done) {
+        frame_us = (unsigned int)(last_done - frame_start);
+        skew_us = (unsigned int)(last_done - first_done);
+    }
+
+    sched->stats.frames++;
+    sched->stats.last_frame_us = frame_us;
+    if (frame_us > sched->stats.max_frame_us) {
+        sched->stats.max_frame_us = frame_us;
+    }
+    sched->total_frame_us += frame_us;
+    sched->stats.avg_frame_us = (unsigned int)(sched->total_frame_us / sched->stats.frames);
+    sched->stats.last_skew_us = skew_us;
+    if (skew_us > sched->stats.max_skew_us) {
+        sched->stats.max_skew_us = skew_us;
+    }
+}
+
+/**
+ * @brief       创建帧调度器
+ *
+ * @param[out]  sched               调度器句柄
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_frame_sched_create(PIXEL_FRAME_SCHED_HANDLE_T *sched)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    PIXEL_FRAME_SCHED_T *fs = NULL;
+
+    if (NULL == sched) {
+        return OPRT_INVALID_PARM;
+    }
+
+    fs = (PIXEL_FRAME_SCHED_T *)tal_malloc(sizeof(PIXEL_FRAME_SCHED_T));
+    if (NULL == fs) {
+        return OPRT_MALLOC_FAILED;
+    }
+    memset(fs, 0, sizeof(PIXEL_FRAME_SCHED_T));
+
+    op_ret = tal_semaphore_create_init(&fs->done_sem, 0, PIXEL_SCHED_PORT_MAX);
+    if (op_ret != OPRT_OK) {
+        tal_free(fs);
+        return op_ret;
+    }
+
+    op_ret = tal_mutex_create_init(&fs->mutex);
+    if (op_ret != OPRT_OK) {
+        tal_semaphore_release(fs->done_sem);
+        tal_free(fs);
+        return op_ret;
+    }
+
+    *sched = fs;
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief       添加端口，驱动支持时切换为异步发送
+ *
+ * @param[in]   sched               调度器句柄
+ * @param[in]   intfs               驱动接口
+ * @param[in]   handle              已打开的驱动句柄
+ * @param[in]   data_buf            颜色数据
+ * @param[in]   buf_len             颜色数据长度
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_frame_sched_add_port(PIXEL_FRAME_SCHED_HANDLE_T sched, PIXEL_DRIVER_INTFS_T *intfs,
+                                           DRIVER_HANDLE_T handle, unsigned short *data_buf, unsigned int buf_len)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    PIXEL_FRAME_SCHED_T *fs = (PIXEL_FRAME_SCHED_T *)sched;
+    PIXEL_SCHED_PORT_T *port = NULL;
+    PIXEL_FRAME_DONE_CFG_T done_cfg = {0};
+    BOOL_T async = TRUE;
+    unsigned char i = 0;
+
+    if (NULL == fs || NULL == intfs || NULL == intfs->output || NULL == intfs->config || NULL == handle ||
+        NULL == data_buf || 0 == buf_len) {
+        return OPRT_INVALID_PARM;
+    }
+    if (fs->port_num >= PIXEL_SCHED_PORT_MAX) {
+        return OPRT_EXCEED_UPPER_LIMIT;
+    }
+
+    port = &fs->port[fs->port_num];
+    memset(port, 0, sizeof(PIXEL_SCHED_PORT_T));
+    port->sched = fs;
+    port->intfs = intfs;
+    port->handle = handle;
+    port->data_buf = data_buf;
+    port->buf_len = buf_len;
+
+    done_cfg.cb = __sched_frame_done_cb;
+    done_cfg.arg = port;
+    op_ret = intfs->config(handle, DRV_CMD_SET_FRAME_DONE_CB, &done_cfg);
+    if (op_ret != OPRT_OK) {
+        TAL_PR_ERR("frame done cb unsupported:%d", op_ret);
+        return op_ret;
+    }
+
+    /* 同步模式下各路只能串行发送，仍可工作 */
+    op_ret = intfs->config(handle, DRV_CMD_SET_ASYNC_MODE, &async);
+    if (op_ret != OPRT_OK) {
+        TAL_PR_WARN("async mode unavailable, port %d sends synchronously:%d", fs->port_num, op_ret);
+    }
+
+    /* 长灯带先提交，使各路发送结束时间靠拢 */
+    for (i = fs->port_num; i > 0 && fs->port[fs->order[i - 1]].buf_len < buf_len; i--) {
+        fs->order[i] = fs->order[i - 1];
+    }
+    fs->order[i] = fs->port_num;
+
+    tal_mutex_lock(fs->mutex);
+    fs->port_num++;
+    fs->stats.port_num = fs->port_num;
+    tal_mutex_unlock(fs->mutex);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief       刷新所有端口，所有端口发送结束后返回
+ *
+ * @param[in]   sched               调度器句柄
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_frame_sched_refresh(PIXEL_FRAME_SCHED_HANDLE_T sched)
+{
+    OPERATE_RET op_ret = OPRT_OK;
+    OPERATE_RET ret = OPRT_OK;
+    PIXEL_FRAME_SCHED_T *fs = (PIXEL_FRAME_SCHED_T *)sched;
+    PIXEL_SCHED_PORT_T *port = NULL;
+    unsigned long long frame_start = 0, now = 0;
+    unsigned char i = 0, expected = 0;
+
+    if (NULL == fs) {
+        return OPRT_INVALID_PARM;
+    }
+    if (0 == fs->port_num) {
+        return OPRT_RESOURCE_NOT_READY;
+    }
+
+    /* 丢弃上次超时后迟到的通知 */
+    while (OPRT_OK == tal_semaphore_wait(fs->done_sem, 0)) {
+    }
+
+    frame_start = __sched_now_us();
+    for (i = 0; i < fs->port_num; i++) {
+        port = &fs->port[fs->order[i]];
+
+        tal_mutex_lock(fs->mutex);
+        port->pending = TRUE;
+        port->done = FALSE;
+        port->result = OPRT_OK;
+        port->submit_seq++;
+        tal_mutex_unlock(fs->mutex);
+
+        /* 异步模式下output只编码并提交，本路发送期间即开始下一路的编码 */
+        port->submit_us = __sched_now_us();
+        ret = port->intfs->output(port->handle, port->data_buf, port->buf_len);
+        now = __sched_now_us();
+        fs->stats.port[fs->order[i]].last_submit_us = (unsigned int)(now - port->submit_us);
+
+        if (ret != OPRT_OK) {
+            /* output返回错误时驱动不回调 */
+            op_ret = ret;
+            tal_mutex_lock(fs->mutex);
+            port->pending = FALSE;
+            port->result = ret;
+            port->submit_seq--;
+            tal_mutex_unlock(fs->mutex);
+            continue;
+        }
+        expected++;
+    }
+
+    while (expected > 0) {
+        if (tal_semaphore_wait(fs->done_sem, PIXEL_SCHED_DONE_TIMEOUT_MS) != OPRT_OK) {
+            break;
+        }
+        expected--;
+    }
+
+    tal_mutex_lock(fs->mutex);
+    if (expected > 0) {
+        TAL_PR_ERR("frame sched wait done timeout, %d port pending", expected);
+        for (i = 0; i < fs->port_num; i++) {
+            fs->port[i].pending = FALSE;
+        }
+        fs->stats.timeouts++;
+        op_ret = OPRT_TIMEOUT;
+    }
+    __sched_update_stats(fs, frame_start);
+    tal_mutex_unlock(fs->mutex);
+
+    if (OPRT_OK == op_ret) {
+        for (i = 0; i < fs->port_num; i++) {
+            if (fs->port[i].result != OPRT_OK) {
+                op_ret = fs->port[i].result;
+                break;
+            }
+        }
+    }
+
+    return op_ret;
+}
+
+/**
+ * @brief       获取统计
+ *
+ * @param[in]   sched               调度器句柄
+ * @param[out]  stats               统计数据
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_frame_sched_get_stats(PIXEL_FRAME_SCHED_HANDLE_T sched, PIXEL_SCHED_STATS_T *stats)
+{
+    PIXEL_FRAME_SCHED_T *fs = (PIXEL_FRAME_SCHED_T *)sched;
+
+    if (NULL == fs || NULL == stats) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_mutex_lock(fs->mutex);
+    memcpy(stats, &fs->stats, sizeof(PIXEL_SCHED_STATS_T));
+    tal_mutex_unlock(fs->mutex);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief       清零统计
+ *
+ * @param[in]   sched               调度器句柄
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_frame_sched_reset_stats(PIXEL_FRAME_SCHED_HANDLE_T sched)
+{
+    PIXEL_FRAME_SCHED_T *fs = (PIXEL_FRAME_SCHED_T *)sched;
+
+    if (NULL == fs) {
+        return OPRT_INVALID_PARM;
+    }
+
+    tal_mutex_lock(fs->mutex);
+    memset(&fs->stats, 0, sizeof(PIXEL_SCHED_STATS_T));
+    fs->stats.port_num = fs->port_num;
+    fs->total_frame_us = 0;
+    tal_mutex_unlock(fs->mutex);
+
+    return OPRT_OK;
+}
+
+/**
+ * @brief       销毁帧调度器，取消各句柄的帧完成回调，不关闭驱动句柄
+ *
+ * @param[in]   sched               调度器句柄
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_frame_sched_destroy(PIXEL_FRAME_SCHED_HANDLE_T sched)
+{
+    PIXEL_FRAME_SCHED_T *fs = (PIXEL_FRAME_SCHED_T *)sched;
+    unsigned char i = 0;
+
+    if (NULL == fs) {
+        return OPRT_INVALID_PARM;
+    }
+
+    for (i = 0; i < fs->port_num; i++) {
+        fs->port[i].intfs->config(fs->port[i].handle, DRV_CMD_SET_FRAME_DONE_CB, NULL);
+    }
+
+    tal_mutex_release(fs->mutex);
+    tal_semaphore_release(fs->done_sem);
+    tal_free(fs);
+
+    return OPRT_OK;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file tdl_pixel_frame_sched.h
+ * @author www.tuya.com
+ * @brief tdl_pixel_frame_sched module is used to refresh several pixel strips in one frame window
+ *
+ * 每个端口绑定一个已打开的驱动句柄及其颜色缓存，tdl_pixel_frame_sched_refresh 按像素点数
+ * 从多到少依次调用各端口的output：驱动工作在异步模式时，第k+1路的编码与第k路的SPI发送重叠，
+ * 长灯带先发、短灯带后发，各路的发送结束（锁存）时间相互靠拢。
+ * 调度器接管各句柄的帧完成回调，在所有端口发送结束后返回，并统计单路与整帧耗时。
+ *
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+
+#ifndef __TDL_PIXEL_FRAME_SCHED_H__
+#define __TDL_PIXEL_FRAME_SCHED_H__
+
+#include "tdd_pixel_type.h"
+#include "tdl_pixel_driver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+/* 单个调度器可管理的端口数 */
+#define PIXEL_SCHED_PORT_MAX           4
+
+/* 等待所有端口发送结束的超时时间 */
+#define PIXEL_SCHED_DONE_TIMEOUT_MS    1000
+
+/***********************************************************
+***********************typedef define***********************
+***********************************************************/
+typedef void *PIXEL_FRAME_SCHED_HANDLE_T;
+
+/* 单路统计，时间单位为微秒 */
+typedef struct {
+    unsigned int frames;            // 发送结束的帧数
+    unsigned int errors;            // output失败或发送失败的帧数
+    unsigned int last_submit_us;    // 最近一帧output调用耗时（编码 + 提交）
+    unsigned int last_frame_us;     // 最近一帧从开始提交到发送结束的耗时
+    unsigned int max_frame_us;
+} PIXEL_SCHED_PORT_STATS_T;
+
+/* 整帧统计，时间单位为微秒 */
+typedef struct {
+    unsigned int frames;            // 刷新次数
+    unsigned int timeouts;          // 等待发送结束超时次数
+    unsigned int last_frame_us;     // 最近一次刷新的总耗时（首路开始提交到末路发送结束）
+    unsigned int max_frame_us;
+    unsigned int avg_frame_us;
+    unsigned int last_skew_us;      // 最近一次刷新中各路发送结束时间的最大差值
+    unsigned int max_skew_us;
+    unsigned char port_num;
+    PIXEL_SCHED_PORT_STATS_T port[PIXEL_SCHED_PORT_MAX];    // 按添加顺序
+} PIXEL_SCHED_STATS_T;
+
+/***********************************************************
+********************function define************************
+***********************************************************/
+/**
+ * @brief       创建帧调度器
+ *
+ * @param[out]  sched               调度器句柄
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_frame_sched_create(PIXEL_FRAME_SCHED_HANDLE_T *sched);
+
+/**
+ * @brief       添加端口，驱动支持时切换为异步发送
+ *
+ * 调度器通过DRV_CMD_SET_FRAME_DONE_CB接管该句柄的帧完成回调，
+ * 颜色缓存由调用者持有，在两次刷新之间更新
+ *
+ * @param[in]   sched               调度器句柄
+ * @param[in]   intfs               驱动接口
+ * @param[in]   handle              已打开的驱动句柄
+ * @param[in]   data_buf            颜色数据
+ * @param[in]   buf_len             颜色数据长度
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_frame_sched_add_port(PIXEL_FRAME_SCHED_HANDLE_T sched, PIXEL_DRIVER_INTFS_T *intfs,
+                                           DRIVER_HANDLE_T handle, unsigned short *data_buf, unsigned int buf_len);
+
+/**
+ * @brief       刷新所有端口，所有端口发送结束后返回
+ *
+ * @param[in]   sched               调度器句柄
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_frame_sched_refresh(PIXEL_FRAME_SCHED_HANDLE_T sched);
+
+/**
+ * @brief       获取统计
+ *
+ * @param[in]   sched               调度器句柄
+ * @param[out]  stats               统计数据
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_frame_sched_get_stats(PIXEL_FRAME_SCHED_HANDLE_T sched, PIXEL_SCHED_STATS_T *stats);
+
+/**
+ * @brief       清零统计
+ *
+ * @param[in]   sched               调度器句柄
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_frame_sched_reset_stats(PIXEL_FRAME_SCHED_HANDLE_T sched);
+
+/**
+ * @brief       销毁帧调度器，取消各句柄的帧完成回调，不关闭驱动句柄
+ *
+ * @param[in]   sched               调度器句柄
+ *
+ * @return OPRT_OK on success. Others on error, please refer to tuya_error_code.h
+ */
+OPERATE_RET tdl_pixel_frame_sched_destroy(PIXEL_FRAME_SCHED_HANDLE_T sched);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TDL_PIXEL_FRAME_SCHED_H__ */
@@ -0,0 +1,11 @@
+/**
+ * @file tal_gpio.h
+ * @brief 主机构建使用的GPIO接口声明（本仓库未使用）
+ */
+
+#ifndef __TAL_GPIO_H__
+#define __TAL_GPIO_H__
+
+#include "tuya_cloud_types.h"
+
+#endif /* __TAL_GPIO_H__ */
@@ -0,0 +1,37 @@
+/**
+ * @file tal_log.h
+ * @brief 主机构建使用的日志接口，实现见tdd_pixel_sim.c
+ */
+
+#ifndef __TAL_LOG_H__
+#define __TAL_LOG_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    TAL_LOG_LEVEL_ERR,
+    TAL_LOG_LEVEL_WARN,
+    TAL_LOG_LEVEL_NOTICE,
+    TAL_LOG_LEVEL_INFO,
+    TAL_LOG_LEVEL_DEBUG,
+    TAL_LOG_LEVEL_TRACE,
+} TAL_LOG_LEVEL_E;
+
+OPERATE_RET tal_log_print(const TAL_LOG_LEVEL_E level, const char *file, const int line, const char *fmt, ...);
+
+#define TAL_PR_ERR(fmt, ...)    tal_log_print(TAL_LOG_LEVEL_ERR, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#define TAL_PR_WARN(fmt, ...)   tal_log_print(TAL_LOG_LEVEL_WARN, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#define TAL_PR_NOTICE(fmt, ...) tal_log_print(TAL_LOG_LEVEL_NOTICE, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#define TAL_PR_INFO(fmt, ...)   tal_log_print(TAL_LOG_LEVEL_INFO, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#define TAL_PR_DEBUG(fmt, ...)  tal_log_print(TAL_LOG_LEVEL_DEBUG, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+#define TAL_PR_TRACE(fmt, ...)  tal_log_print(TAL_LOG_LEVEL_TRACE, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TAL_LOG_H__ */
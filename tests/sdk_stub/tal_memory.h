@@ -0,0 +1,23 @@
+/**
+ * @file tal_memory.h
+ * @brief 主机构建使用的内存接口，实现见tdd_pixel_sim.c
+ */
+
+#ifndef __TAL_MEMORY_H__
+#define __TAL_MEMORY_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+VOID_T *tal_malloc(SIZE_T size);
+
+VOID_T tal_free(VOID_T *ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TAL_MEMORY_H__ */
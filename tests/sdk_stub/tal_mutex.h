@@ -0,0 +1,29 @@
+/**
+ * @file tal_mutex.h
+ * @brief 主机构建使用的互斥锁接口，实现见tdd_pixel_sim.c
+ */
+
+#ifndef __TAL_MUTEX_H__
+#define __TAL_MUTEX_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef VOID_T *MUTEX_HANDLE;
+
+OPERATE_RET tal_mutex_create_init(MUTEX_HANDLE *handle);
+
+OPERATE_RET tal_mutex_lock(const MUTEX_HANDLE handle);
+
+OPERATE_RET tal_mutex_unlock(const MUTEX_HANDLE handle);
+
+OPERATE_RET tal_mutex_release(const MUTEX_HANDLE handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TAL_MUTEX_H__ */
@@ -0,0 +1,31 @@
+/**
+ * @file tal_semaphore.h
+ * @brief 主机构建使用的信号量接口，实现见tdd_pixel_sim.c
+ */
+
+#ifndef __TAL_SEMAPHORE_H__
+#define __TAL_SEMAPHORE_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SEM_WAIT_FOREVER 0xFFFFFFFF
+
+typedef VOID_T *SEM_HANDLE;
+
+OPERATE_RET tal_semaphore_create_init(SEM_HANDLE *handle, const UINT_T sem_cnt, const UINT_T sem_max);
+
+OPERATE_RET tal_semaphore_wait(const SEM_HANDLE handle, const UINT_T timeout);
+
+OPERATE_RET tal_semaphore_post(const SEM_HANDLE handle);
+
+OPERATE_RET tal_semaphore_release(const SEM_HANDLE handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TAL_SEMAPHORE_H__ */
@@ -0,0 +1,36 @@
+/**
+ * @file tal_sw_timer.h
+ * @brief 主机构建使用的软件定时器接口，实现见tdd_pixel_sim.c
+ */
+
+#ifndef __TAL_SW_TIMER_H__
+#define __TAL_SW_TIMER_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef VOID_T *TIMER_ID;
+
+typedef VOID_T (*TAL_TIMER_CB)(TIMER_ID timer_id, VOID_T *arg);
+
+typedef enum {
+    TAL_TIMER_ONCE = 0,
+    TAL_TIMER_CYCLE,
+} TIMER_TYPE;
+
+OPERATE_RET tal_sw_timer_create(TAL_TIMER_CB func, VOID_T *arg, TIMER_ID *timer_id);
+
+OPERATE_RET tal_sw_timer_delete(TIMER_ID timer_id);
+
+OPERATE_RET tal_sw_timer_stop(TIMER_ID timer_id);
+
+OPERATE_RET tal_sw_timer_start(TIMER_ID timer_id, TIME_MS time_ms, TIMER_TYPE timer_type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TAL_SW_TIMER_H__ */
@@ -0,0 +1,34 @@
+/**
+ * @file tal_system.h
+ * @brief 主机构建使用的系统接口，实现见tdd_pixel_sim.c
+ */
+
+#ifndef __TAL_SYSTEM_H__
+#define __TAL_SYSTEM_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define tal_system_enter_critical()                                                                           \
+    UINT_T __irq_mask;                                                                                        \
+    __irq_mask = tkl_system_enter_critical()
+#define tal_system_exit_critical() tkl_system_exit_critical(__irq_mask)
+
+UINT_T tkl_system_enter_critical(VOID_T);
+
+VOID_T tkl_system_exit_critical(UINT_T irq_mask);
+
+SYS_TIME_T tal_system_get_millisecond(VOID_T);
+
+INT_T tal_system_get_free_heap_size(VOID_T);
+
+VOID_T tal_system_sleep(const UINT_T time_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TAL_SYSTEM_H__ */
@@ -0,0 +1,45 @@
+/**
+ * @file tal_thread.h
+ * @brief 主机构建使用的线程接口，实现见tdd_pixel_sim.c
+ */
+
+#ifndef __TAL_THREAD_H__
+#define __TAL_THREAD_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    THREAD_PRIO_0 = 5,
+    THREAD_PRIO_1 = 4,
+    THREAD_PRIO_2 = 3,
+    THREAD_PRIO_3 = 2,
+    THREAD_PRIO_4 = 1,
+    THREAD_PRIO_5 = 0,
+} THREAD_PRIO_E;
+
+typedef VOID_T *THREAD_HANDLE;
+
+typedef VOID_T (*THREAD_FUNC_CB)(VOID_T *args);
+typedef VOID_T (*THREAD_ENTER_CB)(VOID_T);
+typedef VOID_T (*THREAD_EXIT_CB)(VOID_T);
+
+typedef struct {
+    UINT_T stackDepth;
+    UINT8_T priority;
+    CHAR_T *thrdname;
+} THREAD_CFG_T;
+
+OPERATE_RET tal_thread_create_and_start(THREAD_HANDLE *handle, const THREAD_ENTER_CB enter, const THREAD_EXIT_CB exit,
+                                        const THREAD_FUNC_CB func, const VOID_T *func_args, const THREAD_CFG_T *cfg);
+
+OPERATE_RET tal_thread_delete(const THREAD_HANDLE handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TAL_THREAD_H__ */
@@ -0,0 +1,25 @@
+/**
+ * @file tkl_spi.h
+ * @brief 主机构建使用的SPI接口，实现见tdd_pixel_sim.c，类型定义在tuya_cloud_types.h
+ */
+
+#ifndef __TKL_SPI_H__
+#define __TKL_SPI_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OPERATE_RET tkl_spi_init(TUYA_SPI_NUM_E port, const TUYA_SPI_BASE_CFG_T *cfg);
+
+OPERATE_RET tkl_spi_deinit(TUYA_SPI_NUM_E port);
+
+OPERATE_RET tkl_spi_send(TUYA_SPI_NUM_E port, VOID_T *data, UINT16_T size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TKL_SPI_H__ */
@@ -0,0 +1,29 @@
+/**
+ * @file tkl_timer.h
+ * @brief 主机构建使用的硬件定时器接口，实现见tdd_pixel_sim.c
+ */
+
+#ifndef __TKL_TIMER_H__
+#define __TKL_TIMER_H__
+
+#include "tuya_cloud_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OPERATE_RET tkl_timer_init(TUYA_TIMER_NUM_E timer_id, TUYA_TIMER_BASE_CFG_T *cfg);
+
+OPERATE_RET tkl_timer_start(TUYA_TIMER_NUM_E timer_id, UINT_T us);
+
+OPERATE_RET tkl_timer_stop(TUYA_TIMER_NUM_E timer_id);
+
+OPERATE_RET tkl_timer_deinit(TUYA_TIMER_NUM_E timer_id);
+
+OPERATE_RET tkl_timer_get(TUYA_TIMER_NUM_E timer_id, UINT_T *us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TKL_TIMER_H__ */
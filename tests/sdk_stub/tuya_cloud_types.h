@@ -0,0 +1,151 @@
+/**
+ * @file tuya_cloud_types.h
+ * @brief 主机构建使用的SDK基础类型，只包含本仓库用到的定义，与TuyaOpen同名定义保持一致
+ */
+
+#ifndef __TUYA_CLOUD_TYPES_H__
+#define __TUYA_CLOUD_TYPES_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int OPERATE_RET;
+typedef int BOOL_T;
+typedef void VOID_T;
+typedef char CHAR_T;
+typedef unsigned char UCHAR_T;
+typedef unsigned char UINT8_T;
+typedef unsigned short UINT16_T;
+typedef int INT_T;
+typedef unsigned int UINT_T;
+typedef unsigned int UINT32_T;
+typedef unsigned long long UINT64_T;
+typedef size_t SIZE_T;
+typedef UINT64_T SYS_TIME_T;
+typedef UINT_T TIME_MS;
+
+#ifndef TRUE
+#define TRUE  1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#ifndef IN
+#define IN
+#endif
+#ifndef OUT
+#define OUT
+#endif
+#ifndef INOUT
+#define INOUT
+#endif
+
+#define OPRT_OK                  (0)
+#define OPRT_COM_ERROR           (-1)
+#define OPRT_INVALID_PARM        (-2)
+#define OPRT_MALLOC_FAILED       (-3)
+#define OPRT_NOT_SUPPORTED       (-4)
+#define OPRT_TIMEOUT             (-12)
+#define OPRT_NOT_FOUND           (-20)
+#define OPRT_RESOURCE_NOT_READY  (-24)
+#define OPRT_EXCEED_UPPER_LIMIT  (-32)
+
+#define TUYA_CALL_ERR_GOTO(func, label) \
+    do {                                \
+        rt = (func);                    \
+        if (OPRT_OK != (rt)) {          \
+            goto label;                 \
+        }                               \
+    } while (0)
+
+typedef enum {
+    TUYA_PWM_NUM_0,
+    TUYA_PWM_NUM_1,
+    TUYA_PWM_NUM_2,
+    TUYA_PWM_NUM_3,
+    TUYA_PWM_NUM_4,
+    TUYA_PWM_NUM_5,
+    TUYA_PWM_NUM_MAX,
+} TUYA_PWM_NUM_E;
+
+typedef enum {
+    TUYA_TIMER_NUM_0,
+    TUYA_TIMER_NUM_1,
+    TUYA_TIMER_NUM_2,
+    TUYA_TIMER_NUM_3,
+    TUYA_TIMER_NUM_MAX,
+} TUYA_TIMER_NUM_E;
+
+typedef enum {
+    TUYA_TIMER_MODE_ONCE = 0,
+    TUYA_TIMER_MODE_PERIOD,
+} TUYA_TIMER_MODE_E;
+
+typedef VOID_T (*TUYA_TIMER_ISR_CB)(VOID_T *args);
+
+typedef struct {
+    TUYA_TIMER_MODE_E mode;
+    TUYA_TIMER_ISR_CB cb;
+    VOID_T *args;
+} TUYA_TIMER_BASE_CFG_T;
+
+typedef enum {
+    TUYA_SPI_NUM_0,
+    TUYA_SPI_NUM_1,
+    TUYA_SPI_NUM_2,
+    TUYA_SPI_NUM_3,
+    TUYA_SPI_NUM_MAX,
+} TUYA_SPI_NUM_E;
+
+typedef enum {
+    TUYA_SPI_ROLE_INACTIVE,
+    TUYA_SPI_ROLE_MASTER,
+    TUYA_SPI_ROLE_SLAVE,
+    TUYA_SPI_ROLE_MASTER_SIMPLEX,
+    TUYA_SPI_ROLE_SLAVE_SIMPLEX,
+} TUYA_SPI_ROLE_E;
+
+typedef enum {
+    TUYA_SPI_MODE0,
+    TUYA_SPI_MODE1,
+    TUYA_SPI_MODE2,
+    TUYA_SPI_MODE3,
+} TUYA_SPI_MODE_E;
+
+typedef enum {
+    TUYA_SPI_AUTO_TYPE,
+    TUYA_SPI_SOFT_TYPE,
+    TUYA_SPI_SOFT_ONE_WIRE_TYPE,
+} TUYA_SPI_TYPE_E;
+
+typedef enum {
+    TUYA_SPI_DATA_BIT8,
+    TUYA_SPI_DATA_BIT16,
+} TUYA_SPI_DATABITS_E;
+
+typedef enum {
+    TUYA_SPI_ORDER_MSB2LSB,
+    TUYA_SPI_ORDER_LSB2MSB,
+} TUYA_SPI_BIT_ORDER_E;
+
+typedef struct {
+    TUYA_SPI_ROLE_E role;
+    TUYA_SPI_MODE_E mode;
+    TUYA_SPI_TYPE_E type;
+    TUYA_SPI_DATABITS_E databits;
+    TUYA_SPI_BIT_ORDER_E bitorder;
+    UINT_T freq_hz;
+    UINT_T spi_dma_flags;
+} TUYA_SPI_BASE_CFG_T;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TUYA_CLOUD_TYPES_H__ */
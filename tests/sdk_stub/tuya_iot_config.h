@@ -0,0 +1,9 @@
+/**
+ * @file tuya_iot_config.h
+ * @brief 主机构建使用的空配置
+ */
+
+#ifndef __TUYA_IOT_CONFIG_H__
+#define __TUYA_IOT_CONFIG_H__
+
+#endif /* __TUYA_IOT_CONFIG_H__ */
@@ -0,0 +1,913 @@
+/**
+ * @file test_pixel.c
+ * @author www.tuya.com
+ * @brief host wire-level regression tests: drive the pixel drivers and led controller through tdd_pixel_sim,
+ *        decode the captured spi stream with tdd_pixel_decode and compare against the expected pixels
+ * @version 0.1
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) tuya.inc 2026
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "tuya_cloud_types.h"
+#include "tal_log.h"
+
+#include "tdl_pixel_driver.h"
+#include "tdd_pixel_ws2812.h"
+#include "tdd_pixel_apa102.h"
+#include "tdd_pixel_basic.h"
+#include "tdd_pixel_decode.h"
+#include "tdd_pixel_sim.h"
+#include "tdl_pixel_clip.h"
+#include "tdl_pixel_frame_sched.h"
+#include "led_controller.h"
+
+/***********************************************************
+************************macro define************************
+***********************************************************/
+#define TEST_PORT            TUYA_SPI_NUM_0
+#define TEST_PIXEL_NUM       12
+#define TEST_WIRE_MAX        PIXEL_SIM_SPI_CAPTURE_MAX
+#define TEST_DATA_MAX        (TEST_PIXEL_NUM * 4)
+#define TEST_CLIP_PIXEL_NUM  4
+#define TEST_CLIP_MAX        128
+
+#define TEST_CHECK(cond)                                                                 \
+    do {                                                                                 \
+        if (!(cond)) {                                                                   \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);              \
+            test_fail_cnt++;                                                             \
+        }                                                                                \
+    } while (0)
+
+/***********************************************************
+***********************variable define**********************
+***********************************************************/
+/* 各线序下R、G、B在发送数据中的位置 */
+static const unsigned char order_pos_tbl[][3] = {
+    {0, 1, 2},  // RGB
+    {0, 2, 1},  // RBG
+    {1, 0, 2},  // GRB
+    {2, 0, 1},  // GBR
+    {1, 2, 0},  // BRG
+    {2, 1, 0},  // BGR
+};
+
+static const unsigned char code_bits_tbl[] = {8, 4, 3};
+
+static unsigned char wire_buf[TEST_WIRE_MAX];
+static unsigned int wire_len = 0;
+static unsigned int wire_send_cnt = 0;
+static unsigned int test_fail_cnt = 0;
+
+/***********************************************************
+***********************function define**********************
+***********************************************************/
+/**
+ * @brief 拼接测试期间所有tkl_spi_send的数据，分段、分块发送时还原整条线上的码流
+ */
+static void __wire_hook(TUYA_SPI_NUM_E port, const unsigned char *data, unsigned int len, void *arg)
+{
+    (void)arg;
+
+    if (port != TEST_PORT || wire_len + len > TEST_WIRE_MAX) {
+        return;
+    }
+    memcpy(wire_buf + wire_len, data, len);
+    wire_len += len;
+    wire_send_cnt++;
+}
+
+static void __wire_clear(void)
+{
+    wire_len = 0;
+    wire_send_cnt = 0;
+}
+
+/**
+ * @brief 解码拼接的码流并检查像素数据与时序，expect按线序排列
+ */
+static void __wire_expect(PIXEL_SPI_CODE_MODE_E code_mode, PIXEL_CHIP_E chip, const unsigned char *expect,
+                          unsigned int expect_len)
+{
+    PIXEL_SIM_SPI_STAT_T stat;
+    PIXEL_DECODE_TIMING_T timing;
+    unsigned char data[TEST_DATA_MAX];
+    int len = 0;
+
+    TEST_CHECK(OPRT_OK == tdd_pixel_sim_spi_get_stat(TEST_PORT, &stat));
+    len = tdd_pixel_spi_decode(wire_buf, wire_len, code_bits_tbl[code_mode], stat.freq_hz, chip, data, sizeof(data),
+                               &timing);
+    TEST_CHECK(len == (int)expect_len);
+    TEST_CHECK(0 == memcmp(data, expect, expect_len));
+    TEST_CHECK(0 == timing.invalid_num);
+    TEST_CHECK(0 == timing.out_of_spec);
+    TEST_CHECK(timing.reset_ok);
+}
+
+static void __frame_fill(unsigned char *rgb, unsigned char seed)
+{
+    unsigned int i = 0;
+
+    for (i = 0; i < TEST_PIXEL_NUM * 3; i++) {
+        rgb[i] = (unsigned char)(seed + i * 21);
+    }
+}
+
+/**
+ * @brief RGB888帧按线序排列为期望的线上数据
+ */
+static void __frame_to_wire(const unsigned char *rgb, RGB_ORDER_MODE_E line_seq, unsigned char *out)
+{
+    unsigned int i = 0, c = 0;
+
+    for (i = 0; i < TEST_PIXEL_NUM; i++) {
+        for (c = 0; c < 3; c++) {
+            out[i * 3 + order_pos_tbl[line_seq][c]] = rgb[i * 3 + c];
+        }
+    }
+}
+
+static OPERATE_RET __drv_open(DRIVER_HANDLE_T *handle, PIXEL_SPI_CODE_MODE_E code_mode, RGB_ORDER_MODE_E line_seq,
+                              unsigned short stream_px)
+{
+    PIXEL_DRIVER_CONFIG_T cfg = {
+        .port = TEST_PORT,
+        .line_seq = line_seq,
+        .code_mode = code_mode,
+        .chip = PIXEL_CHIP_WS2812B,
+        .chan_num = 3,
+        .stream_px = stream_px,
+    };
+
+    return tdd_ws2812_driver_open_cfg(handle, TEST_PIXEL_NUM, &cfg);
+}
+
+/**
+ * @brief 发送一帧，等待发送线程处理完成后检查线上数据
+ */
+static void __send_and_expect(DRIVER_HANDLE_T handle, PIXEL_SPI_CODE_MODE_E code_mode, RGB_ORDER_MODE_E line_seq,
+                              const unsigned char *rgb)
+{
+    PIXEL_FRAME_T frame = {PIXEL_FRAME_FMT_RGB888, TEST_PIXEL_NUM, (unsigned char *)rgb};
+    unsigned char expect[TEST_PIXEL_NUM * 3];
+
+    __wire_clear();
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_send_frame(handle, &frame));
+    tdd_pixel_sim_advance(0);
+    __frame_to_wire(rgb, line_seq, expect);
+    __wire_expect(code_mode, PIXEL_CHIP_WS2812B, expect, sizeof(expect));
+}
+
+/**
+ * @brief 每种码型与线序同步发送；四通道设备R、G、B按线序发送后发送W，RGB帧的W为0
+ */
+static void __test_wire_modes(void)
+{
+    DRIVER_HANDLE_T handle = NULL;
+    unsigned char rgb[TEST_PIXEL_NUM * 3], rgbw[TEST_PIXEL_NUM * 4], expect[TEST_PIXEL_NUM * 4];
+    PIXEL_FRAME_T frame = {PIXEL_FRAME_FMT_RGBW8888, TEST_PIXEL_NUM, rgbw};
+    PIXEL_DRIVER_CONFIG_T cfg = {
+        .port = TEST_PORT,
+        .line_seq = GRB_ORDER,
+        .code_mode = PIXEL_SPI_CODE_4BIT,
+        .chip = PIXEL_CHIP_SK6812,
+        .chan_num = 4,
+    };
+    PIXEL_SPI_CODE_MODE_E code_mode = 0;
+    RGB_ORDER_MODE_E line_seq = 0;
+    unsigned int i = 0, c = 0;
+
+    __frame_fill(rgb, 0x35);
+    for (code_mode = PIXEL_SPI_CODE_8BIT; code_mode <= PIXEL_SPI_CODE_3BIT; code_mode++) {
+        for (line_seq = RGB_ORDER; line_seq <= BGR_ORDER; line_seq++) {
+            TEST_CHECK(OPRT_OK == __drv_open(&handle, code_mode, line_seq, 0));
+            __send_and_expect(handle, code_mode, line_seq, rgb);
+            TEST_CHECK(OPRT_OK == tdd_ws2812_driver_close(&handle));
+        }
+    }
+
+    for (i = 0; i < TEST_PIXEL_NUM; i++) {
+        for (c = 0; c < 4; c++) {
+            rgbw[i * 4 + c] = (unsigned char)(0x17 + i * 13 + c * 61);
+        }
+        for (c = 0; c < 3; c++) {
+            expect[i * 4 + order_pos_tbl[GRB_ORDER][c]] = rgbw[i * 4 + c];
+        }
+        expect[i * 4 + 3] = rgbw[i * 4 + 3];
+    }
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_open_cfg(&handle, TEST_PIXEL_NUM, &cfg));
+    __wire_clear();
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_send_frame(handle, &frame));
+    __wire_expect(PIXEL_SPI_CODE_4BIT, PIXEL_CHIP_SK6812, expect, sizeof(expect));
+
+    /* RGB帧发送到四通道设备 */
+    frame.fmt = PIXEL_FRAME_FMT_RGB888;
+    frame.data = rgb;
+    for (i = 0; i < TEST_PIXEL_NUM; i++) {
+        for (c = 0; c < 3; c++) {
+            expect[i * 4 + order_pos_tbl[GRB_ORDER][c]] = rgb[i * 3 + c];
+        }
+        expect[i * 4 + 3] = 0;
+    }
+    __wire_clear();
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_send_frame(handle, &frame));
+    __wire_expect(PIXEL_SPI_CODE_4BIT, PIXEL_CHIP_SK6812, expect, sizeof(expect));
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_close(&handle));
+}
+
+/**
+ * @brief 异步双缓存：连续提交的帧按顺序发送，发送线程完成后线上为最后一帧
+ */
+static void __test_wire_async(void)
+{
+    DRIVER_HANDLE_T handle = NULL;
+    PIXEL_DRV_TX_STATS_T stats;
+    unsigned char rgb[TEST_PIXEL_NUM * 3];
+    PIXEL_FRAME_T frame = {PIXEL_FRAME_FMT_RGB888, TEST_PIXEL_NUM, rgb};
+    BOOL_T async = TRUE;
+    unsigned int i = 0;
+
+    TEST_CHECK(OPRT_OK == __drv_open(&handle, PIXEL_SPI_CODE_8BIT, GRB_ORDER, 0));
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_SET_ASYNC_MODE, &async));
+    for (i = 0; i < 4; i++) {
+        __frame_fill(rgb, (unsigned char)(i * 7));
+        __send_and_expect(handle, PIXEL_SPI_CODE_8BIT, GRB_ORDER, rgb);
+    }
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_GET_TX_STATS, &stats));
+    TEST_CHECK(4 == stats.frames_sent);
+
+    /* 上一帧已发送完成，相同的帧跳过发送 */
+    __wire_clear();
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_send_frame(handle, &frame));
+    tdd_pixel_sim_advance(0);
+    TEST_CHECK(0 == wire_len);
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_GET_TX_STATS, &stats));
+    TEST_CHECK(1 == stats.frames_skipped);
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_close(&handle));
+}
+
+static unsigned int done_cnt = 0;
+static int done_result = OPRT_OK;
+
+static void __done_cb(DRIVER_HANDLE_T handle, int result, void *arg)
+{
+    (void)handle;
+    (void)arg;
+
+    done_cnt++;
+    done_result = result;
+}
+
+/**
+ * @brief 帧完成回调：output返回成功的帧按提交顺序各回调一次，同步发送失败返回错误且不回调，
+ *        异步发送失败在回调中报告
+ */
+static void __test_wire_done(void)
+{
+    DRIVER_HANDLE_T handle = NULL;
+    unsigned char rgb[TEST_PIXEL_NUM * 3];
+    PIXEL_FRAME_T frame = {PIXEL_FRAME_FMT_RGB888, TEST_PIXEL_NUM, rgb};
+    PIXEL_FRAME_DONE_CFG_T done_cfg = {__done_cb, NULL};
+    BOOL_T async = TRUE;
+
+    done_cnt = 0;
+    __frame_fill(rgb, 0x42);
+    TEST_CHECK(OPRT_OK == __drv_open(&handle, PIXEL_SPI_CODE_8BIT, GRB_ORDER, 0));
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_SET_FRAME_DONE_CB, &done_cfg));
+
+    TEST_CHECK(OPRT_OK == tdd_pixel_sim_spi_fail_next(TEST_PORT, 1));
+    TEST_CHECK(OPRT_OK != tdd_ws2812_driver_send_frame(handle, &frame));
+    TEST_CHECK(0 == done_cnt);
+    /* 失败后相同的帧重新发送 */
+    __send_and_expect(handle, PIXEL_SPI_CODE_8BIT, GRB_ORDER, rgb);
+    TEST_CHECK(1 == done_cnt && OPRT_OK == done_result);
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_send_frame(handle, &frame));
+    TEST_CHECK(2 == done_cnt);
+
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_SET_ASYNC_MODE, &async));
+    rgb[0] ^= 0xFF;
+    TEST_CHECK(OPRT_OK == tdd_pixel_sim_spi_fail_next(TEST_PORT, 1));
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_send_frame(handle, &frame));
+    tdd_pixel_sim_advance(0);
+    TEST_CHECK(3 == done_cnt && OPRT_OK != done_result);
+    __send_and_expect(handle, PIXEL_SPI_CODE_8BIT, GRB_ORDER, rgb);
+    TEST_CHECK(4 == done_cnt && OPRT_OK == done_result);
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_close(&handle));
+}
+
+/**
+ * @brief 编码帧缓存：只出现一次的帧（包括键为0的全黑帧）不写入，重复出现的帧命中缓存，线上数据不变
+ */
+static void __test_wire_cache(void)
+{
+    DRIVER_HANDLE_T handle = NULL;
+    PIXEL_DRV_CACHE_STATS_T cache;
+    unsigned char rgb_a[TEST_PIXEL_NUM * 3], rgb_b[TEST_PIXEL_NUM * 3], rgb_k[TEST_PIXEL_NUM * 3];
+    unsigned char expect[TEST_PIXEL_NUM * 3];
+    PIXEL_FRAME_T frame = {PIXEL_FRAME_FMT_RGB888, TEST_PIXEL_NUM, rgb_a};
+    BOOL_T async = TRUE;
+    unsigned int cache_size = 16 * 1024;
+    unsigned int i = 0;
+
+    __frame_fill(rgb_a, 0x11);
+    __frame_fill(rgb_b, 0x77);
+    memset(rgb_k, 0, sizeof(rgb_k));
+    TEST_CHECK(OPRT_OK == __drv_open(&handle, PIXEL_SPI_CODE_4BIT, GRB_ORDER, 0));
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_SET_FRAME_CACHE, &cache_size));
+    __send_and_expect(handle, PIXEL_SPI_CODE_4BIT, GRB_ORDER, rgb_k);
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_GET_FRAME_CACHE_STATS, &cache));
+    TEST_CHECK(0 == cache.inserts);
+    for (i = 0; i < 4; i++) {
+        __send_and_expect(handle, PIXEL_SPI_CODE_4BIT, GRB_ORDER, rgb_a);
+        __send_and_expect(handle, PIXEL_SPI_CODE_4BIT, GRB_ORDER, rgb_b);
+    }
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_GET_FRAME_CACHE_STATS, &cache));
+    TEST_CHECK(cache.hits > 0);
+
+    /* 异步模式下两个缓存都在发送命中的条目时缩小上限：等发送结束后再淘汰，线上仍为完整的两帧 */
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_SET_ASYNC_MODE, &async));
+    cache_size = 1;
+    __wire_clear();
+    frame.data = rgb_a;
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_send_frame(handle, &frame));
+    frame.data = rgb_b;
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_send_frame(handle, &frame));
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_SET_FRAME_CACHE, &cache_size));
+    tdd_pixel_sim_advance(0);
+    /* 两帧码流等长，分开解码 */
+    TEST_CHECK(0 == wire_len % 2);
+    wire_len /= 2;
+    __frame_to_wire(rgb_a, GRB_ORDER, expect);
+    __wire_expect(PIXEL_SPI_CODE_4BIT, PIXEL_CHIP_WS2812B, expect, sizeof(expect));
+    memmove(wire_buf, wire_buf + wire_len, wire_len);
+    __frame_to_wire(rgb_b, GRB_ORDER, expect);
+    __wire_expect(PIXEL_SPI_CODE_4BIT, PIXEL_CHIP_WS2812B, expect, sizeof(expect));
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_GET_FRAME_CACHE_STATS, &cache));
+    TEST_CHECK(0 == cache.entries);
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_close(&handle));
+}
+
+/**
+ * @brief 纯色重复块：端口支持链式发送时重复块一次连续发出，否则铺满发送缓存；
+ *        线上都为一次发送的整帧纯色，之后的非纯色帧仍正确编码
+ */
+static void __test_wire_repeat_mode(BOOL_T chain)
+{
+    DRIVER_HANDLE_T handle = NULL;
+    PIXEL_DRV_TX_STATS_T stats;
+    PIXEL_SIM_SPI_STAT_T stat;
+    unsigned char rgb[TEST_PIXEL_NUM * 3], rgb_u[TEST_PIXEL_NUM * 3];
+    unsigned short block = 5;
+    unsigned int i = 0, repeat_cnt = 0;
+
+    for (i = 0; i < TEST_PIXEL_NUM; i++) {
+        rgb_u[i * 3] = 0x12;
+        rgb_u[i * 3 + 1] = 0xA5;
+        rgb_u[i * 3 + 2] = 0x3C;
+    }
+    __frame_fill(rgb, 0x21);
+    TEST_CHECK(OPRT_OK == tdd_pixel_sim_spi_get_stat(TEST_PORT, &stat));
+    repeat_cnt = stat.repeat_cnt;
+    TEST_CHECK(OPRT_OK == tdd_pixel_sim_spi_set_repeat(TEST_PORT, chain));
+    TEST_CHECK(OPRT_OK == __drv_open(&handle, PIXEL_SPI_CODE_3BIT, GRB_ORDER, 0));
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_SET_UNIFORM_REPEAT, &block));
+    __send_and_expect(handle, PIXEL_SPI_CODE_3BIT, GRB_ORDER, rgb);
+    __send_and_expect(handle, PIXEL_SPI_CODE_3BIT, GRB_ORDER, rgb_u);
+    TEST_CHECK(1 == wire_send_cnt);
+    /* 纯色帧覆盖了两个缓存上的非纯色帧后，再发送该帧不能被逐像素比较当作未变化 */
+    rgb_u[0] = 0x34;
+    for (i = 1; i < TEST_PIXEL_NUM; i++) {
+        memcpy(&rgb_u[i * 3], rgb_u, 3);
+    }
+    __send_and_expect(handle, PIXEL_SPI_CODE_3BIT, GRB_ORDER, rgb_u);
+    __send_and_expect(handle, PIXEL_SPI_CODE_3BIT, GRB_ORDER, rgb);
+    rgb[0] ^= 0xFF;
+    __send_and_expect(handle, PIXEL_SPI_CODE_3BIT, GRB_ORDER, rgb);
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_config(handle, DRV_CMD_GET_TX_STATS, &stats));
+    TEST_CHECK(2 == stats.frames_repeat);
+    TEST_CHECK(OPRT_OK == tdd_pixel_sim_spi_get_stat(TEST_PORT, &stat));
+    TEST_CHECK((chain ? 2 : 0) == stat.repeat_cnt - repeat_cnt);
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_close(&handle));
+    TEST_CHECK(OPRT_OK == tdd_pixel_sim_spi_set_repeat(TEST_PORT, FALSE));
+}
+
+static void __test_wire_repeat(void)
+{
+    __test_wire_repeat_mode(FALSE);
+    __test_wire_repeat_mode(TRUE);
+}
+
+/**
+ * @brief 流式发送：分块边编码边发送，拼接后为整帧
+ */
+static void __test_wire_stream(void)
+{
+    DRIVER_HANDLE_T handle = NULL;
+    unsigned char rgb[TEST_PIXEL_NUM * 3];
+
+    __frame_fill(rgb, 0x5A);
+    TEST_CHECK(OPRT_OK == __drv_open(&handle, PIXEL_SPI_CODE_8BIT, BGR_ORDER, 5));
+    __send_and_expect(handle, PIXEL_SPI_CODE_8BIT, BGR_ORDER, rgb);
+    TEST_CHECK(wire_send_cnt > 1);
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_close(&handle));
+}
+
+/**
+ * @brief 两种驱动共用端口占用：已被WS2812设备打开的端口不能再打开APA102设备
+ */
+static void __test_wire_port_claim(void)
+{
+    DRIVER_HANDLE_T handle = NULL, apa = NULL;
+    PIXEL_DRIVER_CONFIG_T cfg = {
+        .port = TEST_PORT,
+        .line_seq = BGR_ORDER,
+        .chip = PIXEL_CHIP_APA102,
+    };
+
+    TEST_CHECK(OPRT_OK == __drv_open(&handle, PIXEL_SPI_CODE_8BIT, GRB_ORDER, 0));
+    TEST_CHECK(OPRT_OK != tdd_apa102_driver_open_cfg(&apa, TEST_PIXEL_NUM, &cfg));
+    TEST_CHECK(OPRT_OK != __drv_open(&apa, PIXEL_SPI_CODE_8BIT, GRB_ORDER, 0));
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_close(&handle));
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_open_cfg(&apa, TEST_PIXEL_NUM, &cfg));
+    TEST_CHECK(OPRT_OK != __drv_open(&handle, PIXEL_SPI_CODE_8BIT, GRB_ORDER, 0));
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_close(&apa));
+}
+
+/**
+ * @brief 检查APA102/SK9822线上数据：零起始帧、每像素0xE0|全局电流与线序颜色、零结束帧
+ */
+static void __apa102_expect(const unsigned char *color, RGB_ORDER_MODE_E line_seq, unsigned char global,
+                            unsigned int end_len)
+{
+    unsigned char expect[4 + TEST_PIXEL_NUM * 4 + 8];
+    unsigned int i = 0, c = 0, len = 0;
+
+    memset(expect, 0, sizeof(expect));
+    len = 4;
+    for (i = 0; i < TEST_PIXEL_NUM; i++, len += 4) {
+        expect[len] = 0xE0 | global;
+        for (c = 0; c < 3; c++) {
+            expect[len + 1 + order_pos_tbl[line_seq][c]] = color[i * 3 + c];
+        }
+    }
+    len += end_len;
+    TEST_CHECK(1 == wire_send_cnt);
+    TEST_CHECK(len == wire_len);
+    TEST_CHECK(0 == memcmp(wire_buf, expect, len));
+}
+
+/**
+ * @brief APA102/SK9822：起始/结束帧、亮度先换算为5位全局电流、发送失败后重发
+ */
+static void __test_wire_apa102(void)
+{
+    DRIVER_HANDLE_T handle = NULL;
+    PIXEL_DRIVER_CONFIG_T cfg = {
+        .port = TEST_PORT,
+        .line_seq = BGR_ORDER,
+        .chip = PIXEL_CHIP_APA102,
+    };
+    PIXEL_FRAME_DONE_CFG_T done_cfg = {__done_cb, NULL};
+    unsigned char rgb[TEST_PIXEL_NUM * 3], dim[TEST_PIXEL_NUM * 3];
+    PIXEL_FRAME_T frame = {PIXEL_FRAME_FMT_RGB888, TEST_PIXEL_NUM, rgb};
+    unsigned char brightness = 0, global = 0;
+    unsigned int i = 0;
+
+    __frame_fill(rgb, 0x61);
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_open_cfg(&handle, TEST_PIXEL_NUM, &cfg));
+    __wire_clear();
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_send_frame(handle, &frame));
+    __apa102_expect(rgb, BGR_ORDER, APA102_GLOBAL_CURRENT_MAX, 4);
+
+    /* 亮度15、全局电流上限17：像素头为17 * 15 / 255 = 1，颜色保持完整的8位 */
+    global = 17;
+    brightness = 15;
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_config(handle, DRV_CMD_SET_GLOBAL_CURRENT, &global));
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_config(handle, DRV_CMD_SET_BRIGHTNESS, &brightness));
+    __wire_clear();
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_send_frame(handle, &frame));
+    __apa102_expect(rgb, BGR_ORDER, 1, 4);
+
+    /* 亮度128、上限31：像素头向上取整为16，颜色缩放128 * 31 / (16 * 255)，255映射为248 */
+    global = APA102_GLOBAL_CURRENT_MAX;
+    brightness = 128;
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_config(handle, DRV_CMD_SET_GLOBAL_CURRENT, &global));
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_config(handle, DRV_CMD_SET_BRIGHTNESS, &brightness));
+    for (i = 0; i < sizeof(rgb); i++) {
+        rgb[i] = (i % 2) ? 0xFF : 0;
+        dim[i] = (i % 2) ? 248 : 0;
+    }
+    __wire_clear();
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_send_frame(handle, &frame));
+    __apa102_expect(dim, BGR_ORDER, 16, 4);
+
+    /* 发送失败返回错误且不回调，相同的帧之后重新发送而不是跳过 */
+    done_cnt = 0;
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_config(handle, DRV_CMD_SET_FRAME_DONE_CB, &done_cfg));
+    rgb[0] = 0x40;
+    dim[0] = 0x3E;
+    TEST_CHECK(OPRT_OK == tdd_pixel_sim_spi_fail_next(TEST_PORT, 1));
+    __wire_clear();
+    TEST_CHECK(OPRT_OK != tdd_apa102_driver_send_frame(handle, &frame));
+    TEST_CHECK(0 == wire_len);
+    TEST_CHECK(0 == done_cnt);
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_send_frame(handle, &frame));
+    __apa102_expect(dim, BGR_ORDER, 16, 4);
+    TEST_CHECK(1 == done_cnt);
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_close(&handle));
+
+    /* SK9822结束帧前多4字节复位帧 */
+    cfg.chip = PIXEL_CHIP_SK9822;
+    cfg.line_seq = RGB_ORDER;
+    __frame_fill(rgb, 0x19);
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_open_cfg(&handle, TEST_PIXEL_NUM, &cfg));
+    __wire_clear();
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_send_frame(handle, &frame));
+    __apa102_expect(rgb, RGB_ORDER, APA102_GLOBAL_CURRENT_MAX, 8);
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_close(&handle));
+}
+
+/**
+ * @brief 帧调度器：两路（异步WS2812与同步APA102）一次刷新都发送完成，异步发送失败在刷新结果中报告
+ */
+static void __test_wire_sched(void)
+{
+    PIXEL_DRIVER_INTFS_T ws2812_intfs = {
+        .close = tdd_ws2812_driver_close,
+        .output = tdd_ws2812_driver_send_data,
+        .config = tdd_ws2812_driver_config,
+    };
+    PIXEL_DRIVER_INTFS_T apa102_intfs = {
+        .close = tdd_apa102_driver_close,
+        .output = tdd_apa102_driver_send_data,
+        .config = tdd_apa102_driver_config,
+    };
+    PIXEL_DRIVER_CONFIG_T cfg = {
+        .port = TUYA_SPI_NUM_1,
+        .line_seq = BGR_ORDER,
+        .chip = PIXEL_CHIP_APA102,
+    };
+    PIXEL_FRAME_SCHED_HANDLE_T sched = NULL;
+    PIXEL_SCHED_STATS_T stats;
+    PIXEL_SIM_SPI_STAT_T stat;
+    DRIVER_HANDLE_T handle = NULL, apa = NULL;
+    unsigned short data[TEST_PIXEL_NUM * 3], apa_data[TEST_PIXEL_NUM * 3];
+    unsigned char rgb[TEST_PIXEL_NUM * 3], expect[TEST_PIXEL_NUM * 3];
+    unsigned int i = 0, apa_cnt = 0;
+
+    __frame_fill(rgb, 0x2B);
+    for (i = 0; i < TEST_PIXEL_NUM * 3; i++) {
+        data[i] = rgb[i];
+        apa_data[i] = (unsigned short)(0xFF - rgb[i]);
+    }
+    __frame_to_wire(rgb, GRB_ORDER, expect);
+    TEST_CHECK(OPRT_OK == __drv_open(&handle, PIXEL_SPI_CODE_8BIT, GRB_ORDER, 0));
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_open_cfg(&apa, TEST_PIXEL_NUM, &cfg));
+    TEST_CHECK(OPRT_OK == tdd_pixel_sim_spi_get_stat(TUYA_SPI_NUM_1, &stat));
+    apa_cnt = stat.send_cnt;
+    TEST_CHECK(OPRT_OK == tdl_pixel_frame_sched_create(&sched));
+    TEST_CHECK(OPRT_OK == tdl_pixel_frame_sched_add_port(sched, &ws2812_intfs, handle, data, TEST_PIXEL_NUM * 3));
+    TEST_CHECK(OPRT_OK == tdl_pixel_frame_sched_add_port(sched, &apa102_intfs, apa, apa_data, TEST_PIXEL_NUM * 3));
+
+    __wire_clear();
+    TEST_CHECK(OPRT_OK == tdl_pixel_frame_sched_refresh(sched));
+    __wire_expect(PIXEL_SPI_CODE_8BIT, PIXEL_CHIP_WS2812B, expect, sizeof(expect));
+    TEST_CHECK(OPRT_OK == tdd_pixel_sim_spi_get_stat(TUYA_SPI_NUM_1, &stat));
+    TEST_CHECK(apa_cnt + 1 == stat.send_cnt);
+
+    /* WS2812一路发送失败：刷新返回错误，下一次刷新重新发送相同的帧 */
+    rgb[0] ^= 0xFF;
+    data[0] = rgb[0];
+    __frame_to_wire(rgb, GRB_ORDER, expect);
+    TEST_CHECK(OPRT_OK == tdd_pixel_sim_spi_fail_next(TEST_PORT, 1));
+    __wire_clear();
+    TEST_CHECK(OPRT_OK != tdl_pixel_frame_sched_refresh(sched));
+    TEST_CHECK(0 == wire_len);
+    __wire_clear();
+    TEST_CHECK(OPRT_OK == tdl_pixel_frame_sched_refresh(sched));
+    __wire_expect(PIXEL_SPI_CODE_8BIT, PIXEL_CHIP_WS2812B, expect, sizeof(expect));
+
+    TEST_CHECK(OPRT_OK == tdl_pixel_frame_sched_get_stats(sched, &stats));
+    TEST_CHECK(3 == stats.frames);
+    TEST_CHECK(0 == stats.timeouts);
+    TEST_CHECK(2 == stats.port_num);
+    TEST_CHECK(1 == stats.port[0].errors);
+    TEST_CHECK(0 == stats.port[1].errors);
+    TEST_CHECK(OPRT_OK == tdl_pixel_frame_sched_destroy(sched));
+    TEST_CHECK(OPRT_OK == tdd_ws2812_driver_close(&handle));
+    TEST_CHECK(OPRT_OK == tdd_apa102_driver_close(&apa));
+}
+
+/**
+ * @brief 兼容接口tdd_rgb_transform_spi_data：每个数据位输出一个字节的0/1码，0/1码变化后仍正确
+ */
+static void __test_wire_compat(void)
+{
+    static const unsigned char code_tbl[][2] = {{0xC0, 0xF8}, {0x80, 0xFC}, {0xC0, 0xF8}};
+    unsigned char spi[8];
+    unsigned int i = 0, v = 0, b = 0, bad = 0;
+
+    for (i = 0; i < sizeof(code_tbl) / sizeof(code_tbl[0]); i++) {
+        for (v = 0; v < 256; v++) {
+            tdd_rgb_transform_spi_data((unsigned char)v, code_tbl[i][0], code_tbl[i][1], spi);
+            for (b = 0; b < 8; b++) {
+                bad += (spi[b] != ((v & (0x80 >> b)) ? code_tbl[i][1] : code_tbl[i][0])) ? 1 : 0;
+            }
+        }
+    }
+    TEST_CHECK(0 == bad);
+}
+
+static void __test_wire(void)
+{
+    __test_wire_modes();
+    __test_wire_async();
+    __test_wire_done();
+    __test_wire_cache();
+    __test_wire_repeat();
+    __test_wire_stream();
+    __test_wire_port_claim();
+    __test_wire_apa102();
+    __test_wire_sched();
+    __test_wire_compat();
+}
+
+/**
+ * @brief 写入片段文件头，返回长度
+ */
+static unsigned int __clip_header(unsigned char *buf, unsigned char flags)
+{
+    memcpy(buf, PIXEL_CLIP_MAGIC, 4);
+    buf[4] = PIXEL_CLIP_VERSION;
+    buf[5] = flags;
+    buf[6] = TEST_CLIP_PIXEL_NUM;
+    buf[7] = 0;
+    memset(&buf[8], 0, 4);
+
+    return PIXEL_CLIP_HEADER_LEN;
+}
+
+/**
+ * @brief 写入帧记录头，返回长度
+ */
+static unsigned int __clip_frame(unsigned char *buf, unsigned char type, unsigned short duration_ms)
+{
+    buf[0] = type;
+    buf[1] = (unsigned char)(duration_ms & 0xFF);
+    buf[2] = (unsigned char)(duration_ms >> 8);
+
+    return PIXEL_CLIP_FRAME_HEAD_LEN;
+}
+
+/**
+ * @brief 写入关键帧，像素为rgb，返回长度
+ */
+static unsigned int __clip_key(unsigned char *buf, const unsigned char *rgb)
+{
+    unsigned int len = __clip_frame(buf, PIXEL_CLIP_FRAME_KEY, 10);
+
+    memcpy(&buf[len], rgb, TEST_CLIP_PIXEL_NUM * 3);
+
+    return len + TEST_CLIP_PIXEL_NUM * 3;
+}
+
+/**
+ * @brief 解码下一帧并检查返回值与像素，返回片段的像素缓存（失败时为NULL）
+ */
+static const unsigned char *__clip_expect(PIXEL_CLIP_HANDLE_T clip, OPERATE_RET expect_ret,
+                                          const unsigned char *expect)
+{
+    PIXEL_FRAME_T frame;
+    unsigned int duration_ms = 0;
+
+    memset(&frame, 0, sizeof(frame));
+    TEST_CHECK(expect_ret == tdl_pixel_clip_next(clip, &frame, &duration_ms));
+    if (OPRT_OK == expect_ret) {
+        TEST_CHECK(TEST_CLIP_PIXEL_NUM == frame.pixel_num);
+        TEST_CHECK(0 == memcmp(frame.data, expect, TEST_CLIP_PIXEL_NUM * 3));
+    }
+
+    return (const unsigned char *)frame.data;
+}
+
+/**
+ * @brief 关键帧与增量帧（复制与填充片段）解码、结束、rewind与循环播放
+ */
+static void __test_clip_play(void)
+{
+    PIXEL_CLIP_HANDLE_T clip = NULL;
+    PIXEL_CLIP_MEM_T mem;
+    unsigned char buf[TEST_CLIP_MAX], key[TEST_CLIP_PIXEL_NUM * 3], delta[TEST_CLIP_PIXEL_NUM * 3];
+    unsigned int len = 0, i = 0;
+
+    for (i = 0; i < sizeof(key); i++) {
+        key[i] = (unsigned char)(0x10 + i);
+    }
+    /* 像素1改为复制的颜色，像素2、3填充为同一颜色 */
+    memcpy(delta, key, sizeof(delta));
+    delta[3] = 0xA1;
+    delta[4] = 0xA2;
+    delta[5] = 0xA3;
+    for (i = 2; i < TEST_CLIP_PIXEL_NUM; i++) {
+        delta[i * 3] = 0x55;
+        delta[i * 3 + 1] = 0x66;
+        delta[i * 3 + 2] = 0x77;
+    }
+
+    len = __clip_header(buf, 0);
+    len += __clip_key(&buf[len], key);
+    len += __clip_frame(&buf[len], PIXEL_CLIP_FRAME_DELTA, 20);
+    buf[len++] = 2;
+    buf[len++] = 1;
+    buf[len++] = 0;
+    buf[len++] = 1;
+    memcpy(&buf[len], &delta[3], 3);
+    len += 3;
+    buf[len++] = 2;
+    buf[len++] = 0;
+    buf[len++] = PIXEL_CLIP_RUN_FILL | 2;
+    memcpy(&buf[len], &delta[6], 3);
+    len += 3;
+    len += __clip_frame(&buf[len], PIXEL_CLIP_FRAME_END, 0);
+    mem.data = buf;
+    mem.len = len;
+
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_open(&clip, tdl_pixel_clip_mem_read, &mem));
+    __clip_expect(clip, OPRT_OK, key);
+    __clip_expect(clip, OPRT_OK, delta);
+    __clip_expect(clip, OPRT_NOT_FOUND, NULL);
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_rewind(clip));
+    __clip_expect(clip, OPRT_OK, key);
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_close(clip));
+
+    /* 循环片段结束后回到第一帧 */
+    buf[5] = PIXEL_CLIP_FLAG_LOOP;
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_open(&clip, tdl_pixel_clip_mem_read, &mem));
+    __clip_expect(clip, OPRT_OK, key);
+    __clip_expect(clip, OPRT_OK, delta);
+    __clip_expect(clip, OPRT_OK, key);
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_close(clip));
+
+    /* 没有帧的循环片段结束而不是死循环 */
+    len = __clip_header(buf, PIXEL_CLIP_FLAG_LOOP);
+    mem.len = len;
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_open(&clip, tdl_pixel_clip_mem_read, &mem));
+    __clip_expect(clip, OPRT_NOT_FOUND, NULL);
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_close(clip));
+    len += __clip_frame(&buf[len], PIXEL_CLIP_FRAME_END, 0);
+    mem.len = len;
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_open(&clip, tdl_pixel_clip_mem_read, &mem));
+    __clip_expect(clip, OPRT_NOT_FOUND, NULL);
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_close(clip));
+}
+
+/**
+ * @brief 截断与越界的帧记录返回错误；增量帧出错时当前帧保持不变
+ */
+static void __test_clip_error(void)
+{
+    PIXEL_CLIP_HANDLE_T clip = NULL;
+    PIXEL_CLIP_MEM_T mem;
+    unsigned char buf[TEST_CLIP_MAX], key[TEST_CLIP_PIXEL_NUM * 3];
+    const unsigned char *data = NULL;
+    unsigned int len = 0, key_len = 0, i = 0;
+
+    for (i = 0; i < sizeof(key); i++) {
+        key[i] = (unsigned char)(0x80 + i);
+    }
+    mem.data = buf;
+
+    /* 截断的关键帧 */
+    key_len = __clip_header(buf, 0);
+    key_len += __clip_key(&buf[key_len], key);
+    mem.len = key_len - 1;
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_open(&clip, tdl_pixel_clip_mem_read, &mem));
+    __clip_expect(clip, OPRT_COM_ERROR, NULL);
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_close(clip));
+
+    /* 第一个片段合法，第二个片段的头或数据被截断 */
+    len = key_len;
+    len += __clip_frame(&buf[len], PIXEL_CLIP_FRAME_DELTA, 20);
+    buf[len++] = 2;
+    buf[len++] = 0;
+    buf[len++] = 0;
+    buf[len++] = 1;
+    memset(&buf[len], 0xEE, 3);
+    len += 3;
+    buf[len++] = 1;
+    buf[len++] = 0;
+    buf[len++] = 2;
+    memset(&buf[len], 0xDD, 6);
+    len += 6;
+    for (i = 1; i <= 9; i++) {
+        mem.len = len - i;
+        TEST_CHECK(OPRT_OK == tdl_pixel_clip_open(&clip, tdl_pixel_clip_mem_read, &mem));
+        data = __clip_expect(clip, OPRT_OK, key);
+        __clip_expect(clip, OPRT_COM_ERROR, NULL);
+        /* 第一个片段已经读到，但不完整的增量帧不能修改当前帧 */
+        TEST_CHECK(data && 0 == memcmp(data, key, sizeof(key)));
+        TEST_CHECK(OPRT_OK == tdl_pixel_clip_close(clip));
+    }
+
+    /* 第二个片段越界 */
+    buf[len - 9] = TEST_CLIP_PIXEL_NUM - 1;
+    mem.len = len;
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_open(&clip, tdl_pixel_clip_mem_read, &mem));
+    data = __clip_expect(clip, OPRT_OK, key);
+    __clip_expect(clip, OPRT_COM_ERROR, NULL);
+    TEST_CHECK(data && 0 == memcmp(data, key, sizeof(key)));
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_close(clip));
+
+    /* 截断的增量帧头：片段数缺失 */
+    mem.len = key_len + PIXEL_CLIP_FRAME_HEAD_LEN;
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_open(&clip, tdl_pixel_clip_mem_read, &mem));
+    __clip_expect(clip, OPRT_OK, key);
+    __clip_expect(clip, OPRT_COM_ERROR, NULL);
+    TEST_CHECK(OPRT_OK == tdl_pixel_clip_close(clip));
+}
+
+static void __test_clip(void)
+{
+    __test_clip_play();
+    __test_clip_error();
+}
+
+/**
+ * @brief 控制器默认配置下线上每颗灯珠都为同一颜色
+ */
+static void __ctrl_expect(unsigned char r, unsigned char g, unsigned char b)
+{
+    unsigned char rgb[TEST_PIXEL_NUM * 3], expect[TEST_PIXEL_NUM * 3];
+    unsigned int i = 0;
+
+    for (i = 0; i < TEST_PIXEL_NUM; i++) {
+        rgb[i * 3] = r;
+        rgb[i * 3 + 1] = g;
+        rgb[i * 3 + 2] = b;
+    }
+    __frame_to_wire(rgb, LED_PIXEL_LINE_SEQ, expect);
+    wire_len = (unsigned int)tdd_pixel_sim_spi_last_frame(TEST_PORT, wire_buf, sizeof(wire_buf));
+    __wire_expect(LED_SPI_CODE_MODE, LED_PIXEL_CHIP, expect, sizeof(expect));
+}
+
+/**
+ * @brief 上电自检红->绿->蓝->空闲，再进入网络异常，节拍全部按时
+ */
+static void __test_controller(void)
+{
+    LedRenderStats stats;
+
+    led_controller_init();
+    tdd_pixel_sim_advance(0);
+    __ctrl_expect(255, 0, 0);
+    tdd_pixel_sim_advance(INIT_RED_TIME);
+    __ctrl_expect(0, 255, 0);
+    tdd_pixel_sim_advance(INIT_GREEN_TIME);
+    __ctrl_expect(0, 0, 255);
+    tdd_pixel_sim_advance(INIT_BLUE_TIME);
+    __ctrl_expect(0, 0, 0);
+
+    /* 本周期已出过帧，命令在下一个节拍执行，随后指示层淡入 */
+    set_led_state(LED_NET_ERROR, 0);
+    tdd_pixel_sim_advance(LED_RENDER_PERIOD_MS + LED_LAYER_FADE_MS);
+    __ctrl_expect(255, 0, 0);
+
+    led_controller_get_render_stats(&stats);
+    TEST_CHECK(0 == stats.missed_deadlines);
+    TEST_CHECK(0 == stats.max_lateness_ms);
+    /* 网络异常命令在下一个节拍随首帧发出，发送完成回调在同一虚拟时刻 */
+    TEST_CHECK(LED_RENDER_PERIOD_MS == stats.cmd_queued_last_ms);
+    TEST_CHECK(LED_RENDER_PERIOD_MS == stats.cmd_latency_last_ms);
+    TEST_CHECK((INIT_RED_TIME + INIT_GREEN_TIME + INIT_BLUE_TIME + LED_RENDER_PERIOD_MS + LED_LAYER_FADE_MS) /
+               LED_RENDER_PERIOD_MS + 1 == stats.ticks);
+    led_controller_deinit();
+}
+
+int main(int argc, char *argv[])
+{
+    tdd_pixel_sim_set_log_level(TAL_LOG_LEVEL_ERR);
+    tdd_pixel_sim_spi_set_hook(__wire_hook, NULL);
+
+    if (argc > 1 && 0 == strcmp(argv[1], "wire")) {
+        __test_wire();
+    } else if (argc > 1 && 0 == strcmp(argv[1], "clip")) {
+        __test_clip();
+    } else if (argc > 1 && 0 == strcmp(argv[1], "controller")) {
+        __test_controller();
+    } else {
+        printf("usage: %s wire|clip|controller\n", argv[0]);
+        return 2;
+    }
+
+    if (test_fail_cnt) {
+        printf("%u checks failed\n", test_fail_cnt);
+        return 1;
+    }
+    printf("ok\n");
+
+    return 0;
+}
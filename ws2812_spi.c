@@ -1,3 +1,4 @@
+#include <string.h>
 #include "ws2812_spi.h"
 #include "tuya_iot_config.h"
 #include "tuya_cloud_types.h"
@@ -5,9 +6,12 @@
 #include "tal_thread.h"
 #include "tal_system.h"
 #include "tkl_spi.h"
+#include "tdd_pixel_basic.h"
 
 static UCHAR_T *s_buffer = NULL;
+static UINT_T s_reset_len = 0;  // 码流末尾的复位零字节数
 static TUYA_SPI_NUM_E s_spi_port;
+static DRV_PIXEL_SPI_TABLE_T s_spi_table;
 
 /**
  * @brief 初始化驱动并分配缓冲区
@@ -17,10 +21,13 @@ OPERATE_RET ws2812_spi_init(TUYA_SPI_NUM_E port) {
 
     size_t buf_len = (size_t)WS2812_LED_COUNT * 24;  // 每灯 24 字节编码
 
-    s_buffer = malloc(buf_len);
+    s_reset_len = tdd_pixel_reset_bytes(WS2812_SPI_FREQ, WS2812_RESET_US);
+    s_buffer = malloc(buf_len + s_reset_len);
     if (!s_buffer) {
         return OPRT_MALLOC_FAILED;
     }
+    memset(s_buffer + buf_len, 0, s_reset_len);
+    tdd_pixel_spi_table_init(WS2812_0, WS2812_1, ONE_BYTE_LEN, &s_spi_table);
 
     TUYA_SPI_BASE_CFG_T cfg = {
         .mode      = TUYA_SPI_MODE0,
@@ -48,11 +55,10 @@ OPERATE_RET ws2812_spi_set_pixel(UINT16_T index, UCHAR_T red, UCHAR_T green, UCH
         return OPRT_INVALID_PARM;
     }
 
-    uint32_t color = ((uint32_t)green << 16) | ((uint32_t)red << 8) | blue;
-    size_t base = (size_t)index * 24;
-    for (int bit = 0; bit < 24; bit++) {
-         s_buffer[base + bit] = ( ( color << bit ) & 0x800000 ) ? WS2812_1 : WS2812_0; 
-    }
+    UCHAR_T *dst = &s_buffer[(size_t)index * 24];
+    tdd_rgb_transform_spi_data_lut(&s_spi_table, green, dst);
+    tdd_rgb_transform_spi_data_lut(&s_spi_table, red,   dst + ONE_BYTE_LEN);
+    tdd_rgb_transform_spi_data_lut(&s_spi_table, blue,  dst + 2 * ONE_BYTE_LEN);
     return OPRT_OK;
 }
 
@@ -64,10 +70,9 @@ OPERATE_RET ws2812_spi_refresh(VOID_T) {
         return OPRT_RESOURCE_NOT_READY;
     }
 
-    size_t len = (size_t)WS2812_LED_COUNT * 24;
+    /* 末尾的零字节保持低电平触发复位，连续刷新无需等待 */
+    size_t len = (size_t)WS2812_LED_COUNT * 24 + s_reset_len;
     tkl_spi_send(s_spi_port, s_buffer, len);
-    /* 拉低 >50μs 触发复位 */
-    delay_ms(WS2812_RESET_DELAY_MS);
     return OPRT_OK;
 }
 
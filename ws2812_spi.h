@@ -13,7 +13,7 @@
 
 // SPI 配置参数
 #define WS2812_SPI_FREQ        4500000//5//6    // 8 MHz
-#define WS2812_RESET_DELAY_MS  1          // > 50 μs
+#define WS2812_RESET_US        280        // 复位低电平时间，WS2812B > 280 μs，作为码流末尾的零字节发送
 
 /**
  * @brief 初始化 WS2812 SPI 驱动并分配缓冲区